@@ -302,6 +302,48 @@ fdb_error_t fdb_future_get_keyvalue_array_v13(FDBFuture* f, FDBKeyValue const**
 	                 *out_count = rrr.size(););
 }
 
+// Writes the pairs of rrr to buffer as length-prefixed keys and values, if buffer_length is large enough, and returns
+// the number of bytes they need
+static int packKeyValues(RangeResultRef const& rrr, uint8_t* buffer, int buffer_length) {
+	int64_t length = 0;
+	for (auto const& kv : rrr) {
+		length += 2 * sizeof(uint32_t) + kv.key.size() + kv.value.size();
+	}
+	if (length > std::numeric_limits<int>::max()) {
+		throw value_too_large();
+	}
+	if (buffer == nullptr || length > buffer_length) {
+		return length;
+	}
+	uint8_t* out = buffer;
+	for (auto const& kv : rrr) {
+		for (StringRef bytes : { kv.key, kv.value }) {
+			// Lengths are little-endian whatever the byte order of this platform
+			uint32_t size = bytes.size();
+			for (size_t i = 0; i < sizeof(size); i++) {
+				*out++ = (uint8_t)(size >> (8 * i));
+			}
+			if (size) {
+				memcpy(out, bytes.begin(), size);
+				out += size;
+			}
+		}
+	}
+	return length;
+}
+
+extern "C" DLLEXPORT fdb_error_t fdb_future_get_keyvalue_buffer(FDBFuture* f,
+                                                                uint8_t* buffer,
+                                                                int buffer_length,
+                                                                int* out_length,
+                                                                int* out_count,
+                                                                fdb_bool_t* out_more) {
+	CATCH_AND_RETURN(Standalone<RangeResultRef> rrr = TSAV(Standalone<RangeResultRef>, f)->get();
+	                 *out_length = packKeyValues(rrr, buffer, buffer_length);
+	                 *out_count = rrr.size();
+	                 *out_more = rrr.more;);
+}
+
 extern "C" DLLEXPORT fdb_error_t fdb_future_get_mappedkeyvalue_array(FDBFuture* f,
                                                                      FDBMappedKeyValue const** out_kvm,
                                                                      int* out_count,
@@ -326,6 +326,17 @@ DLLEXPORT WARN_UNUSED_RESULT fdb_error_t fdb_future_get_mappedkeyvalue_array(FDB
                                                                              int* out_count,
                                                                              fdb_bool_t* out_more);
 
+/* Copies the key-value pairs of a range read into a caller-provided buffer, one after another, as: the key length (4
+   byte little-endian integer), the key, the value length (4 byte little-endian integer), the value. *out_length is
+   always set to the number of bytes needed, but nothing is written unless buffer_length is at least that large, so a
+   buffer can be sized by a first call with a NULL buffer and then reused across range reads. */
+DLLEXPORT WARN_UNUSED_RESULT fdb_error_t fdb_future_get_keyvalue_buffer(FDBFuture* f,
+                                                                        uint8_t* buffer,
+                                                                        int buffer_length,
+                                                                        int* out_length,
+                                                                        int* out_count,
+                                                                        fdb_bool_t* out_more);
+
 DLLEXPORT WARN_UNUSED_RESULT fdb_error_t fdb_future_get_key_array(FDBFuture* f,
                                                                   FDBKey const** out_key_array,
                                                                   int* out_count);
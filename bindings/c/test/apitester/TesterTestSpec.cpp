@@ -57,6 +57,10 @@ std::unordered_map<std::string, std::function<void(const std::string& value, Tes
 	  [](const std::string& value, TestSpec* spec) { //
 	      spec->multiThreaded = (value == "true");
 	  } },
+	{ "shardDatabases",
+	  [](const std::string& value, TestSpec* spec) { //
+	      spec->shardDatabases = (value == "true");
+	  } },
 	{ "fdbCallbacksOnExternalThreads",
 	  [](const std::string& value, TestSpec* spec) { //
 	      spec->fdbCallbacksOnExternalThreads = (value == "true");
@@ -292,6 +292,9 @@ void applyNetworkOptions(TesterOptions& options) {
 
 	if (options.testSpec.multiThreaded) {
 		fdb::network::setOption(FDBNetworkOption::FDB_NET_OPTION_CLIENT_THREADS_PER_VERSION, options.numFdbThreads);
+		if (options.testSpec.shardDatabases) {
+			fdb::network::setOption(FDBNetworkOption::FDB_NET_OPTION_SHARD_DATABASE_ACROSS_CLIENT_THREADS);
+		}
 	}
 
 	if (options.testSpec.fdbCallbacksOnExternalThreads) {
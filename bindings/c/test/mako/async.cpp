@@ -167,7 +167,7 @@ void ResumableStateForRunWorkload::updateStepStats() {
 		// reset transaction boundary
 		const auto step_latency = watch_step.diff();
 		if (do_sample) {
-			stats.addLatency(OP_COMMIT, step_latency);
+			stats.addLatency(OP_COMMIT, step_latency, args.latency_slo_us[OP_COMMIT]);
 		}
 		tx.reset();
 		setTransactionTimeoutIfEnabled(args, tx);
@@ -181,7 +181,7 @@ void ResumableStateForRunWorkload::updateStepStats() {
 		watch_op.setStop(watch_step.getStop());
 		if (do_sample) {
 			const auto op_latency = watch_op.diff();
-			stats.addLatency(iter.op, op_latency);
+			stats.addLatency(iter.op, op_latency, args.latency_slo_us[iter.op]);
 		}
 		stats.incrOpCount(iter.op);
 	}
@@ -210,8 +210,8 @@ void ResumableStateForRunWorkload::onTransactionSuccess() {
 				if (stats.getOpCount(OP_TRANSACTION) % args.sampling == 0) {
 					const auto commit_latency = watch_commit.diff();
 					const auto tx_duration = watch_tx.diff();
-					stats.addLatency(OP_COMMIT, commit_latency);
-					stats.addLatency(OP_TRANSACTION, tx_duration);
+					stats.addLatency(OP_COMMIT, commit_latency, args.latency_slo_us[OP_COMMIT]);
+					stats.addLatency(OP_TRANSACTION, tx_duration, args.latency_slo_us[OP_TRANSACTION]);
 				}
 				stats.incrOpCount(OP_COMMIT);
 				stats.incrOpCount(OP_TRANSACTION);
@@ -226,7 +226,7 @@ void ResumableStateForRunWorkload::onTransactionSuccess() {
 		watch_tx.stop();
 		if (stats.getOpCount(OP_TRANSACTION) % args.sampling == 0) {
 			const auto tx_duration = watch_tx.diff();
-			stats.addLatency(OP_TRANSACTION, tx_duration);
+			stats.addLatency(OP_TRANSACTION, tx_duration, args.latency_slo_us[OP_TRANSACTION]);
 		}
 		stats.incrOpCount(OP_TRANSACTION);
 		watch_tx.startFromStop();
@@ -31,6 +31,7 @@
 #include <new>
 #include <numeric>
 #include <optional>
+#include <random>
 #if defined(__linux__)
 #include <pthread.h>
 #endif
@@ -304,16 +305,18 @@ void updateErrorStatsRunMode(WorkflowStatistics& stats, fdb::Error err, int op)
 	}
 }
 
-/* run one iteration of configured transaction */
+/* run one iteration of configured transaction.
+ * transaction latency is measured from tx_start, which is the intended start time with --poisson_arrivals */
 int runOneTransaction(Transaction& tx,
                       std::optional<std::string> const& token,
                       Arguments const& args,
                       WorkflowStatistics& stats,
                       ByteString& key1,
                       ByteString& key2,
-                      ByteString& val) {
+                      ByteString& val,
+                      timepoint_t tx_start) {
 	const auto do_sample = (stats.getOpCount(OP_TRANSACTION) % args.sampling) == 0;
-	auto watch_tx = Stopwatch(StartAtCtor{});
+	auto watch_tx = Stopwatch(tx_start);
 	auto watch_op = Stopwatch{};
 
 	auto op_iter = getOpBegin(args);
@@ -354,7 +357,7 @@ transaction_begin:
 			// reset transaction boundary
 			if (do_sample) {
 				const auto step_latency = watch_step.diff();
-				stats.addLatency(OP_COMMIT, step_latency);
+				stats.addLatency(OP_COMMIT, step_latency, args.latency_slo_us[OP_COMMIT]);
 			}
 			tx.reset();
 			if (token)
@@ -370,7 +373,7 @@ transaction_begin:
 			watch_op.setStop(watch_step.getStop());
 			if (do_sample) {
 				const auto op_latency = watch_op.diff();
-				stats.addLatency(op, op_latency);
+				stats.addLatency(op, op_latency, args.latency_slo_us[op]);
 			}
 			stats.incrOpCount(op);
 		}
@@ -392,7 +395,7 @@ transaction_begin:
 		if (rc == FutureRC::OK) {
 			if (do_sample) {
 				const auto commit_latency = watch_commit.diff();
-				stats.addLatency(OP_COMMIT, commit_latency);
+				stats.addLatency(OP_COMMIT, commit_latency, args.latency_slo_us[OP_COMMIT]);
 			}
 			stats.incrOpCount(OP_COMMIT);
 		} else {
@@ -407,12 +410,32 @@ transaction_begin:
 	// one transaction has completed successfully
 	if (do_sample) {
 		const auto tx_duration = watch_tx.stop().diff();
-		stats.addLatency(OP_TRANSACTION, tx_duration);
+		stats.addLatency(OP_TRANSACTION, tx_duration, args.latency_slo_us[OP_TRANSACTION]);
 	}
 	stats.incrOpCount(OP_TRANSACTION);
 	return 0;
 }
 
+/* time until the next arrival of a Poisson process with the given rate (per second) */
+timediff_t nextArrivalGap(std::mt19937_64& rng, double rate) {
+	auto gap = std::exponential_distribution<double>(rate)(rng);
+	return std::chrono::duration_cast<timediff_t>(std::chrono::duration<double>(gap));
+}
+
+/* transaction spec of the --phase script step at the given time into the run */
+WorkloadSpec const& currentPhaseSpec(Arguments const& args, double elapsed_seconds) {
+	auto script_seconds = 0;
+	for (const auto& phase : args.phases)
+		script_seconds += phase.seconds;
+	auto t = std::fmod(elapsed_seconds, static_cast<double>(script_seconds));
+	for (const auto& phase : args.phases) {
+		if (t < phase.seconds)
+			return phase.txnspec;
+		t -= phase.seconds;
+	}
+	return args.phases.back().txnspec;
+}
+
 int runWorkload(Database db,
                 Arguments const& args,
                 int const thread_tps,
@@ -438,6 +461,13 @@ int runWorkload(Database db,
 
 	auto time_prev = steady_clock::now();
 	auto time_last_trace = time_prev;
+	const auto time_start = time_prev;
+
+	/* with a phase script, transactions run with the spec of the current phase */
+	auto phase_args = std::optional<Arguments>{};
+	if (!args.phases.empty())
+		phase_args = args;
+	const auto& run_args = phase_args ? *phase_args : args;
 
 	auto rc = 0;
 	auto xacts = 0;
@@ -453,9 +483,27 @@ int runWorkload(Database db,
 
 	std::optional<std::vector<fdb::Tenant>> tenants = args.prepareTenants(db);
 
+	/* Poisson arrival schedule. Each thread still runs one transaction at a time, so a slow transaction delays the
+	 * arrivals after it; they then start back to back until the thread catches up with the schedule. */
+	auto rng = std::mt19937_64(std::random_device{}());
+	auto next_arrival = steady_clock::now();
+
 	/* main transaction loop */
 	while (1) {
-		if ((thread_tps > 0 /* iff throttling on */) && (xacts >= current_tps)) {
+		if (args.poisson_arrivals) {
+			/* arrivals follow the target rate, which --tpsmin and --tpschange vary through throttle_factor.
+			 * a transaction that starts late is charged for the wait. */
+			const auto rate = thread_tps * throttle_factor.load();
+			if (rate > 0) {
+				next_arrival += nextArrivalGap(rng, rate);
+				std::this_thread::sleep_until(next_arrival);
+			} else {
+				usleep(1000);
+				next_arrival = steady_clock::now();
+			}
+			/* a rate below one per second still runs its arrivals */
+			current_tps = rate > 0 ? std::max(1, static_cast<int>(rate)) : 0;
+		} else if ((thread_tps > 0 /* iff throttling on */) && (xacts >= current_tps)) {
 			/* throttle on */
 			auto time_now = steady_clock::now();
 			while (toDoubleSeconds(time_now - time_prev) < 1.0) {
@@ -509,7 +557,11 @@ int runWorkload(Database db,
 				}
 			}
 
-			rc = runOneTransaction(tx, token, args, workflow_stats, key1, key2, val);
+			if (phase_args)
+				phase_args->txnspec = currentPhaseSpec(args, toDoubleSeconds(steady_clock::now() - time_start));
+
+			const auto tx_start = args.poisson_arrivals ? next_arrival : steady_clock::now();
+			rc = runOneTransaction(tx, token, run_args, workflow_stats, key1, key2, val, tx_start);
 			if (rc) {
 				logr.warn("runOneTransaction failed ({})", rc);
 			}
@@ -877,6 +929,7 @@ Arguments::Arguments() {
 	client_threads_per_version = 0;
 	disable_client_bypass = false;
 	disable_ryw = 0;
+	range_delivery = RANGE_DELIVERY_ARRAY;
 	json_output_path[0] = '\0';
 	stats_export_path[0] = '\0';
 	bg_materialize_files = false;
@@ -885,6 +938,8 @@ Arguments::Arguments() {
 	transaction_timeout_db = 0;
 	transaction_timeout_tx = 0;
 	num_report_files = 0;
+	poisson_arrivals = false;
+	memset(latency_slo_us, 0, sizeof(latency_slo_us));
 }
 
 int Arguments::setGlobalOptions() const {
@@ -1130,6 +1185,43 @@ int parseTransaction(Arguments& args, char const* optarg) {
 	return 0;
 }
 
+/* parse one step of a phase script: SECONDS,SPEC */
+int parsePhase(Arguments& args, char const* optarg) {
+	char* spec = nullptr;
+	const auto seconds = strtol(optarg, &spec, 10);
+	if (spec == optarg || *spec != ',' || seconds <= 0) {
+		logr.error("invalid phase {}, expected SECONDS,SPEC", optarg);
+		return -1;
+	}
+	const auto txnspec = args.txnspec;
+	const auto rc = parseTransaction(args, spec + 1);
+	if (rc == 0)
+		args.phases.push_back(WorkloadPhase{ static_cast<int>(seconds), args.txnspec });
+	args.txnspec = txnspec;
+	return rc;
+}
+
+/* parse per-operation latency SLOs: OP:MICROSECONDS[,OP:MICROSECONDS...] */
+int parseLatencySlo(Arguments& args, char const* optarg) {
+	auto slos = std::string_view(optarg);
+	while (!slos.empty()) {
+		const auto slo = slos.substr(0, slos.find(','));
+		slos.remove_prefix(std::min(slos.size(), slo.size() + 1));
+		const auto colon = slo.find(':');
+		auto op = 0;
+		while (op < MAX_OP && slo.substr(0, colon) != getOpName(op))
+			op++;
+		const auto slo_us =
+		    colon == std::string_view::npos ? 0 : strtoull(std::string(slo.substr(colon + 1)).c_str(), nullptr, 10);
+		if (op == MAX_OP || slo_us == 0) {
+			logr.error("invalid latency SLO {}, expected OP:MICROSECONDS", slo);
+			return -1;
+		}
+		args.latency_slo_us[op] = slo_us;
+	}
+	return 0;
+}
+
 void usage() {
 	printf("Usage:\n");
 	printf("%-24s %s\n", "-h, --help", "Print this message");
@@ -1176,6 +1268,7 @@ void usage() {
 	printf("%-24s %s\n", "    --flatbuffers", "Use flatbuffers");
 	printf("%-24s %s\n", "    --streaming", "Streaming mode: all (default), iterator, small, medium, large, serial");
 	printf("%-24s %s\n", "    --disable_ryw", "Disable snapshot read-your-writes");
+	printf("%-24s %s\n", "    --range_delivery", "Range result delivery: array (default), copy, buffer");
 	printf(
 	    "%-24s %s\n", "    --disable_client_bypass", "Disable client-bypass forcing mako to use multi-version client");
 	printf("%-24s %s\n", "    --json_report=PATH", "Output stats to the specified json file (Default: mako.json)");
@@ -1205,6 +1298,16 @@ void usage() {
 	printf("%-24s %s\n",
 	       "    --transaction_timeout_tx=DURATION",
 	       "Duration in milliseconds after which a transaction times out in run mode. Set as transaction option");
+	printf("%-24s %s\n",
+	       "    --poisson_arrivals",
+	       "Start transactions at Poisson arrival times at the --tps rate and measure latency from them. "
+	       "Each thread still waits for its transaction to complete before starting the next one");
+	printf("%-24s %s\n",
+	       "    --latency_slo=OP:US,...",
+	       "Count latency samples above US microseconds per operation (e.g. GET:2000,TRANSACTION:10000)");
+	printf("%-24s %s\n",
+	       "    --phase=SECONDS,SPEC",
+	       "Run transaction SPEC for SECONDS. Repeat to build a phase script, which loops until the run ends");
 }
 
 /* parse benchmark parameters */
@@ -1259,6 +1362,9 @@ int parseArguments(int argc, char* argv[], Arguments& args) {
 			{ "authorization_private_key_pem_file", required_argument, NULL, ARG_AUTHORIZATION_PRIVATE_KEY_PEM_FILE },
 			{ "transaction_timeout_tx", required_argument, NULL, ARG_TRANSACTION_TIMEOUT_TX },
 			{ "transaction_timeout_db", required_argument, NULL, ARG_TRANSACTION_TIMEOUT_DB },
+			{ "poisson_arrivals", no_argument, NULL, ARG_POISSON_ARRIVALS },
+			{ "latency_slo", required_argument, NULL, ARG_LATENCY_SLO },
+			{ "phase", required_argument, NULL, ARG_PHASE },
 			/* options which may or may not have an argument */
 			{ "json_report", optional_argument, NULL, ARG_JSON_REPORT },
 			{ "stats_export_path", optional_argument, NULL, ARG_EXPORT_PATH },
@@ -1272,6 +1378,7 @@ int parseArguments(int argc, char* argv[], Arguments& args) {
 			{ "version", no_argument, NULL, ARG_VERSION },
 			{ "disable_client_bypass", no_argument, NULL, ARG_DISABLE_CLIENT_BYPASS },
 			{ "disable_ryw", no_argument, NULL, ARG_DISABLE_RYW },
+			{ "range_delivery", required_argument, NULL, ARG_RANGE_DELIVERY },
 			{ "enable_token_based_authorization", no_argument, NULL, ARG_ENABLE_TOKEN_BASED_AUTHORIZATION },
 			{ NULL, 0, NULL, 0 }
 		};
@@ -1486,6 +1593,18 @@ int parseArguments(int argc, char* argv[], Arguments& args) {
 		case ARG_DISABLE_RYW:
 			args.disable_ryw = 1;
 			break;
+		case ARG_RANGE_DELIVERY:
+			if (strcmp(optarg, "array") == 0) {
+				args.range_delivery = RANGE_DELIVERY_ARRAY;
+			} else if (strcmp(optarg, "copy") == 0) {
+				args.range_delivery = RANGE_DELIVERY_COPY;
+			} else if (strcmp(optarg, "buffer") == 0) {
+				args.range_delivery = RANGE_DELIVERY_BUFFER;
+			} else {
+				logr.error("Invalid range delivery {}", optarg);
+				return -1;
+			}
+			break;
 		case ARG_JSON_REPORT:
 			SET_OPT_ARG_IF_PRESENT();
 			if (!optarg) {
@@ -1547,6 +1666,30 @@ int parseArguments(int argc, char* argv[], Arguments& args) {
 		case ARG_ENABLE_TOKEN_BASED_AUTHORIZATION:
 			args.enable_token_based_authorization = true;
 			break;
+		case ARG_POISSON_ARRIVALS:
+			args.poisson_arrivals = true;
+			break;
+		case ARG_LATENCY_SLO:
+			rc = parseLatencySlo(args, optarg);
+			if (rc < 0)
+				return -1;
+			break;
+		case ARG_PHASE:
+			rc = parsePhase(args, optarg);
+			if (rc < 0)
+				return -1;
+			break;
+		}
+	}
+
+	/* a phase script replaces --transaction; report on every operation any phase runs */
+	if (!args.phases.empty()) {
+		args.txnspec = args.phases.front().txnspec;
+		for (const auto& phase : args.phases) {
+			for (auto op = 0; op < MAX_OP; op++) {
+				auto& count = args.txnspec.ops[op][OP_COUNT];
+				count = std::max(count, phase.txnspec.ops[op][OP_COUNT]);
+			}
 		}
 	}
 
@@ -1649,6 +1792,19 @@ int Arguments::validate() {
 			logr.error("--transaction_timeout_[tx|db] must be a non-negative integer");
 			return -1;
 		}
+		if (poisson_arrivals && (tpsmax == 0 || async_xacts > 0)) {
+			logr.error("--poisson_arrivals requires --tpsmax|--tps and is not supported in async mode");
+			return -1;
+		}
+		if (!phases.empty() && async_xacts > 0) {
+			logr.error("--phase is not supported in async mode");
+			return -1;
+		}
+	}
+
+	if (mode != MODE_RUN && (poisson_arrivals || !phases.empty())) {
+		logr.error("--poisson_arrivals and --phase are only supported in run mode");
+		return -1;
 	}
 
 	if (mode != MODE_RUN && (transaction_timeout_db != 0 || transaction_timeout_tx != 0)) {
@@ -2073,6 +2229,39 @@ void printWorkerStats(WorkflowStatistics& final_stats, Arguments args, FILE* fp,
 		}
 	}
 	fmt::print("\n");
+
+	/* Share of latency samples above the SLO */
+	auto has_slo = false;
+	for (auto op = 0; op < MAX_OP; op++) {
+		has_slo = has_slo || args.latency_slo_us[op] > 0 || final_stats.getSloViolationCount(op) > 0;
+	}
+	if (has_slo) {
+		if (fp) {
+			fmt::fprintf(fp, "}, \"sloViolationPct\": {");
+		}
+		putTitle("SLO miss %");
+		first_op = true;
+		for (auto op = 0; op < MAX_OP; op++) {
+			if (args.txnspec.ops[op][OP_COUNT] > 0 || isAbstractOp(op)) {
+				const auto sample_size = final_stats.getLatencySampleCount(op);
+				if (!sample_size || (args.latency_slo_us[op] == 0 && final_stats.getSloViolationCount(op) == 0)) {
+					putField("N/A");
+					continue;
+				}
+				const auto violation_pct = 100.0 * final_stats.getSloViolationCount(op) / sample_size;
+				putFieldFloat(violation_pct, 2);
+				if (fp) {
+					if (first_op) {
+						first_op = false;
+					} else {
+						fmt::fprintf(fp, ",");
+					}
+					fmt::fprintf(fp, "\"%s\": %.2f", getOpName(op), violation_pct);
+				}
+			}
+		}
+		fmt::print("\n");
+	}
 	if (fp) {
 		fmt::fprintf(fp, "}}");
 	}
@@ -2380,8 +2569,11 @@ int statsProcessMain(Arguments const& args,
 		fmt::fprintf(fp, "\"txntagging_prefix\": \"%s\",", args.txntagging_prefix);
 		fmt::fprintf(fp, "\"streaming_mode\": %d,", static_cast<int>(args.streaming_mode));
 		fmt::fprintf(fp, "\"disable_ryw\": %d,", args.disable_ryw);
+		fmt::fprintf(fp, "\"range_delivery\": %d,", args.range_delivery);
 		fmt::fprintf(fp, "\"transaction_timeout_db\": %d,", args.transaction_timeout_db);
 		fmt::fprintf(fp, "\"transaction_timeout_tx\": %d,", args.transaction_timeout_tx);
+		fmt::fprintf(fp, "\"poisson_arrivals\": %d,", args.poisson_arrivals);
+		fmt::fprintf(fp, "\"phases\": %zu,", args.phases.size());
 		fmt::fprintf(fp, "\"json_output_path\": \"%s\"", args.json_output_path);
 		fmt::fprintf(fp, "},\"samples\": [");
 	}
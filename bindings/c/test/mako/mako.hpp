@@ -77,6 +77,7 @@ enum ArgKind {
 	ARG_TXNTAGGINGPREFIX,
 	ARG_STREAMING_MODE,
 	ARG_DISABLE_RYW,
+	ARG_RANGE_DELIVERY,
 	ARG_CLIENT_THREADS_PER_VERSION,
 	ARG_DISABLE_CLIENT_BYPASS,
 	ARG_JSON_REPORT,
@@ -91,6 +92,9 @@ enum ArgKind {
 	ARG_ENABLE_TOKEN_BASED_AUTHORIZATION,
 	ARG_TRANSACTION_TIMEOUT_TX,
 	ARG_TRANSACTION_TIMEOUT_DB,
+	ARG_POISSON_ARRIVALS,
+	ARG_LATENCY_SLO,
+	ARG_PHASE,
 };
 
 constexpr const int OP_COUNT = 0;
@@ -120,6 +124,13 @@ enum OpKind {
 
 enum TPSChangeTypes { TPS_SIN, TPS_SQUARE, TPS_PULSE };
 
+/* how range read results are consumed */
+enum RangeDelivery {
+	RANGE_DELIVERY_ARRAY, /* fdb_future_get_keyvalue_array, without touching the pairs */
+	RANGE_DELIVERY_COPY, /* fdb_future_get_keyvalue_array, copying each key and value like most bindings */
+	RANGE_DELIVERY_BUFFER /* fdb_future_get_keyvalue_buffer into a reused buffer */
+};
+
 enum DistributedTracerClient { DISABLED, NETWORK_LOSSY, LOG_FILE };
 
 /* we set WorkloadSpec and Arguments only once in the master process,
@@ -131,6 +142,12 @@ struct WorkloadSpec {
 	int ops[MAX_OP][3];
 };
 
+/* one step of a --phase script: run txnspec for the given number of seconds */
+struct WorkloadPhase {
+	int seconds;
+	WorkloadSpec txnspec;
+};
+
 constexpr const int LOGGROUP_MAX = 256;
 constexpr const int KNOB_MAX = 256;
 constexpr const int TAGPREFIXLENGTH_MAX = 8;
@@ -196,6 +213,7 @@ struct Arguments {
 	int64_t client_threads_per_version;
 	bool disable_client_bypass;
 	int disable_ryw;
+	int range_delivery;
 	char json_output_path[PATH_MAX];
 	bool bg_materialize_files;
 	char bg_file_path[PATH_MAX];
@@ -213,6 +231,9 @@ struct Arguments {
 	std::vector<int64_t> tenant_ids; // maps tenant index to tenant id for signing tokens
 	int transaction_timeout_db;
 	int transaction_timeout_tx;
+	bool poisson_arrivals; /* start transactions at Poisson arrival times, and measure latency from them */
+	uint64_t latency_slo_us[MAX_OP]; /* 0 if no SLO is tracked for the operation */
+	std::vector<WorkloadPhase> phases; /* repeated until the run ends, if not empty */
 };
 
 // helper functions
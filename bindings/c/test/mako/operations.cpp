@@ -31,6 +31,38 @@ namespace mako {
 
 using namespace fdb;
 
+namespace {
+
+// Consumes the result of a range read the way args.range_delivery asks for
+void consumeRange(Future& f, Arguments const& args) {
+	if (args.range_delivery == RANGE_DELIVERY_BUFFER) {
+		thread_local std::vector<uint8_t> buffer;
+		auto length = 0;
+		auto count = 0;
+		auto more = native::fdb_bool_t{};
+		auto err = Error(native::fdb_future_get_keyvalue_buffer(
+		    f.nativeHandle(), buffer.data(), static_cast<int>(buffer.size()), &length, &count, &more));
+		if (!err && length > static_cast<int>(buffer.size())) {
+			buffer.resize(length);
+			err = Error(native::fdb_future_get_keyvalue_buffer(
+			    f.nativeHandle(), buffer.data(), static_cast<int>(buffer.size()), &length, &count, &more));
+		}
+		if (err)
+			throwError("ERROR: future_get_keyvalue_buffer(): ", err);
+		return;
+	}
+	auto [kvs, count, more] = f.get<future_var::KeyValueRefArray>();
+	if (args.range_delivery == RANGE_DELIVERY_COPY) {
+		thread_local std::vector<std::pair<ByteString, ByteString>> copies;
+		copies.clear();
+		for (auto i = 0; i < count; i++) {
+			copies.emplace_back(kvs[i].key(), kvs[i].value());
+		}
+	}
+}
+
+} // namespace
+
 const std::array<Operation, MAX_OP> opTable{
 	{ { "GRV",
 	    { { StepKind::READ,
@@ -70,9 +102,9 @@ const std::array<Operation, MAX_OP> opTable{
 	                          args.txnspec.ops[OP_GETRANGE][OP_REVERSE])
 	                .eraseType();
 	        },
-	        [](Future& f, Transaction&, Arguments const&, ByteString&, ByteString&, ByteString& val) {
+	        [](Future& f, Transaction&, Arguments const& args, ByteString&, ByteString&, ByteString& val) {
 	            if (f && !f.error()) {
-		            f.get<future_var::KeyValueRefArray>();
+		            consumeRange(f, args);
 	            }
 	        } } },
 	    1,
@@ -105,9 +137,9 @@ const std::array<Operation, MAX_OP> opTable{
 	                          args.txnspec.ops[OP_GETRANGE][OP_REVERSE])
 	                .eraseType();
 	        },
-	        [](Future& f, Transaction&, Arguments const&, ByteString&, ByteString&, ByteString& val) {
+	        [](Future& f, Transaction&, Arguments const& args, ByteString&, ByteString&, ByteString& val) {
 	            if (f && !f.error()) {
-		            f.get<future_var::KeyValueRefArray>();
+		            consumeRange(f, args);
 	            }
 	        } } },
 	    1,
@@ -98,6 +98,7 @@ class alignas(64) WorkflowStatistics {
 	std::array<uint64_t, MAX_OP> timeouts;
 	std::array<uint64_t, MAX_OP> latency_samples;
 	std::array<uint64_t, MAX_OP> latency_us_total;
+	std::array<uint64_t, MAX_OP> slo_violations;
 	std::vector<DDSketchMako> sketches;
 
 public:
@@ -107,6 +108,7 @@ public:
 		std::fill(timeouts.begin(), timeouts.end(), 0);
 		std::fill(latency_samples.begin(), latency_samples.end(), 0);
 		std::fill(latency_us_total.begin(), latency_us_total.end(), 0);
+		std::fill(slo_violations.begin(), slo_violations.end(), 0);
 		sketches.resize(MAX_OP);
 	}
 
@@ -129,6 +131,9 @@ public:
 
 	uint64_t getLatencyUsTotal(int op) const noexcept { return latency_us_total[op]; }
 
+	// number of latency samples that exceeded the operation's SLO
+	uint64_t getSloViolationCount(int op) const noexcept { return slo_violations[op]; }
+
 	uint64_t getLatencyUsMin(int op) const noexcept { return sketches[op].min(); }
 
 	uint64_t getLatencyUsMax(int op) const noexcept { return sketches[op].max(); }
@@ -149,6 +154,7 @@ public:
 			total_timeouts += other.timeouts[op];
 			latency_samples[op] += other.latency_samples[op];
 			latency_us_total[op] += other.latency_us_total[op];
+			slo_violations[op] += other.slo_violations[op];
 		}
 	}
 
@@ -174,6 +180,13 @@ public:
 		latency_us_total[op] += latency_us;
 	}
 
+	// same as above, also counting the sample against slo_us if it is set (non-zero)
+	void addLatency(int op, timediff_t diff, uint64_t slo_us) noexcept {
+		addLatency(op, diff);
+		if (slo_us > 0 && toIntegerMicroseconds(diff) > slo_us)
+			slo_violations[op]++;
+	}
+
 	void writeToFile(const std::string& filename, int op) const {
 		rapidjson::StringBuffer ss;
 		rapidjson::Writer<rapidjson::StringBuffer> writer(ss);
@@ -234,6 +247,13 @@ inline std::ofstream& operator<<(std::ofstream& os, WorkflowStatistics& stats) {
 	}
 	writer.EndArray();
 
+	writer.String("slo_violations");
+	writer.StartArray();
+	for (auto op = 0; op < MAX_OP; op++) {
+		writer.Uint64(stats.slo_violations[op]);
+	}
+	writer.EndArray();
+
 	for (auto op = 0; op < MAX_OP; op++) {
 		if (stats.sketches[op].getPopulationSize() > 0) {
 			std::string op_name = getOpName(op);
@@ -275,6 +295,11 @@ inline std::ifstream& operator>>(std::ifstream& is, WorkflowStatistics& stats) {
 	populateArray(stats.timeouts, jsonTimeouts);
 	populateArray(stats.latency_samples, jsonLatencySamples);
 	populateArray(stats.latency_us_total, jsonLatencyUsTotal);
+	// reports written before SLO tracking was added don't have this field
+	if (doc.HasMember("slo_violations")) {
+		auto jsonSloViolations = doc["slo_violations"].GetArray();
+		populateArray(stats.slo_violations, jsonSloViolations);
+	}
 	for (int op = 0; op < MAX_OP; op++) {
 		const std::string op_name = getOpName(op);
 		stats.sketches[op].deserialize(doc[op_name.c_str()]);
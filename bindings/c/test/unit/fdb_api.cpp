@@ -102,6 +102,14 @@ void Future::cancel() {
 	return fdb_future_get_keyvalue_array(future_, out_kv, out_count, out_more);
 }
 
+[[nodiscard]] fdb_error_t KeyValueArrayFuture::get_buffer(uint8_t* buffer,
+                                                          int buffer_length,
+                                                          int* out_length,
+                                                          int* out_count,
+                                                          fdb_bool_t* out_more) {
+	return fdb_future_get_keyvalue_buffer(future_, buffer, buffer_length, out_length, out_count, out_more);
+}
+
 // MappedKeyValueArrayFuture
 
 [[nodiscard]] fdb_error_t MappedKeyValueArrayFuture::get(const FDBMappedKeyValue** out_kv,
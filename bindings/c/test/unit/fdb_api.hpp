@@ -144,6 +144,9 @@ public:
 	// fdb_future_get_keyvalue_array.
 	fdb_error_t get(const FDBKeyValue** out_kv, int* out_count, fdb_bool_t* out_more);
 
+	// Wrapper around fdb_future_get_keyvalue_buffer.
+	fdb_error_t get_buffer(uint8_t* buffer, int buffer_length, int* out_length, int* out_count, fdb_bool_t* out_more);
+
 private:
 	friend class Transaction;
 	KeyValueArrayFuture(FDBFuture* f) : Future(f) {}
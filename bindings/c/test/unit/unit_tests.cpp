@@ -26,6 +26,8 @@
 #include <assert.h>
 #include <string.h>
 
+#include <algorithm>
+#include <atomic>
 #include <condition_variable>
 #include <iostream>
 #include <map>
@@ -592,6 +594,75 @@ TEST_CASE("fdb_future_get_keyvalue_array") {
 	}
 }
 
+TEST_CASE("fdb_future_get_keyvalue_buffer") {
+	std::map<std::string, std::string> data = create_data({ { "a", "1" }, { "b", "22" }, { "c", "" }, { "d", "4" } });
+	insert_data(db, data);
+
+	fdb::Transaction tr(db);
+	while (1) {
+		fdb::KeyValueArrayFuture f1 =
+		    tr.get_range(FDB_KEYSEL_FIRST_GREATER_OR_EQUAL((const uint8_t*)key("a").c_str(), key("a").size()),
+		                 FDB_KEYSEL_LAST_LESS_OR_EQUAL((const uint8_t*)key("c").c_str(), key("c").size()) + 1,
+		                 /* limit */ 0,
+		                 /* target_bytes */ 0,
+		                 /* FDBStreamingMode */ FDB_STREAMING_MODE_WANT_ALL,
+		                 /* iteration */ 0,
+		                 /* snapshot */ false,
+		                 /* reverse */ 0);
+
+		fdb_error_t err = wait_future(f1);
+		if (err) {
+			fdb::EmptyFuture f2 = tr.on_error(err);
+			fdb_check(wait_future(f2));
+			continue;
+		}
+
+		FDBKeyValue const* out_kv;
+		int out_count;
+		int out_more;
+		fdb_check(f1.get(&out_kv, &out_count, &out_more));
+		int expected_length = 0;
+		for (int i = 0; i < out_count; ++i) {
+			expected_length += 8 + out_kv[i].key_length + out_kv[i].value_length;
+		}
+
+		// Sizing call
+		int out_length = -1;
+		int buffer_count;
+		int buffer_more;
+		fdb_check(f1.get_buffer(nullptr, 0, &out_length, &buffer_count, &buffer_more));
+		CHECK(out_length == expected_length);
+		CHECK(buffer_count == out_count);
+		CHECK(buffer_more == out_more);
+
+		// A buffer one byte too small is left untouched
+		std::vector<uint8_t> buffer(out_length, 0xab);
+		fdb_check(f1.get_buffer(buffer.data(), out_length - 1, &out_length, &buffer_count, &buffer_more));
+		CHECK(out_length == expected_length);
+		CHECK(std::all_of(buffer.begin(), buffer.end(), [](uint8_t b) { return b == 0xab; }));
+
+		// A buffer of exactly the needed size is filled with little-endian length prefixed keys and values
+		fdb_check(f1.get_buffer(buffer.data(), buffer.size(), &out_length, &buffer_count, &buffer_more));
+		CHECK(out_length == expected_length);
+		CHECK(buffer_count == out_count);
+		const uint8_t* in = buffer.data();
+		auto read_bytes = [&in]() {
+			uint32_t length = in[0] | (in[1] << 8) | (in[2] << 16) | ((uint32_t)in[3] << 24);
+			std::string bytes((const char*)in + 4, length);
+			in += 4 + length;
+			return bytes;
+		};
+		for (int i = 0; i < buffer_count; ++i) {
+			std::string k = read_bytes();
+			std::string v = read_bytes();
+			CHECK(k == std::string((const char*)out_kv[i].key, out_kv[i].key_length));
+			CHECK(data[k] == v);
+		}
+		CHECK(in == buffer.data() + buffer.size());
+		break;
+	}
+}
+
 TEST_CASE("cannot read system key") {
 	fdb::Transaction tr(db);
 
@@ -2115,6 +2186,28 @@ TEST_CASE("fdb_transaction_cancel") {
 	CHECK(wait_future(f2) != 1025); // transaction_cancelled
 }
 
+TEST_CASE("fdb_transaction_cancel concurrent with set") {
+	// The client buffers writes on the calling thread, which must not race with a cancel from another thread
+	for (int i = 0; i < 100; ++i) {
+		fdb::Transaction tr(db);
+		std::atomic<bool> done = false;
+		auto thread = std::thread([&]() {
+			for (int j = 0; j < 1000; ++j) {
+				tr.set(key("foo" + std::to_string(j)), "bar");
+			}
+			done = true;
+		});
+		while (!done) {
+			tr.cancel();
+		}
+		thread.join();
+
+		tr.cancel();
+		fdb::ValueFuture f = tr.get(key("foo"), /* snapshot */ false);
+		CHECK(wait_future(f) == 1025); // transaction_cancelled
+	}
+}
+
 TEST_CASE("fdb_transaction_add_conflict_range") {
 	bool success = false;
 
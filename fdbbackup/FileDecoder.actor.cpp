@@ -20,6 +20,7 @@
 
 #include <algorithm>
 #include <cstdlib>
+#include <functional>
 #include <iostream>
 #include <limits>
 #include <memory>
@@ -603,7 +604,8 @@ public:
 	std::vector<Standalone<VectorRef<KeyValueRef>>> blocks;
 
 	DecodeRangeProgress() = default;
-	DecodeRangeProgress(const RangeFile& file, bool save) : file(file), save(save) {}
+	DecodeRangeProgress(const RangeFile& file, bool save, std::function<bool(const KeyRange&)> blockFilter = nullptr)
+	  : file(file), save(save), blockFilter(blockFilter) {}
 	~DecodeRangeProgress() {
 		if (lfd != -1) {
 			close(lfd);
@@ -663,6 +665,13 @@ public:
 					return;
 				}
 
+				// Skip blocks outside of the filters if their range can be read without decoding them
+				Optional<KeyRange> blockRange = fileBackup::getRangeFileBlockRange(buf.substr(offset, len));
+				if (blockFilter && blockRange.present() && !blockFilter(blockRange.get())) {
+					offset += len;
+					continue;
+				}
+
 				Standalone<VectorRef<KeyValueRef>> chunks = fileBackup::decodeRangeFileBlock(buf.substr(offset, len));
 				blocks.push_back(chunks);
 				offset += len;
@@ -681,6 +690,7 @@ public:
 	Reference<IAsyncFile> fd;
 	int64_t offset = 0;
 	bool save = false;
+	std::function<bool(const KeyRange&)> blockFilter; // Returns false for block ranges that can be skipped
 	int lfd = -1; // local file descriptor
 };
 
@@ -704,7 +714,11 @@ ACTOR Future<Void> process_range_file(Reference<IBackupContainer> container,
 		return Void();
 	}
 
-	state DecodeRangeProgress progress(file, params->save_file_locally);
+	std::function<bool(const KeyRange&)> blockFilter;
+	if (!params->prefixes.empty()) {
+		blockFilter = [params](const KeyRange& range) { return params->matchFilters(range); };
+	}
+	state DecodeRangeProgress progress(file, params->save_file_locally, blockFilter);
 	wait(progress.openFile(container));
 
 	for (auto& block : progress.blocks) {
@@ -43,6 +43,8 @@ ReadHotSubRangeRequest::SplitType parseSplitType(const std::string& typeStr) {
 		type = ReadHotSubRangeRequest::READ_BYTES;
 	} else if (typeStr == "readOps") {
 		type = ReadHotSubRangeRequest::READ_OPS;
+	} else if (typeStr == "hotKeys") {
+		type = ReadHotSubRangeRequest::HOT_KEYS;
 	} else {
 		fmt::print("Error: {} is not a valid split type. Will use bytes as the default split type\n", typeStr);
 	}
@@ -116,12 +118,14 @@ ACTOR Future<bool> hotRangeCommandActor(Database localdb,
 CommandFactory hotRangeFactory(
     "hotrange",
     CommandHelp(
-        "hotrange <IP:PORT> <bytes|readBytes|readOps> <begin> <end> <splitCount>",
+        "hotrange <IP:PORT> <bytes|readBytes|readOps|hotKeys> <begin> <end> <splitCount>",
         "Fetch read metrics from a given storage server to detect hot range",
         "If no arguments are specified, populates the list of storage processes that can be queried. "
         "<begin> <end> specify the range you are interested in, "
         "<bytes|readBytes|readOps> is the metric used to divide ranges, "
         "splitCount is the number of returned ranges divided by the given metric. "
+        "With hotKeys, the range is not divided; instead up to splitCount of the most read key ranges tracked by the "
+        "storage server are returned. "
         "The command will return an array of json object for each range with their metrics."
         "Notice: the three metrics are sampled by a different way, so their values are not perfectly matched.\n"));
 
@@ -22,6 +22,7 @@
 #include "fdbclient/FDBTypes.h"
 #include "fdbclient/SystemData.h"
 #include "fdbclient/Tenant.h"
+#include "flow/CompressionUtils.h"
 #include "flow/IRandom.h"
 #include "flow/UnitTest.h"
 #include "flow/flow.h"
@@ -89,6 +90,7 @@ void ClientKnobs::initialize(Randomize randomize) {
 	init( CHANGE_FEED_CACHE_LIMIT_BYTES,        500000 ); if( randomize && BUGGIFY ) CHANGE_FEED_CACHE_LIMIT_BYTES = 50000;
 
 	init( MAX_BATCH_SIZE,                         1000 ); if( randomize && BUGGIFY ) MAX_BATCH_SIZE = 1;
+	init( THREAD_SAFE_TRANSACTION_WRITE_BATCH_BYTES, 100000 ); if( randomize && BUGGIFY ) THREAD_SAFE_TRANSACTION_WRITE_BATCH_BYTES = deterministicRandom()->randomInt(0, 1000);
 	init( GRV_BATCH_TIMEOUT,                     0.005 ); if( randomize && BUGGIFY ) GRV_BATCH_TIMEOUT = 0.1;
 	init( BROADCAST_BATCH_SIZE,                     20 ); if( randomize && BUGGIFY ) BROADCAST_BATCH_SIZE = 1;
 	init( TRANSACTION_TIMEOUT_DELAY_INTERVAL,     10.0 ); if( randomize && BUGGIFY ) TRANSACTION_TIMEOUT_DELAY_INTERVAL = 1.0;
@@ -110,6 +112,12 @@ void ClientKnobs::initialize(Randomize randomize) {
 	init( TAG_ENCODE_KEY_SERVERS,                false ); if( randomize && BUGGIFY ) TAG_ENCODE_KEY_SERVERS = true;
 	init( RANGESTREAM_FRAGMENT_SIZE,               1e6 );
 	init( RANGESTREAM_BUFFERED_FRAGMENTS_LIMIT,     20 );
+	init( ENABLE_RANGE_PREFETCH,                 false ); if( randomize && BUGGIFY ) ENABLE_RANGE_PREFETCH = true;
+	init( RANGE_PREFETCH_MAX_DEPTH,                  4 ); if( randomize && BUGGIFY ) RANGE_PREFETCH_MAX_DEPTH = deterministicRandom()->randomInt(1, 10);
+	init( RANGE_PREFETCH_MAX_BYTES,                1e6 ); if( randomize && BUGGIFY ) RANGE_PREFETCH_MAX_BYTES = deterministicRandom()->randomInt(1, 1e5);
+	init( ENABLE_PREFIX_COMPRESSED_RANGE_REPLIES, false ); if( randomize && BUGGIFY ) ENABLE_PREFIX_COMPRESSED_RANGE_REPLIES = true;
+	init( SPECIAL_KEY_SPACE_PARALLEL_READS,        true ); if( randomize && BUGGIFY ) SPECIAL_KEY_SPACE_PARALLEL_READS = false;
+	init( SPECIAL_KEY_SPACE_CACHE_TTL,              0.0 ); if( randomize && BUGGIFY ) SPECIAL_KEY_SPACE_CACHE_TTL = deterministicRandom()->random01();
 	init( QUARANTINE_TSS_ON_MISMATCH,             true ); if( randomize && BUGGIFY ) QUARANTINE_TSS_ON_MISMATCH = false; // if true, a tss mismatch will put the offending tss in quarantine. If false, it will just be killed
 	init( CHANGE_FEED_EMPTY_BATCH_TIME,          0.005 );
 
@@ -181,6 +189,9 @@ void ClientKnobs::initialize(Randomize randomize) {
 	init( SIM_BACKUP_TASKS_PER_AGENT,               10 );
 	init( BACKUP_RANGEFILE_BLOCK_SIZE,      1024 * 1024);
 	init( BACKUP_LOGFILE_BLOCK_SIZE,        1024 * 1024);
+	init( MUTATION_LOG_READER_MAX_PIPELINE_DEPTH,     4 ); if( randomize && BUGGIFY ) MUTATION_LOG_READER_MAX_PIPELINE_DEPTH = deterministicRandom()->randomInt(1, 10);
+	init( ENABLE_BACKUP_RANGEFILE_COMPRESSION,    false ); if( randomize && BUGGIFY ) ENABLE_BACKUP_RANGEFILE_COMPRESSION = deterministicRandom()->coinflip();
+	init( BACKUP_RANGEFILE_COMPRESSION_FILTER,   "ZSTD" ); if( randomize && BUGGIFY ) BACKUP_RANGEFILE_COMPRESSION_FILTER = CompressionUtils::toString(CompressionUtils::getRandomFilter());
 	init( BACKUP_DISPATCH_ADDTASK_SIZE,             50 );
 	init( RESTORE_DISPATCH_ADDTASK_SIZE,           150 );
 	init( RESTORE_DISPATCH_BATCH_SIZE,           30000 ); if( randomize && BUGGIFY ) RESTORE_DISPATCH_BATCH_SIZE = 20;
@@ -26,6 +26,7 @@
 #include "fdbclient/BlobRestoreCommon.h"
 #include "fdbrpc/TenantInfo.h"
 #include "fdbrpc/simulator.h"
+#include "flow/CompressionUtils.h"
 #include "flow/EncryptUtils.h"
 #include "flow/FastRef.h"
 #include "flow/flow.h"
@@ -49,6 +50,7 @@
 #include "fdbclient/Tenant.h"
 #include "flow/network.h"
 #include "flow/Trace.h"
+#include "flow/UnitTest.h"
 
 #include <cinttypes>
 #include <ctime>
@@ -1049,6 +1051,227 @@ private:
 	Key lastValue;
 };
 
+// CompressedRangeFileWriter is used exactly like RangeFileWriter, but each block is buffered in memory and written as
+// a BACKUP_AGENT_COMPRESSED_SNAPSHOT_FILE_VERSION block:
+//
+//   H F rawLen beginKey endKey payloadLen payload P
+//
+//   H = header   F = compression filter   P = padding
+//
+// beginKey and endKey are the block's range and are stored uncompressed, so a reader can tell whether it needs a
+// block without decompressing it. The payload is the block's kv pairs in columnar form: the kv count, then every key
+// as the length of the prefix it shares with the previous key (or beginKey) followed by the rest of the key, then
+// every value. The payload is compressed with the filter unless that doesn't make it smaller.
+//
+// Blocks still start at every blockSize boundary so a file can be restored in parallel, but a block is only sealed
+// once its compressed payload fills it, so it holds more kv pairs than an uncompressed block. The end key of a block
+// is the first key of the next block, and no kv pair is duplicated across blocks.
+struct CompressedRangeFileWriter : public IRangeFileWriter {
+	CompressedRangeFileWriter(CompressionFilter filter, Reference<IBackupFile> file, int blockSize)
+	  : file(file), blockSize(blockSize), filter(filter), blockEnd(0),
+	    fileVersion(BACKUP_AGENT_COMPRESSED_SNAPSHOT_FILE_VERSION), began(false), pendingBytes(0),
+	    ratio(filter == CompressionFilter::NONE ? 1.0 : 0.5) {}
+
+	// Size of a block without its begin key, end key and payload
+	static constexpr int blockOverhead = sizeof(uint32_t) + sizeof(uint8_t) + 4 * sizeof(uint32_t);
+
+	// Encodes the first count kv pairs of kvs as the uncompressed payload of a block starting at begin
+	static StringRef encodeColumns(KeyRef begin, VectorRef<KeyValueRef> kvs, int count, Arena& arena) {
+		BinaryWriter wr(Unversioned());
+		wr << bigEndian32((uint32_t)count);
+		KeyRef prev = begin;
+		for (int i = 0; i < count; i++) {
+			const KeyRef& k = kvs[i].key;
+			const int shared = commonPrefixLength(prev, k);
+			wr << bigEndian32((uint32_t)shared) << bigEndian32((uint32_t)(k.size() - shared));
+			wr.serializeBytes(k.substr(shared));
+			prev = k;
+		}
+		for (int i = 0; i < count; i++) {
+			wr << bigEndian32((uint32_t)kvs[i].value.size());
+			wr.serializeBytes(kvs[i].value);
+		}
+		return StringRef(arena, wr.toValue());
+	}
+
+	// Builds the next block from the pending kv pairs, using as many of them as fit. The block ends at the first
+	// pending kv pair left out of it, or at end if all of them fit.
+	Standalone<StringRef> makeBlock(KeyRef end, int* count) {
+		// rawSizes[n] is the uncompressed payload size of the first n pending kv pairs
+		std::vector<int64_t> rawSizes(pending.size() + 1);
+		rawSizes[0] = sizeof(uint32_t);
+		KeyRef prev = beginKey;
+		for (int i = 0; i < pending.size(); i++) {
+			const int shared = commonPrefixLength(prev, pending[i].key);
+			rawSizes[i + 1] = rawSizes[i] + 3 * sizeof(uint32_t) + pending[i].key.size() - shared +
+			                  pending[i].value.size();
+			prev = pending[i].key;
+		}
+		auto capacityFor = [&](int n) {
+			const KeyRef blockEndKey = n < pending.size() ? pending[n].key : end;
+			return blockSize - blockOverhead - beginKey.size() - blockEndKey.size();
+		};
+
+		int n = pending.size();
+		for (int attempt = 0;; attempt++) {
+			// The payload is only compressed when that makes it smaller, so kv pairs whose uncompressed payload fits
+			// always do. Compressing is the expensive part, so after a few guesses that turned out too large, settle
+			// for those.
+			if (attempt == maxCompressAttempts) {
+				CODE_PROBE(true, "Compressed range file block sized by its uncompressed payload");
+				while (n > 0 && rawSizes[n] > capacityFor(n)) {
+					n--;
+				}
+			}
+			const KeyRef blockEndKey = n < pending.size() ? pending[n].key : end;
+			const int capacity = capacityFor(n);
+			// Each attempt uses its own arena so that failed attempts don't accumulate
+			Arena arena;
+			StringRef raw = encodeColumns(beginKey, pending, n, arena);
+			StringRef payload = raw;
+			CompressionFilter payloadFilter = CompressionFilter::NONE;
+			if (filter != CompressionFilter::NONE) {
+				StringRef compressed = CompressionUtils::compress(filter, raw, arena);
+				if (compressed.size() < raw.size()) {
+					payload = compressed;
+					payloadFilter = filter;
+				}
+			}
+
+			if (payload.size() <= capacity) {
+				BinaryWriter wr(Unversioned());
+				wr << fileVersion << (uint8_t)payloadFilter << bigEndian32((uint32_t)raw.size());
+				wr << bigEndian32((uint32_t)beginKey.size());
+				wr.serializeBytes(beginKey);
+				wr << bigEndian32((uint32_t)blockEndKey.size());
+				wr.serializeBytes(blockEndKey);
+				wr << bigEndian32((uint32_t)payload.size());
+				wr.serializeBytes(payload);
+				int64_t inputBytes = 0;
+				for (int i = 0; i < n; i++) {
+					inputBytes += entryBytes(pending[i].key, pending[i].value);
+				}
+				if (inputBytes > 0) {
+					ratio = std::max(0.05, (double)payload.size() / inputBytes);
+				}
+				*count = n;
+				return wr.toValue();
+			}
+
+			// Even the block's range alone doesn't fit
+			if (n == 0) {
+				throw backup_bad_block_size();
+			}
+			CODE_PROBE(true, "Compressed range file block split after compression");
+			n = std::min(n - 1, std::max(0, (int)(n * 0.9 * capacity / payload.size())));
+			// A kv pair which doesn't fit in a block by itself
+			if (n == 0 && pending[0].key == beginKey) {
+				throw backup_bad_block_size();
+			}
+		}
+	}
+
+	// Number of times makeBlock() compresses a guess of how many kv pairs fit before it falls back to the ones whose
+	// uncompressed payload fits
+	static constexpr int maxCompressAttempts = 3;
+
+	// Writes padding to finish the current block, if any, then the next block made from the pending kv pairs
+	ACTOR static Future<Void> writeBlock(CompressedRangeFileWriter* self, Key end) {
+		state int bytesLeft = self->blockEnd - self->file->size();
+		if (bytesLeft > 0) {
+			state Value paddingFFs = makePadding(bytesLeft);
+			wait(self->file->append(paddingFFs.begin(), bytesLeft));
+		}
+		self->blockEnd += self->blockSize;
+
+		int count = 0;
+		state Standalone<StringRef> block = self->makeBlock(end, &count);
+		ASSERT(block.size() <= self->blockSize);
+
+		// The kv pairs left out of the block start the next one
+		self->beginKey = count < self->pending.size() ? Key(self->pending[count].key) : end;
+		Standalone<VectorRef<KeyValueRef>> rest;
+		for (int i = count; i < self->pending.size(); i++) {
+			rest.push_back_deep(rest.arena(), self->pending[i]);
+		}
+		self->pending = rest;
+		self->pendingBytes = 0;
+		for (const auto& kv : self->pending) {
+			self->pendingBytes += entryBytes(kv.key, kv.value);
+		}
+
+		wait(self->file->append(block.begin(), block.size()));
+		return Void();
+	}
+
+	static int entryBytes(KeyRef k, ValueRef v) { return 3 * sizeof(uint32_t) + k.size() + v.size(); }
+
+	// Uncompressed payload size at which the current block is expected to be full once compressed
+	int64_t targetPendingBytes() const { return (blockSize - blockOverhead) * 0.95 / ratio; }
+
+	// Used in simulation only to create backup file sizes which are an integer multiple of the block size
+	ACTOR static Future<Void> padEnd_impl(CompressedRangeFileWriter* self) {
+		ASSERT(g_network->isSimulated());
+		state int bytesLeft = self->blockEnd - self->file->size();
+		if (bytesLeft > 0) {
+			state Value paddingFFs = makePadding(bytesLeft);
+			wait(self->file->append(paddingFFs.begin(), bytesLeft));
+		}
+		return Void();
+	}
+
+	Future<Void> padEnd(bool final) { return padEnd_impl(this); }
+
+	// Writes the current block first if the kv pair would overfill it
+	ACTOR static Future<Void> writeKV_impl(CompressedRangeFileWriter* self, Key k, Value v) {
+		state int bytes = entryBytes(k, v);
+		if (!self->pending.empty() && self->pendingBytes + bytes > self->targetPendingBytes()) {
+			wait(writeBlock(self, k));
+		}
+		self->pending.push_back_deep(self->pending.arena(), KeyValueRef(k, v));
+		self->pendingBytes += bytes;
+		return Void();
+	}
+
+	Future<Void> writeKV(Key k, Value v) { return writeKV_impl(this, k, v); }
+
+	// The first call sets the begin key, the second one writes out all remaining blocks ending at the end key.
+	ACTOR static Future<Void> writeKey_impl(CompressedRangeFileWriter* self, Key k) {
+		if (!self->began) {
+			self->beginKey = k;
+			self->began = true;
+			return Void();
+		}
+		loop {
+			wait(writeBlock(self, k));
+			if (self->pending.empty()) {
+				break;
+			}
+		}
+		return Void();
+	}
+
+	Future<Void> writeKey(Key k) { return writeKey_impl(this, k); }
+
+	Future<Void> finish() {
+		ASSERT(pending.empty());
+		return Void();
+	}
+
+	Reference<IBackupFile> file;
+	int blockSize;
+
+private:
+	CompressionFilter filter;
+	int64_t blockEnd;
+	uint32_t fileVersion;
+	Key beginKey; // Begin key of the current block
+	bool began;
+	Standalone<VectorRef<KeyValueRef>> pending; // kv pairs of the current block
+	int64_t pendingBytes; // Uncompressed payload size of the pending kv pairs, ignoring shared key prefixes
+	double ratio; // Payload size of the last block relative to the pendingBytes it was made from
+};
+
 ACTOR static Future<Void> decodeKVPairs(StringRefReader* reader,
                                         Standalone<VectorRef<KeyValueRef>>* results,
                                         bool encryptedBlock,
@@ -1136,6 +1359,106 @@ ACTOR static Future<Void> decodeKVPairs(StringRefReader* reader,
 	return Void();
 }
 
+// Reads the range of a BACKUP_AGENT_COMPRESSED_SNAPSHOT_FILE_VERSION block, the reader must be positioned after the
+// file version. Returns the compression filter and uncompressed size of the block's payload.
+static std::pair<CompressionFilter, uint32_t> decodeCompressedRangeFileBlockHeader(StringRefReader* reader,
+                                                                                 KeyRef* begin,
+                                                                                 KeyRef* end) {
+	const uint8_t filter = reader->consume<uint8_t>();
+	if (filter >= (uint8_t)CompressionFilter::LAST) {
+		throw restore_corrupted_data();
+	}
+	const uint32_t rawLen = reader->consumeNetworkUInt32();
+	uint32_t kLen = reader->consumeNetworkUInt32();
+	*begin = KeyRef(reader->consume(kLen), kLen);
+	kLen = reader->consumeNetworkUInt32();
+	*end = KeyRef(reader->consume(kLen), kLen);
+	return { (CompressionFilter)filter, rawLen };
+}
+
+// Decodes the rest of a BACKUP_AGENT_COMPRESSED_SNAPSHOT_FILE_VERSION block into results, the reader must be
+// positioned after the file version. See CompressedRangeFileWriter for the format.
+static void decodeCompressedRangeFileBlock(StringRefReader* reader, Standalone<VectorRef<KeyValueRef>>* results) {
+	KeyRef begin, end;
+	auto [filter, rawLen] = decodeCompressedRangeFileBlockHeader(reader, &begin, &end);
+	const uint32_t payloadLen = reader->consumeNetworkUInt32();
+	StringRef payload(reader->consume(payloadLen), payloadLen);
+
+	// Make sure any remaining bytes in the block are 0xFF
+	for (auto b : reader->remainder())
+		if (b != 0xFF)
+			throw restore_corrupted_data_padding();
+
+	StringRef raw = payload;
+	if (filter != CompressionFilter::NONE) {
+		raw = CompressionUtils::decompress(filter, payload, rawLen, results->arena());
+	}
+	if (raw.size() != rawLen) {
+		throw restore_corrupted_data();
+	}
+
+	StringRefReader columns(raw, restore_corrupted_data());
+	const uint32_t count = columns.consumeNetworkUInt32();
+	results->reserve(results->arena(), count + 2);
+	results->push_back(results->arena(), KeyValueRef(begin, ValueRef()));
+	KeyRef prev = begin;
+	for (uint32_t i = 0; i < count; i++) {
+		const uint32_t shared = columns.consumeNetworkUInt32();
+		const uint32_t suffixLen = columns.consumeNetworkUInt32();
+		const uint8_t* suffix = columns.consume(suffixLen);
+		if (shared > prev.size()) {
+			throw restore_corrupted_data();
+		}
+		KeyRef k = makeString(shared + suffixLen, results->arena());
+		memcpy(mutateString(k), prev.begin(), shared);
+		memcpy(mutateString(k) + shared, suffix, suffixLen);
+		results->push_back(results->arena(), KeyValueRef(k, ValueRef()));
+		prev = k;
+	}
+	for (uint32_t i = 1; i <= count; i++) {
+		const uint32_t vLen = columns.consumeNetworkUInt32();
+		(*results)[i].value = ValueRef(columns.consume(vLen), vLen);
+	}
+	if (!columns.eof()) {
+		throw restore_corrupted_data();
+	}
+	results->push_back(results->arena(), KeyValueRef(end, ValueRef()));
+}
+
+Optional<KeyRange> getRangeFileBlockRange(const StringRef& buf) {
+	StringRefReader reader(buf, restore_corrupted_data());
+	if (reader.consume<int32_t>() != BACKUP_AGENT_COMPRESSED_SNAPSHOT_FILE_VERSION) {
+		return Optional<KeyRange>();
+	}
+	KeyRef begin, end;
+	decodeCompressedRangeFileBlockHeader(&reader, &begin, &end);
+	return KeyRange(KeyRangeRef(begin, end));
+}
+
+// Drops the kv pairs of a decoded block whose tenant no longer exists. The first and last entries are the block's
+// range and are always kept.
+ACTOR static Future<Void> removeKVPairsOfMissingTenants(Standalone<VectorRef<KeyValueRef>>* results,
+                                                        Reference<TenantEntryCache<Void>> tenantCache) {
+	state Standalone<VectorRef<KeyValueRef>> kept;
+	state int i = 0;
+	kept.arena().dependsOn(results->arena());
+	for (; i < results->size(); i++) {
+		state KeyValueRef kv = (*results)[i];
+		if (i > 0 && i + 1 < results->size() && !isSystemKey(kv.key)) {
+			state int64_t tenantId = TenantAPI::extractTenantIdFromKeyRef(kv.key);
+			Optional<TenantEntryCachePayload<Void>> payload = wait(tenantCache->getById(tenantId));
+			if (!payload.present()) {
+				TraceEvent(SevWarnAlways, "SnapshotRestoreTenantNotFound").detail("TenantId", tenantId);
+				CODE_PROBE(true, "Compressed snapshot restore tenant not found");
+				continue;
+			}
+		}
+		kept.push_back(kept.arena(), kv);
+	}
+	*results = kept;
+	return Void();
+}
+
 static Reference<IBackupContainer> getBackupContainerWithProxy(Reference<IBackupContainer> _bc) {
 	Reference<IBackupContainer> bc = IBackupContainer::openContainer(_bc->getURL(), fileBackupAgentProxy, {});
 	return bc;
@@ -1145,8 +1468,14 @@ Standalone<VectorRef<KeyValueRef>> decodeRangeFileBlock(const Standalone<StringR
 	Standalone<VectorRef<KeyValueRef>> results({}, buf.arena());
 	StringRefReader reader(buf, restore_corrupted_data());
 
-	// Read header, currently only decoding BACKUP_AGENT_SNAPSHOT_FILE_VERSION
-	if (reader.consume<int32_t>() != BACKUP_AGENT_SNAPSHOT_FILE_VERSION)
+	// Read header, currently only decoding BACKUP_AGENT_SNAPSHOT_FILE_VERSION or
+	// BACKUP_AGENT_COMPRESSED_SNAPSHOT_FILE_VERSION
+	int32_t fileVersion = reader.consume<int32_t>();
+	if (fileVersion == BACKUP_AGENT_COMPRESSED_SNAPSHOT_FILE_VERSION) {
+		decodeCompressedRangeFileBlock(&reader, &results);
+		return results;
+	}
+	if (fileVersion != BACKUP_AGENT_SNAPSHOT_FILE_VERSION)
 		throw restore_unsupported_file_version();
 
 	// Read begin key, if this fails then block was invalid.
@@ -1156,8 +1485,13 @@ Standalone<VectorRef<KeyValueRef>> decodeRangeFileBlock(const Standalone<StringR
 
 	// Read kv pairs and end key
 	while (1) {
+		// Read a key.
+		kLen = reader.consumeNetworkUInt32();
+		k = reader.consume(kLen);
+
 		// If eof reached or first value len byte is 0xFF then a valid block end was reached.
 		if (reader.eof() || *reader.rptr == 0xFF) {
+			results.push_back(results.arena(), KeyValueRef(KeyRef(k, kLen), ValueRef()));
 			break;
 		}
 
@@ -1165,6 +1499,10 @@ Standalone<VectorRef<KeyValueRef>> decodeRangeFileBlock(const Standalone<StringR
 		uint32_t vLen = reader.consumeNetworkUInt32();
 		const uint8_t* v = reader.consume(vLen);
 		results.push_back(results.arena(), KeyValueRef(KeyRef(k, kLen), ValueRef(v, vLen)));
+
+		// If eof reached or first byte of next key len is 0xFF then a valid block end was reached.
+		if (reader.eof() || *reader.rptr == 0xFF)
+			break;
 	}
 
 	// Make sure any remaining bytes in the block are 0xFF
@@ -1178,7 +1516,8 @@ Standalone<VectorRef<KeyValueRef>> decodeRangeFileBlock(const Standalone<StringR
 ACTOR Future<Standalone<VectorRef<KeyValueRef>>> decodeRangeFileBlock(Reference<IAsyncFile> file,
                                                                       int64_t offset,
                                                                       int len,
-                                                                      Database cx) {
+                                                                      Database cx,
+                                                                      std::vector<KeyRange> ranges) {
 	state Standalone<StringRef> buf = makeString(len);
 	int rLen = wait(uncancellable(holdWhile(buf, file->read(mutateString(buf), len, offset))));
 	if (rLen != len)
@@ -1186,6 +1525,23 @@ ACTOR Future<Standalone<VectorRef<KeyValueRef>>> decodeRangeFileBlock(Reference<
 
 	simulateBlobFailure();
 
+	// A compressed block records its range ahead of its payload, so a block outside the ranges of interest is
+	// returned as just its range without being decompressed
+	if (!ranges.empty()) {
+		Optional<KeyRange> blockRange = getRangeFileBlockRange(buf);
+		bool needed = !blockRange.present();
+		for (int i = 0; i < ranges.size() && !needed; i++) {
+			needed = ranges[i].intersects(blockRange.get());
+		}
+		if (!needed) {
+			CODE_PROBE(true, "Skipped decoding a compressed range file block outside the ranges of interest");
+			Standalone<VectorRef<KeyValueRef>> skipped;
+			skipped.push_back_deep(skipped.arena(), KeyValueRef(blockRange.get().begin, ValueRef()));
+			skipped.push_back_deep(skipped.arena(), KeyValueRef(blockRange.get().end, ValueRef()));
+			return skipped;
+		}
+	}
+
 	state Standalone<VectorRef<KeyValueRef>> results({}, buf.arena());
 	state StringRefReader reader(buf, restore_corrupted_data());
 	state Arena arena;
@@ -1199,8 +1555,8 @@ ACTOR Future<Standalone<VectorRef<KeyValueRef>>> decodeRangeFileBlock(Reference<
 	state int64_t blockDomainId = TenantInfo::INVALID_TENANT;
 
 	try {
-		// Read header, currently only decoding BACKUP_AGENT_SNAPSHOT_FILE_VERSION or
-		// BACKUP_AGENT_ENCRYPTED_SNAPSHOT_FILE_VERSION
+		// Read header, currently only decoding BACKUP_AGENT_SNAPSHOT_FILE_VERSION,
+		// BACKUP_AGENT_ENCRYPTED_SNAPSHOT_FILE_VERSION or BACKUP_AGENT_COMPRESSED_SNAPSHOT_FILE_VERSION
 		int32_t file_version = reader.consume<int32_t>();
 		ASSERT(!encryptMode.isEncryptionEnabled() || file_version == BACKUP_AGENT_ENCRYPTED_SNAPSHOT_FILE_VERSION);
 		if (file_version == BACKUP_AGENT_SNAPSHOT_FILE_VERSION) {
@@ -1233,6 +1589,11 @@ ACTOR Future<Standalone<VectorRef<KeyValueRef>>> decodeRangeFileBlock(Reference<
 			    wait(EncryptedRangeFileWriter::decrypt(cx, encryptHeader, dataPayloadStart, dataLen, &results.arena()));
 			reader = StringRefReader(decryptedData, restore_corrupted_data());
 			wait(decodeKVPairs(&reader, &results, true, encryptMode, blockDomainId, tenantCache));
+		} else if (file_version == BACKUP_AGENT_COMPRESSED_SNAPSHOT_FILE_VERSION) {
+			decodeCompressedRangeFileBlock(&reader, &results);
+			if (tenantCache.present()) {
+				wait(removeKVPairsOfMissingTenants(&results, tenantCache.get()));
+			}
 		} else {
 			throw restore_unsupported_file_version();
 		}
@@ -1931,6 +2292,14 @@ struct BackupRangeTaskFunc : BackupTaskFuncBase {
 					CODE_PROBE(true, "using encrypted snapshot file writer", probe::decoration::rare);
 					rangeFile = std::make_unique<EncryptedRangeFileWriter>(
 					    cx, &arena, encryptMode, tenantCache, outFile, blockSize);
+				} else if (CLIENT_KNOBS->ENABLE_BACKUP_RANGEFILE_COMPRESSION) {
+					CompressionFilter filter =
+					    CompressionUtils::fromFilterString(CLIENT_KNOBS->BACKUP_RANGEFILE_COMPRESSION_FILTER);
+					if (!CompressionUtils::supportedFilters.count(filter)) {
+						filter = CompressionFilter::NONE;
+					}
+					CODE_PROBE(true, "using compressed snapshot file writer");
+					rangeFile = std::make_unique<CompressedRangeFileWriter>(filter, outFile, blockSize);
 				} else {
 					rangeFile = std::make_unique<RangeFileWriter>(outFile, blockSize);
 				}
@@ -3734,7 +4103,8 @@ struct RestoreRangeTaskFunc : RestoreFileTaskFuncBase {
 		state Reference<IAsyncFile> inFile = wait(bc.get()->readFile(rangeFile.fileName));
 		state Standalone<VectorRef<KeyValueRef>> blockData;
 		try {
-			Standalone<VectorRef<KeyValueRef>> data = wait(decodeRangeFileBlock(inFile, readOffset, readLen, cx));
+			Standalone<VectorRef<KeyValueRef>> data =
+			    wait(decodeRangeFileBlock(inFile, readOffset, readLen, cx, restoreRanges.get()));
 			blockData = data;
 		} catch (Error& e) {
 			// It's possible a tenant was deleted and the encrypt key fetch failed
@@ -7040,3 +7410,78 @@ void simulateBlobFailure() {
 		}
 	}
 }
+
+namespace {
+// An in-memory backup file for testing range file writers
+struct MemoryBackupFile : IBackupFile, ReferenceCounted<MemoryBackupFile> {
+	MemoryBackupFile() : IBackupFile("memory") {}
+
+	Future<Void> append(const void* data, int len) override {
+		content.append((const char*)data, len);
+		return Void();
+	}
+	Future<Void> finish() override { return Void(); }
+	int64_t size() const override { return content.size(); }
+
+	void addref() override { ReferenceCounted<MemoryBackupFile>::addref(); }
+	void delref() override { ReferenceCounted<MemoryBackupFile>::delref(); }
+
+	std::string content;
+};
+} // namespace
+
+TEST_CASE("/backup/compressedRangeFile") {
+	state Reference<MemoryBackupFile> file = makeReference<MemoryBackupFile>();
+	state int blockSize = deterministicRandom()->randomInt(256, 8192);
+	state CompressionFilter filter = CompressionUtils::getRandomFilter();
+	state fileBackup::CompressedRangeFileWriter writer(filter, file, blockSize);
+
+	// Keys share long prefixes and values repeat, so both key and block compression have something to work with
+	state Standalone<VectorRef<KeyValueRef>> kvs;
+	state int count = deterministicRandom()->randomInt(0, 2000);
+	for (int n = 0; n < count; n++) {
+		Key k = StringRef(format("prefix/%08d/%d", n * 7, deterministicRandom()->randomInt(0, 100)));
+		Value v = makeString(deterministicRandom()->randomInt(0, 100));
+		memset(mutateString(v), 'a' + n % 4, v.size());
+		kvs.push_back_deep(kvs.arena(), KeyValueRef(k, v));
+	}
+
+	state int i = 0;
+	wait(writer.writeKey("prefix/"_sr));
+	for (; i < kvs.size(); i++) {
+		wait(writer.writeKV(kvs[i].key, kvs[i].value));
+	}
+	wait(writer.writeKey("prefix0"_sr));
+	wait(writer.finish());
+
+	// Every block starts at a block boundary and starts where the previous one ended
+	Standalone<StringRef> content = StringRef(file->content);
+	std::vector<KeyValueRef> decoded;
+	Key expectedBegin = "prefix/"_sr;
+	for (int64_t offset = 0; offset < content.size(); offset += blockSize) {
+		StringRef buf = content.substr(offset, std::min<int64_t>(blockSize, content.size() - offset));
+		Standalone<VectorRef<KeyValueRef>> block =
+		    fileBackup::decodeRangeFileBlock(Standalone<StringRef>(buf, content.arena()));
+		ASSERT_GE(block.size(), 2);
+		ASSERT(block.front().key == expectedBegin);
+		Optional<KeyRange> range = fileBackup::getRangeFileBlockRange(buf);
+		ASSERT(range.present() && range.get() == KeyRangeRef(block.front().key, block.back().key));
+		for (int j = 1; j < block.size() - 1; j++) {
+			decoded.push_back(KeyValueRef(kvs.arena(), block[j]));
+		}
+		expectedBegin = block.back().key;
+	}
+	ASSERT(expectedBegin == "prefix0"_sr);
+	ASSERT_EQ(decoded.size(), kvs.size());
+	for (int j = 0; j < kvs.size(); j++) {
+		ASSERT(decoded[j] == kvs[j]);
+	}
+
+	TraceEvent("CompressedRangeFileTest")
+	    .detail("Filter", CompressionUtils::toString(filter))
+	    .detail("BlockSize", blockSize)
+	    .detail("KVs", kvs.size())
+	    .detail("Bytes", kvs.expectedSize())
+	    .detail("FileSize", content.size());
+	return Void();
+}
@@ -2708,6 +2708,203 @@ void MultiVersionDatabase::LegacyVersionMonitor::close() {
 	}
 }
 
+// ShardedTenant
+ShardedTenant::ShardedTenant(std::vector<Reference<ITenant>> shards) : shards(std::move(shards)), nextShard(0) {
+	ASSERT(!this->shards.empty());
+}
+
+Reference<ITransaction> ShardedTenant::createTransaction() {
+	return shards[nextShard.fetch_add(1, std::memory_order_relaxed) % shards.size()]->createTransaction();
+}
+
+ThreadFuture<int64_t> ShardedTenant::getId() {
+	return shards[0]->getId();
+}
+
+ThreadFuture<Key> ShardedTenant::purgeBlobGranules(const KeyRangeRef& keyRange, Version purgeVersion, bool force) {
+	return shards[0]->purgeBlobGranules(keyRange, purgeVersion, force);
+}
+
+ThreadFuture<Void> ShardedTenant::waitPurgeGranulesComplete(const KeyRef& purgeKey) {
+	return shards[0]->waitPurgeGranulesComplete(purgeKey);
+}
+
+ThreadFuture<bool> ShardedTenant::blobbifyRange(const KeyRangeRef& keyRange) {
+	return shards[0]->blobbifyRange(keyRange);
+}
+
+ThreadFuture<bool> ShardedTenant::blobbifyRangeBlocking(const KeyRangeRef& keyRange) {
+	return shards[0]->blobbifyRangeBlocking(keyRange);
+}
+
+ThreadFuture<bool> ShardedTenant::unblobbifyRange(const KeyRangeRef& keyRange) {
+	return shards[0]->unblobbifyRange(keyRange);
+}
+
+ThreadFuture<Standalone<VectorRef<KeyRangeRef>>> ShardedTenant::listBlobbifiedRanges(const KeyRangeRef& keyRange,
+                                                                                     int rangeLimit) {
+	return shards[0]->listBlobbifiedRanges(keyRange, rangeLimit);
+}
+
+ThreadFuture<Version> ShardedTenant::verifyBlobRange(const KeyRangeRef& keyRange, Optional<Version> version) {
+	return shards[0]->verifyBlobRange(keyRange, version);
+}
+
+ThreadFuture<bool> ShardedTenant::flushBlobRange(const KeyRangeRef& keyRange, bool compact, Optional<Version> version) {
+	return shards[0]->flushBlobRange(keyRange, compact, version);
+}
+
+// ShardedDatabase
+ShardedDatabase::ShardedDatabase(std::vector<Reference<IDatabase>> shards) : shards(std::move(shards)), nextShard(0) {
+	ASSERT(!this->shards.empty());
+	TraceEvent("ShardedDatabaseCreated").detail("Shards", this->shards.size());
+}
+
+Reference<ITenant> ShardedDatabase::openTenant(TenantNameRef tenantName) {
+	std::vector<Reference<ITenant>> tenants;
+	tenants.reserve(shards.size());
+	for (auto& shard : shards) {
+		tenants.push_back(shard->openTenant(tenantName));
+	}
+	return makeReference<ShardedTenant>(std::move(tenants));
+}
+
+Reference<ITransaction> ShardedDatabase::createTransaction() {
+	// Of the next two shards in round robin order, use the one whose network thread is less busy, so that a thread
+	// slowed down by long running transactions is given fewer new ones
+	uint32_t start = nextShard.fetch_add(1, std::memory_order_relaxed);
+	int first = start % shards.size();
+	int second = (start + 1) % shards.size();
+	if (first != second && shards[second]->getMainThreadBusyness() < shards[first]->getMainThreadBusyness()) {
+		first = second;
+	}
+	return shards[first]->createTransaction();
+}
+
+void ShardedDatabase::setOption(FDBDatabaseOptions::Option option, Optional<StringRef> value) {
+	for (auto& shard : shards) {
+		shard->setOption(option, value);
+	}
+}
+
+double ShardedDatabase::getMainThreadBusyness() {
+	double busyness = 0;
+	for (auto& shard : shards) {
+		busyness += shard->getMainThreadBusyness();
+	}
+	return busyness / shards.size();
+}
+
+ThreadFuture<ProtocolVersion> ShardedDatabase::getServerProtocol(Optional<ProtocolVersion> expectedVersion) {
+	return shards[0]->getServerProtocol(expectedVersion);
+}
+
+ThreadFuture<int64_t> ShardedDatabase::rebootWorker(const StringRef& address, bool check, int duration) {
+	return shards[0]->rebootWorker(address, check, duration);
+}
+
+ThreadFuture<Void> ShardedDatabase::forceRecoveryWithDataLoss(const StringRef& dcid) {
+	return shards[0]->forceRecoveryWithDataLoss(dcid);
+}
+
+ThreadFuture<Void> ShardedDatabase::createSnapshot(const StringRef& uid, const StringRef& snapshot_command) {
+	return shards[0]->createSnapshot(uid, snapshot_command);
+}
+
+ThreadFuture<Key> ShardedDatabase::purgeBlobGranules(const KeyRangeRef& keyRange, Version purgeVersion, bool force) {
+	return shards[0]->purgeBlobGranules(keyRange, purgeVersion, force);
+}
+
+ThreadFuture<Void> ShardedDatabase::waitPurgeGranulesComplete(const KeyRef& purgeKey) {
+	return shards[0]->waitPurgeGranulesComplete(purgeKey);
+}
+
+ThreadFuture<bool> ShardedDatabase::blobbifyRange(const KeyRangeRef& keyRange) {
+	return shards[0]->blobbifyRange(keyRange);
+}
+
+ThreadFuture<bool> ShardedDatabase::blobbifyRangeBlocking(const KeyRangeRef& keyRange) {
+	return shards[0]->blobbifyRangeBlocking(keyRange);
+}
+
+ThreadFuture<bool> ShardedDatabase::unblobbifyRange(const KeyRangeRef& keyRange) {
+	return shards[0]->unblobbifyRange(keyRange);
+}
+
+ThreadFuture<Standalone<VectorRef<KeyRangeRef>>> ShardedDatabase::listBlobbifiedRanges(const KeyRangeRef& keyRange,
+                                                                                       int rangeLimit) {
+	return shards[0]->listBlobbifiedRanges(keyRange, rangeLimit);
+}
+
+ThreadFuture<Version> ShardedDatabase::verifyBlobRange(const KeyRangeRef& keyRange, Optional<Version> version) {
+	return shards[0]->verifyBlobRange(keyRange, version);
+}
+
+ThreadFuture<bool> ShardedDatabase::flushBlobRange(const KeyRangeRef& keyRange,
+                                                   bool compact,
+                                                   Optional<Version> version) {
+	return shards[0]->flushBlobRange(keyRange, compact, version);
+}
+
+ThreadFuture<DatabaseSharedState*> ShardedDatabase::createSharedState() {
+	return shards[0]->createSharedState();
+}
+
+void ShardedDatabase::setSharedState(DatabaseSharedState* p) {
+	shards[0]->setSharedState(p);
+}
+
+// Combines the client status of every shard: the status of the first shard, for compatibility with readers of an
+// unsharded status, with the status of each shard under "Shards". The database is healthy if every shard is.
+static Standalone<StringRef> combineShardClientStatus(std::vector<Standalone<StringRef>> const& statuses) {
+	json_spirit::mObject statusObj;
+	json_spirit::mArray shardArr;
+	bool healthy = true;
+	for (const auto& status : statuses) {
+		json_spirit::mValue shardStatusVal;
+		json_spirit::read_string(status.toString(), shardStatusVal);
+		if (shardStatusVal.type() != json_spirit::obj_type) {
+			healthy = false;
+			shardArr.push_back(shardStatusVal);
+			continue;
+		}
+		auto& shardStatusObj = shardStatusVal.get_obj();
+		auto healthyIter = shardStatusObj.find("Healthy");
+		healthy = healthy && healthyIter != shardStatusObj.end() &&
+		          healthyIter->second.type() == json_spirit::bool_type && healthyIter->second.get_bool();
+		if (shardArr.empty()) {
+			statusObj = shardStatusObj;
+		}
+		shardArr.push_back(shardStatusVal);
+	}
+	statusObj["Shards"] = shardArr;
+	statusObj["Healthy"] = healthy;
+	return StringRef(json_spirit::write_string(json_spirit::mValue(statusObj)));
+}
+
+// Collects the client status of shards[index] and the shards after it, one at a time, after statuses
+static ThreadFuture<Standalone<StringRef>> getShardClientStatus(std::vector<Reference<IDatabase>> shards,
+                                                                int index,
+                                                                std::vector<Standalone<StringRef>> statuses) {
+	return flatMapThreadFuture<Standalone<StringRef>, Standalone<StringRef>>(
+	    shards[index]->getClientStatus(),
+	    [shards, index, statuses](
+	        ErrorOr<Standalone<StringRef>> status) mutable -> ErrorOr<ThreadFuture<Standalone<StringRef>>> {
+		    if (status.isError()) {
+			    return status.getError();
+		    }
+		    statuses.push_back(status.get());
+		    if (index + 1 < shards.size()) {
+			    return getShardClientStatus(shards, index + 1, std::move(statuses));
+		    }
+		    return ThreadFuture<Standalone<StringRef>>(combineShardClientStatus(statuses));
+	    });
+}
+
+ThreadFuture<Standalone<StringRef>> ShardedDatabase::getClientStatus() {
+	return getShardClientStatus(shards, 0, {});
+}
+
 // MultiVersionApi
 void MultiVersionApi::runOnExternalClientsAllThreads(std::function<void(Reference<ClientInfo>)> func,
                                                      bool runOnFailedClients,
@@ -3035,6 +3232,13 @@ void MultiVersionApi::setNetworkOptionInternal(FDBNetworkOptions::Option option,
 		// multiple client threads are not supported on windows.
 		threadCount = extractIntOption(value, 1, 1);
 #endif
+	} else if (option == FDBNetworkOptions::SHARD_DATABASE_ACROSS_CLIENT_THREADS) {
+		MutexHolder holder(lock);
+		validateOption(value, false, true);
+		if (networkStartSetup) {
+			throw invalid_option();
+		}
+		shardDatabases = true;
 	} else if (option == FDBNetworkOptions::CLIENT_TMP_DIR) {
 		validateOption(value, true, false, false);
 		tmpDir = abspath(value.get().toString());
@@ -3304,6 +3508,19 @@ Reference<IDatabase> MultiVersionApi::createDatabase(ClusterConnectionRecord con
 	if (localClientDisabled) {
 		ASSERT(!bypassMultiClientApi);
 
+		if (shardDatabases && threadCount > 1) {
+			int shardCount = threadCount;
+			lock.leave();
+
+			std::vector<Reference<IDatabase>> shards;
+			for (int threadIdx = 0; threadIdx < shardCount; ++threadIdx) {
+				Reference<IDatabase> localDb = connectionRecord.createDatabase(localClient->api);
+				shards.push_back(Reference<IDatabase>(
+				    new MultiVersionDatabase(this, threadIdx, connectionRecord, Reference<IDatabase>(), localDb)));
+			}
+			return Reference<IDatabase>(new ShardedDatabase(std::move(shards)));
+		}
+
 		int threadIdx = nextThread;
 		nextThread = (nextThread + 1) % threadCount;
 		lock.leave();
@@ -3541,8 +3758,8 @@ void MultiVersionApi::loadEnvironmentVariableNetworkOptions() {
 MultiVersionApi::MultiVersionApi()
   : callbackOnMainThread(true), localClientDisabled(false), networkStartSetup(false), networkSetup(false),
     disableBypass(false), bypassMultiClientApi(false), externalClient(false), ignoreExternalClientFailures(false),
-    failIncompatibleClient(false), retainClientLibCopies(false), apiVersion(0), threadCount(0), tmpDir("/tmp"),
-    traceShareBaseNameAmongThreads(false), envOptionsLoaded(false) {}
+    failIncompatibleClient(false), retainClientLibCopies(false), shardDatabases(false), apiVersion(0), threadCount(0),
+    tmpDir("/tmp"), traceShareBaseNameAmongThreads(false), envOptionsLoaded(false) {}
 
 MultiVersionApi* MultiVersionApi::api = new MultiVersionApi();
 
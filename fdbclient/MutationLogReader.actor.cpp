@@ -63,6 +63,13 @@ Future<Void> PipelinedReader::getNext(Database cx) {
 	return getNext_impl(this, cx);
 }
 
+void PipelinedReader::stalled() {
+	if (pipelineDepth < (unsigned)CLIENT_KNOBS->MUTATION_LOG_READER_MAX_PIPELINE_DEPTH) {
+		++pipelineDepth;
+		readerLimitChanged.trigger();
+	}
+}
+
 ACTOR Future<Void> PipelinedReader::getNext_impl(PipelinedReader* self, Database cx) {
 	state Transaction tr(cx);
 
@@ -75,8 +82,11 @@ ACTOR Future<Void> PipelinedReader::getNext_impl(PipelinedReader* self, Database
 	state Key end = versionToKey(self->endVersion, self->prefix);
 
 	loop {
-		// Get the lock
-		wait(self->readerLimit.take());
+		// Wait for room in the pipeline
+		while (self->unconsumed >= self->pipelineDepth) {
+			wait(self->readerLimitChanged.onTrigger());
+		}
+		++self->unconsumed;
 
 		// Read begin to end forever until successful
 		loop {
@@ -138,27 +148,28 @@ ACTOR Future<Void> MutationLogReader::initializePQ(MutationLogReader* self) {
 }
 
 Future<Standalone<RangeResultRef>> MutationLogReader::getNext() {
-	return getNext_impl(this);
+	return getNextBatch_impl(this, 0);
 }
 
-ACTOR Future<Standalone<RangeResultRef>> MutationLogReader::getNext_impl(MutationLogReader* self) {
+Future<Standalone<RangeResultRef>> MutationLogReader::getNextBatch(int64_t maxBytes) {
+	return getNextBatch_impl(this, maxBytes);
+}
+
+ACTOR Future<Standalone<RangeResultRef>> MutationLogReader::getNextBatch_impl(MutationLogReader* self,
+                                                                               int64_t maxBytes) {
+	state Standalone<RangeResultRef> batch;
 	loop {
-		if (self->finished == 256) {
-			state int i;
-			for (i = 0; i < self->pipelinedReaders.size(); ++i) {
-				wait(self->pipelinedReaders[i]->done());
+		if (self->refill.present()) {
+			state int hash = self->refill.get();
+			if (!self->pipelinedReaders[hash]->reads.getFuture().isReady()) {
+				// Hand out what is merged so far rather than waiting
+				if (!batch.empty()) {
+					return batch;
+				}
+				self->pipelinedReaders[hash]->stalled();
 			}
-			throw end_of_stream();
-		}
-		mutation_log_reader::RangeResultBlock top = self->priorityQueue.top();
-		self->priorityQueue.pop();
-		uint8_t hash = top.hash;
-		state Standalone<RangeResultRef> ret = top.consume();
-		if (top.empty()) {
-			self->pipelinedReaders[(int)hash]->release();
 			try {
-				mutation_log_reader::RangeResultBlock next =
-				    waitNext(self->pipelinedReaders[(int)hash]->reads.getFuture());
+				mutation_log_reader::RangeResultBlock next = waitNext(self->pipelinedReaders[hash]->reads.getFuture());
 				self->priorityQueue.push(next);
 			} catch (Error& e) {
 				if (e.code() == error_code_end_of_stream) {
@@ -167,11 +178,39 @@ ACTOR Future<Standalone<RangeResultRef>> MutationLogReader::getNext_impl(Mutatio
 					throw e;
 				}
 			}
+			self->refill.reset();
+		}
+		if (self->finished == 256) {
+			if (!batch.empty()) {
+				return batch;
+			}
+			state int i;
+			for (i = 0; i < self->pipelinedReaders.size(); ++i) {
+				wait(self->pipelinedReaders[i]->done());
+			}
+			throw end_of_stream();
+		}
+		mutation_log_reader::RangeResultBlock top = self->priorityQueue.top();
+		self->priorityQueue.pop();
+		Standalone<RangeResultRef> ret = top.consume();
+		if (top.empty()) {
+			self->pipelinedReaders[(int)top.hash]->release();
+			self->refill = top.hash;
 		} else {
 			self->priorityQueue.push(top);
 		}
-		if (ret.size() != 0) {
-			return ret;
+		// batch keeps its own arena, which depends on those of the blocks appended to it. Taking over a block's arena
+		// instead would make it depend on itself once a later block of the same reader is appended.
+		if (batch.empty() || !ret.empty()) {
+			if (!ret.empty()) {
+				batch.arena().dependsOn(ret.arena());
+				batch.append(batch.arena(), ret.begin(), ret.size());
+			}
+			batch.more = ret.more;
+			batch.readThrough = ret.readThrough;
+		}
+		if (!batch.empty() && batch.expectedSize() >= maxBytes) {
+			return batch;
 		}
 	}
 }
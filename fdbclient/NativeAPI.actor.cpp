@@ -1395,18 +1395,22 @@ struct SingleSpecialKeyImpl : SpecialKeyRangeReadImpl {
 
 	SingleSpecialKeyImpl(KeyRef k,
 	                     const std::function<Future<Optional<Value>>(ReadYourWritesTransaction*)>& f,
-	                     bool supportsTenants = false)
-	  : SpecialKeyRangeReadImpl(singleKeyRange(k)), k(k), f(f), tenantSupport(supportsTenants) {}
+	                     bool supportsTenants = false,
+	                     bool cacheable = false)
+	  : SpecialKeyRangeReadImpl(singleKeyRange(k)), k(k), f(f), tenantSupport(supportsTenants), cacheable(cacheable) {}
 
 	bool supportsTenants() const override {
 		CODE_PROBE(tenantSupport, "Single special key in tenant");
 		return tenantSupport;
 	};
 
+	double cacheTTL() const override { return cacheable ? CLIENT_KNOBS->SPECIAL_KEY_SPACE_CACHE_TTL : 0; }
+
 private:
 	Key k;
 	std::function<Future<Optional<Value>>(ReadYourWritesTransaction*)> f;
 	bool tenantSupport;
+	bool cacheable; // the value only depends on the database, not on the transaction reading it
 };
 
 class HealthMetricsRangeImpl : public SpecialKeyRangeAsyncImpl {
@@ -1540,6 +1544,10 @@ DatabaseContext::DatabaseContext(Reference<AsyncVar<Reference<IClusterConnection
     transactionImmediateReadVersionsCompleted("ImmediatePriorityReadVersionsCompleted", cc),
     transactionLogicalReads("LogicalUncachedReads", cc), transactionPhysicalReads("PhysicalReadRequests", cc),
     transactionPhysicalReadsCompleted("PhysicalReadRequestsCompleted", cc),
+    transactionRangePrefetches("RangePrefetches", cc), transactionRangePrefetchHits("RangePrefetchHits", cc),
+    transactionSpecialKeyModuleReads("SpecialKeyModuleReads", cc),
+    transactionSpecialKeyModuleCacheHits("SpecialKeyModuleCacheHits", cc),
+    transactionSpecialKeyModuleReadMicroseconds("SpecialKeyModuleReadMicroseconds", cc),
     transactionGetKeyRequests("GetKeyRequests", cc), transactionGetValueRequests("GetValueRequests", cc),
     transactionGetRangeRequests("GetRangeRequests", cc),
     transactionGetMappedRangeRequests("GetMappedRangeRequests", cc),
@@ -1771,6 +1779,7 @@ DatabaseContext::DatabaseContext(Reference<AsyncVar<Reference<IClusterConnection
 				                            return Optional<Value>();
 			                            }
 		                            },
+		                            true,
 		                            true));
 		registerSpecialKeysImpl(SpecialKeySpace::MODULE::CLUSTERFILEPATH,
 		                        SpecialKeySpace::IMPLTYPE::READONLY,
@@ -1854,6 +1863,10 @@ DatabaseContext::DatabaseContext(const Error& err)
     transactionImmediateReadVersionsCompleted("ImmediatePriorityReadVersionsCompleted", cc),
     transactionLogicalReads("LogicalUncachedReads", cc), transactionPhysicalReads("PhysicalReadRequests", cc),
     transactionPhysicalReadsCompleted("PhysicalReadRequestsCompleted", cc),
+    transactionRangePrefetches("RangePrefetches", cc), transactionRangePrefetchHits("RangePrefetchHits", cc),
+    transactionSpecialKeyModuleReads("SpecialKeyModuleReads", cc),
+    transactionSpecialKeyModuleCacheHits("SpecialKeyModuleCacheHits", cc),
+    transactionSpecialKeyModuleReadMicroseconds("SpecialKeyModuleReadMicroseconds", cc),
     transactionGetKeyRequests("GetKeyRequests", cc), transactionGetValueRequests("GetValueRequests", cc),
     transactionGetRangeRequests("GetRangeRequests", cc),
     transactionGetMappedRangeRequests("GetMappedRangeRequests", cc),
@@ -4292,6 +4305,14 @@ PublicRequestStream<GetKeyValuesFamilyRequest> StorageServerInterface::*getRange
 	}
 }
 
+// Lets the storage server send the reply with shared key prefixes elided, which only plain range reads support
+template <class GetKeyValuesFamilyRequest>
+void allowPrefixCompressedReply(GetKeyValuesFamilyRequest& req) {
+	if constexpr (std::is_same<GetKeyValuesFamilyRequest, GetKeyValuesRequest>::value) {
+		req.acceptPrefixCompressed = CLIENT_KNOBS->ENABLE_PREFIX_COMPRESSED_RANGE_REPLIES;
+	}
+}
+
 ACTOR template <class GetKeyValuesFamilyRequest, class GetKeyValuesFamilyReply, class RangeResultFamily>
 Future<RangeResultFamily> getExactRange(Reference<TransactionState> trState,
                                         KeyRange keys,
@@ -4347,6 +4368,7 @@ Future<RangeResultFamily> getExactRange(Reference<TransactionState> trState,
 			req.tags = trState->cx->sampleReadTags() ? trState->options.readTags : Optional<TagSet>();
 
 			req.options = trState->readOptions;
+			allowPrefixCompressedReply(req);
 
 			try {
 				if (trState->readOptions.present() && trState->readOptions.get().debugID.present()) {
@@ -4740,6 +4762,7 @@ Future<RangeResultFamily> getRange(Reference<TransactionState> trState,
 
 			req.tags = trState->cx->sampleReadTags() ? trState->options.readTags : Optional<TagSet>();
 			req.spanContext = span.context;
+			allowPrefixCompressedReply(req);
 			if (trState->readOptions.present() && trState->readOptions.get().debugID.present()) {
 				getRangeID = nondeterministicRandom()->randomUniqueID();
 				g_traceBatch.addAttach(
@@ -5558,6 +5581,9 @@ void Transaction::operator=(Transaction&& r) noexcept {
 	committing = std::move(r.committing);
 	backoff = r.backoff;
 	watches = r.watches;
+	lastRangeRead = std::move(r.lastRangeRead);
+	rangePrefetches = std::move(r.rangePrefetches);
+	rangePrefetchDepth = r.rangePrefetchDepth;
 }
 
 void Transaction::flushTrLogsIfEnabled() {
@@ -5909,11 +5935,149 @@ Future<RangeResultFamily> Transaction::getRangeInternal(const KeySelector& begin
 	    trState, b, e, mapper, limits, conflictRange, snapshot, reverse);
 }
 
+// Reads the batch of a scan that follows previous, once previous is ready. conflictRange is always set, to an empty
+// range if there is no such batch, since a served prefetch adds it to the transaction's conflict ranges.
+ACTOR Future<RangeResult> prefetchRangeContinuation(Reference<TransactionState> trState,
+                                                    Future<RangeResult> previous,
+                                                    KeySelector fixedSelector,
+                                                    GetRangeLimits limits,
+                                                    Promise<std::pair<Key, Key>> conflictRange,
+                                                    Snapshot snapshot,
+                                                    Reverse reverse) {
+	try {
+		RangeResult previousResult = wait(previous);
+		if (!previousResult.more || previousResult.empty()) {
+			// Never served, since a read only continues a batch that has more
+			conflictRange.send(std::make_pair(Key(), Key()));
+			return RangeResult();
+		}
+
+		Key lastKey = previousResult[previousResult.size() - 1].key;
+		KeySelector next = reverse ? KeySelector(firstGreaterOrEqual(lastKey), lastKey.arena())
+		                           : KeySelector(firstGreaterOrEqual(keyAfter(lastKey)));
+		KeySelector begin = reverse ? fixedSelector : next;
+		KeySelector end = reverse ? next : fixedSelector;
+		if (begin.offset >= end.offset && begin.getKey() >= end.getKey()) {
+			conflictRange.send(std::make_pair(Key(), Key()));
+			return RangeResult();
+		}
+
+		++trState->cx->transactionRangePrefetches;
+		RangeResult result = wait(::getRange<GetKeyValuesRequest, GetKeyValuesReply, RangeResult>(
+		    trState, begin, end, ""_sr, limits, conflictRange, snapshot, reverse));
+		return result;
+	} catch (Error& e) {
+		if (conflictRange.canBeSet()) {
+			conflictRange.send(std::make_pair(Key(), Key()));
+		}
+		throw;
+	}
+}
+
+static bool sameSelector(KeySelector const& a, KeySelector const& b) {
+	return a.getKey() == b.getKey() && a.orEqual == b.orEqual && a.offset == b.offset;
+}
+
+// True if a read with limits may be answered by a read made with prefetched, which returns no more than limits allows
+static bool limitsCover(GetRangeLimits const& limits, GetRangeLimits const& prefetched) {
+	auto covers = [](int limit, int prefetchedLimit) {
+		return limit == GetRangeLimits::ROW_LIMIT_UNLIMITED ||
+		       (prefetchedLimit != GetRangeLimits::ROW_LIMIT_UNLIMITED && prefetchedLimit <= limit);
+	};
+	return covers(limits.rows, prefetched.rows) && covers(limits.bytes, prefetched.bytes) &&
+	       limits.minRows <= prefetched.minRows;
+}
+
+bool Transaction::continuesLastRangeRead(KeySelector const& begin,
+                                         KeySelector const& end,
+                                         Snapshot snapshot,
+                                         Reverse reverse) {
+	if (!lastRangeRead.result.isValid() || !lastRangeRead.result.isReady() || lastRangeRead.result.isError() ||
+	    bool(lastRangeRead.snapshot) != bool(snapshot) || bool(lastRangeRead.reverse) != bool(reverse)) {
+		return false;
+	}
+	RangeResult const& last = lastRangeRead.result.get();
+	if (!last.more || last.empty()) {
+		return false;
+	}
+	KeyRef lastKey = last[last.size() - 1].key;
+	if (reverse) {
+		return sameSelector(begin, lastRangeRead.fixedSelector) && sameSelector(end, firstGreaterOrEqual(lastKey));
+	}
+	return sameSelector(end, lastRangeRead.fixedSelector) && begin.offset == 1 && !begin.orEqual &&
+	       begin.getKey() == keyAfter(lastKey);
+}
+
+Future<RangeResult> Transaction::getRangeWithPrefetch(KeySelector begin,
+                                                      KeySelector end,
+                                                      GetRangeLimits limits,
+                                                      Snapshot snapshot,
+                                                      Reverse reverse) {
+	if (begin.orEqual) {
+		begin.removeOrEqual(begin.arena());
+	}
+	if (end.orEqual) {
+		end.removeOrEqual(end.arena());
+	}
+
+	bool continuesScan = continuesLastRangeRead(begin, end, snapshot, reverse);
+	Future<RangeResult> result;
+	if (continuesScan && !rangePrefetches.empty() && limitsCover(limits, rangePrefetches.front().limits)) {
+		CODE_PROBE(true, "Range read served by prefetch");
+		RangeRead prefetched = std::move(rangePrefetches.front());
+		rangePrefetches.pop_front();
+		++trState->cx->transactionLogicalReads;
+		++trState->cx->transactionRangePrefetchHits;
+
+		// Read further ahead while the caller still has to wait for prefetched reads, and less far once the caller
+		// finds the next two batches already there
+		if (!prefetched.result.isReady()) {
+			rangePrefetchDepth = std::min(rangePrefetchDepth + 1, CLIENT_KNOBS->RANGE_PREFETCH_MAX_DEPTH);
+		} else if (!rangePrefetches.empty() && rangePrefetches.front().result.isReady()) {
+			rangePrefetchDepth = std::max(rangePrefetchDepth - 1, 1);
+		}
+		if (!snapshot) {
+			extraConflictRanges.push_back(prefetched.conflictRange.getFuture());
+		}
+		result = prefetched.result;
+	} else {
+		CODE_PROBE(!rangePrefetches.empty(), "Range prefetches discarded");
+		rangePrefetches.clear();
+		result = getRangeInternal<GetKeyValuesRequest, GetKeyValuesReply, RangeResult>(
+		    begin, end, ""_sr, limits, snapshot, reverse);
+	}
+
+	lastRangeRead = RangeRead{ result, reverse ? begin : end, limits, snapshot, reverse };
+
+	// Only a read continuing the one before it starts prefetching, so that single range reads are not followed by
+	// reads nobody asks for
+	if (continuesScan) {
+		int depth = rangePrefetchDepth;
+		if (limits.hasByteLimit() && limits.bytes > 0) {
+			int64_t byteDepth = std::max<int64_t>(1, CLIENT_KNOBS->RANGE_PREFETCH_MAX_BYTES / limits.bytes);
+			depth = std::min<int64_t>(depth, byteDepth);
+		} else {
+			depth = 1;
+		}
+		while (rangePrefetches.size() < static_cast<size_t>(depth)) {
+			Future<RangeResult> previous = rangePrefetches.empty() ? result : rangePrefetches.back().result;
+			RangeRead prefetch{ Future<RangeResult>(), lastRangeRead.fixedSelector, limits, snapshot, reverse };
+			prefetch.result = prefetchRangeContinuation(
+			    trState, previous, prefetch.fixedSelector, limits, prefetch.conflictRange, snapshot, reverse);
+			rangePrefetches.push_back(std::move(prefetch));
+		}
+	}
+	return result;
+}
+
 Future<RangeResult> Transaction::getRange(const KeySelector& begin,
                                           const KeySelector& end,
                                           GetRangeLimits limits,
                                           Snapshot snapshot,
                                           Reverse reverse) {
+	if (CLIENT_KNOBS->ENABLE_RANGE_PREFETCH && limits.isValid() && !limits.isReached()) {
+		return getRangeWithPrefetch(begin, end, limits, snapshot, reverse);
+	}
 	return getRangeInternal<GetKeyValuesRequest, GetKeyValuesReply, RangeResult>(
 	    begin, end, ""_sr, limits, snapshot, reverse);
 }
@@ -6241,6 +6405,8 @@ void Transaction::resetImpl(bool generateNewSpan) {
 	extraConflictRanges.clear();
 	commitResult = Promise<Void>();
 	committing = Future<Void>();
+	lastRangeRead = RangeRead();
+	rangePrefetches.clear();
 	cancelWatches();
 }
 
@@ -8026,7 +8192,10 @@ ACTOR Future<StorageMetrics> extractMetrics(Future<std::pair<Optional<StorageMet
 	return x.first.get();
 }
 
-ACTOR Future<Standalone<VectorRef<ReadHotRangeWithMetrics>>> getReadHotRanges(Database cx, KeyRange keys) {
+ACTOR Future<Standalone<VectorRef<ReadHotRangeWithMetrics>>> getReadHotRanges(Database cx,
+                                                                              KeyRange keys,
+                                                                              ReadHotSubRangeRequest::SplitType type,
+                                                                              int chunkCount) {
 	state Span span("NAPI:GetReadHotRanges"_loc);
 	loop {
 		int64_t shardLimit = 100; // Shard limit here does not really matter since this function is currently only used
@@ -8059,7 +8228,7 @@ ACTOR Future<Standalone<VectorRef<ReadHotRangeWithMetrics>>> getReadHotRanges(Da
 			for (int i = 0; i < nLocs; i++) {
 				partBegin = (i == 0) ? keys.begin : locations[i].range.begin;
 				partEnd = (i == nLocs - 1) ? keys.end : locations[i].range.end;
-				ReadHotSubRangeRequest req(KeyRangeRef(partBegin, partEnd));
+				ReadHotSubRangeRequest req(KeyRangeRef(partBegin, partEnd), type, chunkCount);
 				fReplies[i] = loadBalance(locations[i].locations->locations(),
 				                          &StorageServerInterface::getReadHotRanges,
 				                          req,
@@ -8070,15 +8239,14 @@ ACTOR Future<Standalone<VectorRef<ReadHotRangeWithMetrics>>> getReadHotRanges(Da
 
 			if (nLocs == 1) {
 				CODE_PROBE(true, "Single-shard read hot range request");
-				return fReplies[0].get().readHotRanges;
+				return fReplies[0].get().rangesFor(type);
 			} else {
 				CODE_PROBE(true, "Multi-shard read hot range request");
 				Standalone<VectorRef<ReadHotRangeWithMetrics>> results;
 				for (int i = 0; i < nLocs; i++) {
-					results.append(results.arena(),
-					               fReplies[i].get().readHotRanges.begin(),
-					               fReplies[i].get().readHotRanges.size());
-					results.arena().dependsOn(fReplies[i].get().readHotRanges.arena());
+					Standalone<VectorRef<ReadHotRangeWithMetrics>> ranges = fReplies[i].get().rangesFor(type);
+					results.append(results.arena(), ranges.begin(), ranges.size());
+					results.arena().dependsOn(ranges.arena());
 				}
 
 				return results;
@@ -8243,8 +8411,11 @@ ACTOR Future<Standalone<VectorRef<DDMetricsRef>>> waitDataDistributionMetricsLis
 	}
 }
 
-Future<Standalone<VectorRef<ReadHotRangeWithMetrics>>> DatabaseContext::getReadHotRanges(KeyRange const& keys) {
-	return ::getReadHotRanges(Database(Reference<DatabaseContext>::addRef(this)), keys);
+Future<Standalone<VectorRef<ReadHotRangeWithMetrics>>> DatabaseContext::getReadHotRanges(
+    KeyRange const& keys,
+    ReadHotSubRangeRequest::SplitType type,
+    int chunkCount) {
+	return ::getReadHotRanges(Database(Reference<DatabaseContext>::addRef(this)), keys, type, chunkCount);
 }
 
 ACTOR Future<Standalone<VectorRef<KeyRef>>> getRangeSplitPoints(Reference<TransactionState> trState,
@@ -11675,6 +11846,9 @@ getHotRangeMetricsActor(Reference<DatabaseContext> db, StorageServerInterface ss
 		           fs.getError().what(),
 		           ssi.address().toString());
 		return Standalone<VectorRef<ReadHotRangeWithMetrics>>();
+	} else if (req.type == ReadHotSubRangeRequest::SplitType::HOT_KEYS && !fs.get().hotKeys) {
+		fmt::print("Storage server {} does not track hot keys.\n", ssi.address().toString());
+		return Standalone<VectorRef<ReadHotRangeWithMetrics>>();
 	} else {
 		return fs.get().readHotRanges;
 	}
@@ -11731,3 +11905,57 @@ ACTOR Future<std::vector<std::pair<StorageServerInterface, ProcessClass>>> getSe
 }
 
 } // namespace NativeAPI
+
+TEST_CASE("/fdbclient/NativeAPI/prefetchRangeContinuation/emptyConflictRange") {
+	// None of these reach a storage server, so they don't need a transaction
+	state Reference<TransactionState> trState;
+	state Promise<std::pair<Key, Key>> conflictRange;
+	state RangeResult previous;
+	state RangeResult result;
+
+	// The scan ended with the previous batch
+	wait(store(result,
+	           prefetchRangeContinuation(trState,
+	                                     previous,
+	                                     firstGreaterOrEqual("z"_sr),
+	                                     GetRangeLimits(),
+	                                     conflictRange,
+	                                     Snapshot::False,
+	                                     Reverse::False)));
+	ASSERT(result.empty());
+	ASSERT(conflictRange.getFuture().isReady() && conflictRange.getFuture().get() == std::make_pair(Key(), Key()));
+
+	// The previous batch ended right before the end of the range
+	conflictRange = Promise<std::pair<Key, Key>>();
+	previous.push_back_deep(previous.arena(), KeyValueRef("a"_sr, "1"_sr));
+	previous.more = true;
+	wait(store(result,
+	           prefetchRangeContinuation(trState,
+	                                     previous,
+	                                     firstGreaterOrEqual(keyAfter("a"_sr)),
+	                                     GetRangeLimits(),
+	                                     conflictRange,
+	                                     Snapshot::False,
+	                                     Reverse::False)));
+	ASSERT(result.empty());
+	ASSERT(conflictRange.getFuture().isReady() && conflictRange.getFuture().get() == std::make_pair(Key(), Key()));
+
+	// The previous batch failed
+	conflictRange = Promise<std::pair<Key, Key>>();
+	try {
+		wait(store(result,
+		           prefetchRangeContinuation(trState,
+		                                     Future<RangeResult>(transaction_too_old()),
+		                                     firstGreaterOrEqual("z"_sr),
+		                                     GetRangeLimits(),
+		                                     conflictRange,
+		                                     Snapshot::False,
+		                                     Reverse::False)));
+		ASSERT(false);
+	} catch (Error& e) {
+		ASSERT(e.code() == error_code_transaction_too_old);
+	}
+	ASSERT(conflictRange.getFuture().isReady() && conflictRange.getFuture().get() == std::make_pair(Key(), Key()));
+
+	return Void();
+}
@@ -0,0 +1,192 @@
+/*
+ * PrefixCompressedKeyValues.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "fdbclient/PrefixCompressedKeyValues.h"
+#include "flow/UnitTest.h"
+
+#include <set>
+
+static int varintSize(uint32_t v) {
+	int size = 1;
+	while (v >= 0x80) {
+		v >>= 7;
+		++size;
+	}
+	return size;
+}
+
+static uint8_t* writeVarint(uint8_t* out, uint32_t v) {
+	while (v >= 0x80) {
+		*out++ = (uint8_t)(v | 0x80);
+		v >>= 7;
+	}
+	*out++ = (uint8_t)v;
+	return out;
+}
+
+// Reads a varint from the front of in and removes it
+static uint32_t readVarint(StringRef& in) {
+	uint32_t v = 0;
+	for (int i = 0; i < in.size() && i < 5; i++) {
+		const uint8_t b = in[i];
+		v |= (uint32_t)(b & 0x7f) << (7 * i);
+		if (!(b & 0x80)) {
+			in = in.substr(i + 1);
+			return v;
+		}
+	}
+	throw serialization_failed();
+}
+
+// Removes and returns the first length bytes of in
+static StringRef readBytes(StringRef& in, uint32_t length) {
+	if (length > in.size()) {
+		throw serialization_failed();
+	}
+	StringRef bytes = in.substr(0, length);
+	in = in.substr(length);
+	return bytes;
+}
+
+StringRef encodePrefixCompressed(VectorRef<KeyValueRef> const& kvs, Arena& arena) {
+	int64_t size = varintSize(kvs.size());
+	KeyRef prev;
+	for (const auto& kv : kvs) {
+		const int shared = commonPrefixLength(prev, kv.key);
+		size += varintSize(shared) + varintSize(kv.key.size() - shared) + kv.key.size() - shared +
+		        varintSize(kv.value.size()) + kv.value.size();
+		prev = kv.key;
+	}
+
+	uint8_t* begin = new (arena) uint8_t[size];
+	uint8_t* out = writeVarint(begin, kvs.size());
+	prev = KeyRef();
+	for (const auto& kv : kvs) {
+		const int shared = commonPrefixLength(prev, kv.key);
+		out = writeVarint(out, shared);
+		out = writeVarint(out, kv.key.size() - shared);
+		out = kv.key.substr(shared).copyTo(out);
+		out = writeVarint(out, kv.value.size());
+		out = kv.value.copyTo(out);
+		prev = kv.key;
+	}
+	ASSERT(out - begin == size);
+	return StringRef(begin, size);
+}
+
+int64_t uncompressedEncodedSize(VectorRef<KeyValueRef> const& kvs) {
+	// string_serialized_traits<KeyValueRef> writes a four byte length in front of each key and value
+	int64_t size = sizeof(uint32_t);
+	for (const auto& kv : kvs) {
+		size += 2 * sizeof(uint32_t) + kv.key.size() + kv.value.size();
+	}
+	return size;
+}
+
+VectorRef<KeyValueRef> decodePrefixCompressed(StringRef encoded, Arena& arena) {
+	PrefixCompressedKeyValuesIterator it(encoded);
+	VectorRef<KeyValueRef> kvs;
+	// Every pair takes at least three bytes, so a bogus count cannot make us allocate much more than encoded
+	if (it.count() < 0 || it.count() > encoded.size() / 3 + 1) {
+		throw serialization_failed();
+	}
+	kvs.reserve(arena, it.count());
+	while (it.next()) {
+		KeyValueRef kv = it.get();
+		kvs.push_back(arena, KeyValueRef(StringRef(arena, kv.key), kv.value));
+	}
+	return kvs;
+}
+
+PrefixCompressedKeyValuesIterator::PrefixCompressedKeyValuesIterator(StringRef encoded)
+  : remaining(encoded), visited(0) {
+	total = readVarint(remaining);
+}
+
+bool PrefixCompressedKeyValuesIterator::next() {
+	if (visited == total) {
+		return false;
+	}
+	const uint32_t shared = readVarint(remaining);
+	if (shared > key.size()) {
+		throw serialization_failed();
+	}
+	const uint32_t suffixLength = readVarint(remaining);
+	StringRef suffix = readBytes(remaining, suffixLength);
+	key.resize(shared);
+	key.insert(key.end(), suffix.begin(), suffix.end());
+	const uint32_t valueLength = readVarint(remaining);
+	value = readBytes(remaining, valueLength);
+	++visited;
+	return true;
+}
+
+TEST_CASE("/fdbclient/PrefixCompressedKeyValues/roundTrip") {
+	for (int i = 0; i < 100; i++) {
+		Arena arena;
+		std::set<std::string> keys;
+		const std::string prefix = deterministicRandom()->randomAlphaNumeric(deterministicRandom()->randomInt(0, 20));
+		const int count = deterministicRandom()->randomInt(0, 100);
+		for (int j = 0; j < count; j++) {
+			// Few distinct characters so that neighbouring keys share prefixes of varying length, long keys and
+			// values so that lengths take more than one varint byte
+			std::string key = prefix;
+			const int length = deterministicRandom()->randomInt(0, deterministicRandom()->coinflip() ? 8 : 300);
+			for (int k = 0; k < length; k++) {
+				key.push_back('a' + deterministicRandom()->randomInt(0, 3));
+			}
+			keys.insert(key);
+		}
+		VectorRef<KeyValueRef> kvs;
+		for (const auto& key : keys) {
+			const int valueLength = deterministicRandom()->randomInt(0, deterministicRandom()->coinflip() ? 10 : 500);
+			kvs.push_back(arena,
+			              KeyValueRef(StringRef(arena, key),
+			                          StringRef(arena, deterministicRandom()->randomAlphaNumeric(valueLength))));
+		}
+
+		StringRef encoded = encodePrefixCompressed(kvs, arena);
+		if (prefix.size() >= 10 && kvs.size() >= 10) {
+			ASSERT(encoded.size() < uncompressedEncodedSize(kvs));
+		}
+
+		VectorRef<KeyValueRef> decoded = decodePrefixCompressed(encoded, arena);
+		ASSERT(decoded.size() == kvs.size());
+		PrefixCompressedKeyValuesIterator it(encoded);
+		ASSERT(it.count() == kvs.size());
+		for (int j = 0; j < kvs.size(); j++) {
+			ASSERT(decoded[j] == kvs[j]);
+			ASSERT(it.next());
+			ASSERT(it.get() == kvs[j]);
+		}
+		ASSERT(!it.next());
+
+		// A truncated encoding is rejected rather than read past its end
+		if (encoded.size() > 1) {
+			try {
+				decodePrefixCompressed(encoded.substr(0, deterministicRandom()->randomInt(1, encoded.size())), arena);
+				ASSERT(false);
+			} catch (Error& e) {
+				ASSERT(e.code() == error_code_serialization_failed);
+			}
+		}
+	}
+	return Void();
+}
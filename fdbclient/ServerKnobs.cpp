@@ -86,9 +86,15 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( TLOG_SPILL_REFERENCE_MAX_PEEK_MEMORY_BYTES,            2e9 ); if ( randomize && BUGGIFY ) TLOG_SPILL_REFERENCE_MAX_PEEK_MEMORY_BYTES = 2e6;
 	init( TLOG_SPILL_REFERENCE_MAX_BATCHES_PER_PEEK,           100 ); if ( randomize && BUGGIFY ) TLOG_SPILL_REFERENCE_MAX_BATCHES_PER_PEEK = 1;
 	init( TLOG_SPILL_REFERENCE_MAX_BYTES_PER_BATCH,           16<<10 ); if ( randomize && BUGGIFY ) TLOG_SPILL_REFERENCE_MAX_BYTES_PER_BATCH = 500;
+	init( ENABLE_TLOG_SPILL_COMPACTION,                        false ); if ( randomize && BUGGIFY ) ENABLE_TLOG_SPILL_COMPACTION = deterministicRandom()->coinflip();
+	init( TLOG_SPILL_COMPACTION_MIN_BATCHES,                      16 ); if ( randomize && BUGGIFY ) TLOG_SPILL_COMPACTION_MIN_BATCHES = deterministicRandom()->randomInt(1, 20);
+	init( TLOG_SPILL_COMPACTION_SEGMENT_BYTES,                   1e6 ); if ( randomize && BUGGIFY ) TLOG_SPILL_COMPACTION_SEGMENT_BYTES = deterministicRandom()->randomInt(1000, 1e6);
+	init( TLOG_SPILL_COMPACTION_MAX_SEGMENTS_PER_PEEK,            10 ); if ( randomize && BUGGIFY ) TLOG_SPILL_COMPACTION_MAX_SEGMENTS_PER_PEEK = 1;
+	init( TLOG_SPILL_COMPACTION_FILTER,                       "ZSTD" ); if ( randomize && BUGGIFY ) TLOG_SPILL_COMPACTION_FILTER = CompressionUtils::toString(CompressionUtils::getRandomFilter());
 	init( DISK_QUEUE_FILE_EXTENSION_BYTES,                    10<<20 ); // BUGGIFYd per file within the DiskQueue
 	init( DISK_QUEUE_FILE_SHRINK_BYTES,                      100<<20 ); // BUGGIFYd per file within the DiskQueue
 	init( DISK_QUEUE_MAX_TRUNCATE_BYTES,                     2LL<<30 ); if ( randomize && BUGGIFY ) DISK_QUEUE_MAX_TRUNCATE_BYTES = 0;
+	init( DISK_QUEUE_RECOVERY_READ_AHEAD_CHUNKS,                   8 ); if ( randomize && BUGGIFY ) DISK_QUEUE_RECOVERY_READ_AHEAD_CHUNKS = deterministicRandom()->randomInt(1, 4);
 	init( TLOG_DEGRADED_DURATION,                                5.0 );
 	init( MAX_CACHE_VERSIONS,                                   10e6 );
 	init( TLOG_IGNORE_POP_AUTO_ENABLE_DELAY,                   300.0 );
@@ -145,6 +151,11 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( RELOCATION_PARALLELISM_PER_SOURCE_SERVER,                2 ); if( randomize && BUGGIFY ) RELOCATION_PARALLELISM_PER_SOURCE_SERVER = 1;
 	init( RELOCATION_PARALLELISM_PER_DEST_SERVER,                 10 ); if( randomize && BUGGIFY ) RELOCATION_PARALLELISM_PER_DEST_SERVER = 1; // Note: if this is smaller than FETCH_KEYS_PARALLELISM, this will artificially reduce performance. The current default of 10 is probably too high but is set conservatively for now.
 	init( MERGE_RELOCATION_PARALLELISM_PER_TEAM,                   6 ); if (randomize && BUGGIFY ) MERGE_RELOCATION_PARALLELISM_PER_TEAM = 1;
+	init( DD_BANDWIDTH_AWARE_RELOCATION,                       false ); if( randomize && BUGGIFY ) DD_BANDWIDTH_AWARE_RELOCATION = true;
+	init( DD_DEST_BANDWIDTH_INITIAL_BYTES_PER_SECOND,          100e6 ); if( randomize && BUGGIFY ) DD_DEST_BANDWIDTH_INITIAL_BYTES_PER_SECOND = 1e6;
+	init( DD_DEST_BANDWIDTH_WINDOW,                             30.0 ); if( randomize && BUGGIFY ) DD_DEST_BANDWIDTH_WINDOW = 1.0;
+	init( DD_DEST_BANDWIDTH_SMOOTHING,                          0.25 );
+	init( DD_REBALANCE_DEST_BANDWIDTH_FRACTION,                  0.5 ); if( randomize && BUGGIFY ) DD_REBALANCE_DEST_BANDWIDTH_FRACTION = 0.1;
 	init( DD_QUEUE_MAX_KEY_SERVERS,                              100 ); // Do not buggify
 	init( DD_REBALANCE_PARALLELISM,                               50 );
 	init( DD_REBALANCE_RESET_AMOUNT,                              30 );
@@ -465,6 +476,8 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 
 	// KeyValueStoreMemory
 	init( REPLACE_CONTENTS_BYTES,                                1e5 );
+	init( MEMORY_KVS_SNAPSHOT_READ_RANGE_BYTES,                  1e6 ); if( randomize && BUGGIFY ) MEMORY_KVS_SNAPSHOT_READ_RANGE_BYTES = deterministicRandom()->coinflip() ? 0 : deterministicRandom()->randomInt(1, 1000);
+	init( MEMORY_KVS_SNAPSHOT_READ_THREADS,                        2 );
 
 	// KeyValueStoreRocksDB
 	init( ROCKSDB_SET_READ_TIMEOUT,         		    !isSimulated );
@@ -758,6 +771,7 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( BACKUP_FILE_BLOCK_BYTES,                       1024 * 1024 );
 	init( BACKUP_LOCK_BYTES,                                     3e9 ); if(randomize && BUGGIFY) BACKUP_LOCK_BYTES = deterministicRandom()->randomInt(1024, 4096) * 4096;
 	init( BACKUP_UPLOAD_DELAY,                                  10.0 ); if(randomize && BUGGIFY) BACKUP_UPLOAD_DELAY = deterministicRandom()->random01() * 60;
+	init( BACKUP_MAX_PENDING_UPLOAD_BYTES,                       5e8 ); if(randomize && BUGGIFY) BACKUP_MAX_PENDING_UPLOAD_BYTES = deterministicRandom()->coinflip() ? 0 : deterministicRandom()->randomInt(1, 1e6);
 
 	//Cluster Controller
 	init( CLUSTER_CONTROLLER_LOGGING_DELAY,                      5.0 );
@@ -992,10 +1006,23 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( EMPTY_READ_PENALTY,                                   20 ); // 20 bytes
 	init( DD_SHARD_COMPARE_LIMIT,                               1000 );
 	init( READ_SAMPLING_ENABLED,                                false ); if ( randomize && BUGGIFY ) READ_SAMPLING_ENABLED = true;// enable/disable read sampling
+	init( READ_HOT_SKETCH_WIDTH,                                 4096 ); if ( randomize && BUGGIFY ) READ_HOT_SKETCH_WIDTH = 64;
+	init( READ_HOT_SKETCH_DEPTH,                                    4 ); if ( randomize && BUGGIFY ) READ_HOT_SKETCH_DEPTH = 1;
+	init( READ_HOT_SKETCH_KEYS,                                    64 ); if ( randomize && BUGGIFY ) READ_HOT_SKETCH_KEYS = 4;
+	init( READ_HOT_SKETCH_MERGE_BYTES,                        1000000 ); // merge hot keys with less than 1MB of data between them into one range
+	init( DD_SPLIT_READ_HOT_KEY_RANGES,                          true );
+	init( DD_READ_HOT_KEY_RANGE_MIN_FRACTION,                     0.2 ); if ( randomize && BUGGIFY ) DD_READ_HOT_KEY_RANGE_MIN_FRACTION = 0.01;
 	init( DD_PREFER_LOW_READ_UTIL_TEAM,                          true );
 	init( DD_TRACE_MOVE_BYTES_AVERAGE_INTERVAL,                   120);
 	init( MOVING_WINDOW_SAMPLE_SIZE,                         10000000); // 10MB
 
+	//Storage Cache
+	init( STORAGE_CACHE_ADMISSION_CONTROL,                      false ); if ( randomize && BUGGIFY ) STORAGE_CACHE_ADMISSION_CONTROL = true;
+	init( STORAGE_CACHE_ADMISSION_READS,                          200 ); if ( randomize && BUGGIFY ) STORAGE_CACHE_ADMISSION_READS = deterministicRandom()->randomInt(1, 10);
+	init( STORAGE_CACHE_MEMORY_BUDGET,                          1e9 ); if ( randomize && BUGGIFY ) STORAGE_CACHE_MEMORY_BUDGET = 1e4;
+	init( STORAGE_CACHE_ADMISSION_ESTIMATE_BYTES,                1000 ); if ( randomize && BUGGIFY ) STORAGE_CACHE_ADMISSION_ESTIMATE_BYTES = deterministicRandom()->coinflip() ? 1 : 100000;
+	init( STORAGE_CACHE_EVICTION_INTERVAL,                        5.0 ); if ( randomize && BUGGIFY ) STORAGE_CACHE_EVICTION_INTERVAL = 0.5;
+
 	//Storage Server
 	init( STORAGE_LOGGING_DELAY,                                 5.0 );
 	init( STORAGE_SERVER_POLL_METRICS_DELAY,                     1.0 );
@@ -1058,6 +1085,7 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( BYTE_SAMPLE_LOAD_PARALLELISM,                            8 ); if( randomize && BUGGIFY ) BYTE_SAMPLE_LOAD_PARALLELISM = 1;
 	init( BYTE_SAMPLE_LOAD_DELAY,                                0.0 ); if( randomize && BUGGIFY ) BYTE_SAMPLE_LOAD_DELAY = 0.1;
 	init( BYTE_SAMPLE_START_DELAY,                               1.0 ); if( randomize && BUGGIFY ) BYTE_SAMPLE_START_DELAY = 0.0;
+	init( BYTE_SAMPLE_RESTORE_BLOCK_BYTES,                      4096 ); if( randomize && BUGGIFY ) BYTE_SAMPLE_RESTORE_BLOCK_BYTES = deterministicRandom()->coinflip() ? 0 : 64;
 	init( BEHIND_CHECK_DELAY,                                    2.0 );
 	init( BEHIND_CHECK_COUNT,                                      2 );
 	init( BEHIND_CHECK_VERSIONS,             5 * VERSIONS_PER_SECOND );
@@ -1157,6 +1185,8 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	// Status
 	init( STATUS_MIN_TIME_BETWEEN_REQUESTS,                      0.0 );
 	init( MAX_STATUS_REQUESTS_PER_SECOND,                      256.0 );
+	init( STATUS_MAX_STALENESS,                                  0.0 ); if( randomize && BUGGIFY ) STATUS_MAX_STALENESS = deterministicRandom()->random01() * 2;
+	init( STATUS_WORKER_METRICS_MAX_STALENESS,                   0.0 ); if( randomize && BUGGIFY ) STATUS_WORKER_METRICS_MAX_STALENESS = deterministicRandom()->random01() * 5;
 	init( CONFIGURATION_ROWS_TO_FETCH,                         20000 );
 	init( DISABLE_DUPLICATE_LOG_WARNING,                       false );
 	init( HISTOGRAM_REPORT_INTERVAL,                           300.0 );
@@ -1211,6 +1241,9 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( FASTRESTORE_WRITE_BW_MB,                                70 ); if( randomize && BUGGIFY ) { FASTRESTORE_WRITE_BW_MB = deterministicRandom()->random01() < 0.5 ? 2 : 100;}
 	init( FASTRESTORE_RATE_UPDATE_SECONDS,                       1.0 ); if( randomize && BUGGIFY ) { FASTRESTORE_RATE_UPDATE_SECONDS = deterministicRandom()->random01() < 0.5 ? 0.1 : 2;}
 	init( FASTRESTORE_DUMP_INSERT_RANGE_VERSION,               false );
+	init( FASTRESTORE_APPLIER_BULKLOAD_FOLDER,                    "" ); if( randomize && BUGGIFY ) { FASTRESTORE_APPLIER_BULKLOAD_FOLDER = "fastRestoreBulkLoad";} // Simulated processes share one file system
+	init( FASTRESTORE_APPLIER_BULKLOAD_MIN_BYTES,           10485760 ); if( randomize && BUGGIFY ) { FASTRESTORE_APPLIER_BULKLOAD_MIN_BYTES = deterministicRandom()->randomInt(1, 1e6);}
+	init( FASTRESTORE_APPLIER_BULKLOAD_POLL_SECONDS,             1.0 ); if( randomize && BUGGIFY ) { FASTRESTORE_APPLIER_BULKLOAD_POLL_SECONDS = deterministicRandom()->random01() * 5 + 0.1;}
 
 	init( REDWOOD_DEFAULT_PAGE_SIZE,                            8192 );
 	init( REDWOOD_DEFAULT_EXTENT_SIZE,              32 * 1024 * 1024 );
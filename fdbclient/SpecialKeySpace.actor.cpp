@@ -321,13 +321,18 @@ ACTOR Future<RangeResult> SpecialKeySpace::getRangeAggregationActor(SpecialKeySp
 	// KeySelector, GetRangeLimits and reverse are all handled here
 	state RangeResult result;
 	state RangeResult pairs;
-	state RangeMap<Key, SpecialKeyRangeReadImpl*, KeyRangeRef>::iterator iter;
 	state int actualBeginOffset;
 	state int actualEndOffset;
 	state KeyRangeRef moduleBoundary;
 	// used to cache results from potential first async read
 	// the current implementation will read the whole range result to save in the cache
 	state KeyRangeMap<Optional<RangeResult>> cache(Optional<RangeResult>(), specialKeys.end);
+	// the registered ranges the read spans with the part of each to read, and the reads started so far
+	state std::vector<std::pair<const SpecialKeyRangeReadImpl*, KeyRange>> moduleReads;
+	state std::vector<Future<RangeResult>> moduleResults;
+	state int moduleIdx;
+	// number of ranges after the current one whose reads are started before waiting for it
+	state int readAhead = 0;
 
 	if (ryw->specialKeySpaceRelaxed()) {
 		moduleBoundary = sks->range;
@@ -379,72 +384,101 @@ ACTOR Future<RangeResult> SpecialKeySpace::getRangeAggregationActor(SpecialKeySp
 		}
 	}
 
-	// TODO : workaround to write this two together to make the code compact
-	// The issue here is boost::iterator_range<> doest not provide rbegin(), rend()
-	iter = reverse ? ranges.end() : ranges.begin();
+	// Registered ranges the read spans, in the order their results are returned
+	for (auto iter : ranges) {
+		if (iter->value() == nullptr)
+			continue;
+		KeyRangeRef kr = iter->range();
+		KeyRef keyStart = kr.contains(begin.getKey()) ? begin.getKey() : kr.begin;
+		KeyRef keyEnd = kr.contains(end.getKey()) ? end.getKey() : kr.end;
+		moduleReads.emplace_back(iter->value(), KeyRangeRef(keyStart, keyEnd));
+	}
 	if (reverse) {
-		while (iter != ranges.begin()) {
-			--iter;
-			if (iter->value() == nullptr)
-				continue;
-			KeyRangeRef kr = iter->range();
-			KeyRef keyStart = kr.contains(begin.getKey()) ? begin.getKey() : kr.begin;
-			KeyRef keyEnd = kr.contains(end.getKey()) ? end.getKey() : kr.end;
-			if (iter->value()->isAsync() && cache.rangeContaining(keyStart).value().present()) {
-				const SpecialKeyRangeAsyncImpl* ptr = dynamic_cast<const SpecialKeyRangeAsyncImpl*>(iter->value());
-				RangeResult pairs_ = wait(ptr->getRange(ryw, KeyRangeRef(keyStart, keyEnd), limits, &cache));
-				pairs = pairs_;
-			} else {
-				RangeResult pairs_ = wait(iter->value()->getRange(ryw, KeyRangeRef(keyStart, keyEnd), limits));
-				pairs = pairs_;
-			}
-			result.arena().dependsOn(pairs.arena());
-			// limits handler
-			for (int i = pairs.size() - 1; i >= 0; --i) {
-				ASSERT(iter->range().contains(pairs[i].key));
-				result.push_back(result.arena(), pairs[i]);
-				// Note : behavior here is even the last k-v pair makes total bytes larger than specified, it's still
-				// returned. In other words, the total size of the returned value (less the last entry) will be less
-				// than byteLimit
-				limits.decrement(pairs[i]);
-				if (limits.isReached()) {
-					result.more = true;
+		std::reverse(moduleReads.begin(), moduleReads.end());
+	}
+	// Ranges are independent of each other, so reads of the ranges after the current one are started before waiting
+	// for it. Without limits every range is read anyway, so all of them are started. With limits the read may stop
+	// after any range, so only the next one is read ahead to avoid computing results that are then thrown away.
+	if (CLIENT_KNOBS->SPECIAL_KEY_SPACE_PARALLEL_READS) {
+		readAhead = limits.hasRowLimit() || limits.hasByteLimit() ? 1 : moduleReads.size();
+		CODE_PROBE(moduleReads.size() > 1, "Special key modules read in parallel");
+		CODE_PROBE(moduleReads.size() > 2 && readAhead == 1, "Special key module reads ahead limited by read limits");
+	}
+
+	for (moduleIdx = 0; moduleIdx < moduleReads.size(); ++moduleIdx) {
+		while (moduleResults.size() < std::min<size_t>(moduleReads.size(), moduleIdx + 1 + readAhead)) {
+			const auto& read = moduleReads[moduleResults.size()];
+			moduleResults.push_back(readModule(sks, ryw, read.first, read.second, limits, &cache));
+		}
+		RangeResult pairs_ = wait(moduleResults[moduleIdx]);
+		pairs = pairs_;
+		result.arena().dependsOn(pairs.arena());
+		// limits handler
+		for (int i = 0; i < pairs.size(); ++i) {
+			const KeyValueRef& kv = pairs[reverse ? pairs.size() - 1 - i : i];
+			ASSERT(moduleReads[moduleIdx].first->getKeyRange().contains(kv.key));
+			result.push_back(result.arena(), kv);
+			// Note : behavior here is even the last k-v pair makes total bytes larger than specified, it's still
+			// returned. In other words, the total size of the returned value (less the last entry) will be less
+			// than byteLimit
+			limits.decrement(kv);
+			if (limits.isReached()) {
+				result.more = true;
+				if (reverse) {
 					result.readToBegin = false;
-					return result;
-				};
+				} else {
+					result.readThroughEnd = false;
+				}
+				return result;
+			};
+		}
+	}
+	return result;
+}
+
+ACTOR Future<RangeResult> SpecialKeySpace::readModule(SpecialKeySpace* sks,
+                                                      ReadYourWritesTransaction* ryw,
+                                                      const SpecialKeyRangeReadImpl* impl,
+                                                      KeyRange kr,
+                                                      GetRangeLimits limits,
+                                                      KeyRangeMap<Optional<RangeResult>>* cache) {
+	state double ttl = impl->cacheTTL();
+	state std::tuple<const SpecialKeyRangeReadImpl*, Key, Key> cacheKey(impl, kr.begin, kr.end);
+	state DatabaseContext* cx = ryw->getDatabase().getPtr();
+	state double startTime = now();
+	state RangeResult result;
+
+	if (ttl > 0) {
+		auto cached = sks->readCache.find(cacheKey);
+		if (cached != sks->readCache.end() && now() < cached->second.expiresAt) {
+			CODE_PROBE(true, "Special key module read served from cache");
+			if (cx) {
+				++cx->transactionSpecialKeyModuleCacheHits;
 			}
+			return cached->second.result;
 		}
+		// The cached result is shared by reads with any limits
+		limits = GetRangeLimits();
+	}
+
+	if (impl->isAsync() && cache->rangeContaining(kr.begin).value().present()) {
+		const SpecialKeyRangeAsyncImpl* ptr = dynamic_cast<const SpecialKeyRangeAsyncImpl*>(impl);
+		RangeResult result_ = wait(ptr->getRange(ryw, kr, limits, cache));
+		result = result_;
 	} else {
-		for (iter = ranges.begin(); iter != ranges.end(); ++iter) {
-			if (iter->value() == nullptr)
-				continue;
-			KeyRangeRef kr = iter->range();
-			KeyRef keyStart = kr.contains(begin.getKey()) ? begin.getKey() : kr.begin;
-			KeyRef keyEnd = kr.contains(end.getKey()) ? end.getKey() : kr.end;
-			if (iter->value()->isAsync() && cache.rangeContaining(keyStart).value().present()) {
-				const SpecialKeyRangeAsyncImpl* ptr = dynamic_cast<const SpecialKeyRangeAsyncImpl*>(iter->value());
-				RangeResult pairs_ = wait(ptr->getRange(ryw, KeyRangeRef(keyStart, keyEnd), limits, &cache));
-				pairs = pairs_;
-			} else {
-				RangeResult pairs_ = wait(iter->value()->getRange(ryw, KeyRangeRef(keyStart, keyEnd), limits));
-				pairs = pairs_;
-			}
-			result.arena().dependsOn(pairs.arena());
-			// limits handler
-			for (int i = 0; i < pairs.size(); ++i) {
-				ASSERT(iter->range().contains(pairs[i].key));
-				result.push_back(result.arena(), pairs[i]);
-				// Note : behavior here is even the last k-v pair makes total bytes larger than specified, it's still
-				// returned. In other words, the total size of the returned value (less the last entry) will be less
-				// than byteLimit
-				limits.decrement(pairs[i]);
-				if (limits.isReached()) {
-					result.more = true;
-					result.readThroughEnd = false;
-					return result;
-				};
-			}
+		RangeResult result_ = wait(impl->getRange(ryw, kr, limits));
+		result = result_;
+	}
+
+	if (cx) {
+		++cx->transactionSpecialKeyModuleReads;
+		cx->transactionSpecialKeyModuleReadMicroseconds += (int64_t)((now() - startTime) * 1e6);
+	}
+	if (ttl > 0) {
+		for (auto it = sks->readCache.begin(); it != sks->readCache.end();) {
+			it = now() < it->second.expiresAt ? std::next(it) : sks->readCache.erase(it);
 		}
+		sks->readCache[cacheKey] = CachedRead{ now() + ttl, result };
 	}
 	return result;
 }
@@ -775,6 +809,10 @@ Future<RangeResult> DDStatsRangeImpl::getRange(ReadYourWritesTransaction* ryw,
 	return ddMetricsGetRangeActor(ryw, kr);
 }
 
+double DDStatsRangeImpl::cacheTTL() const {
+	return CLIENT_KNOBS->SPECIAL_KEY_SPACE_CACHE_TTL;
+}
+
 Key SpecialKeySpace::getManagementApiCommandOptionSpecialKey(const std::string& command, const std::string& option) {
 	Key prefix = "options/"_sr.withPrefix(moduleToBoundary[MODULE::MANAGEMENT].begin);
 	auto pair = command + "/" + option;
@@ -3005,6 +3043,10 @@ Future<RangeResult> WorkerInterfacesSpecialKeyImpl::getRange(ReadYourWritesTrans
 	return workerInterfacesImplGetRangeActor(ryw, getKeyRange().begin, kr);
 }
 
+double WorkerInterfacesSpecialKeyImpl::cacheTTL() const {
+	return CLIENT_KNOBS->SPECIAL_KEY_SPACE_CACHE_TTL;
+}
+
 ACTOR Future<Optional<Value>> getJSON(Database db, std::string jsonField = "");
 
 ACTOR static Future<RangeResult> FaultToleranceMetricsImplActor(ReadYourWritesTransaction* ryw, KeyRangeRef kr) {
@@ -3028,6 +3070,10 @@ Future<RangeResult> FaultToleranceMetricsImpl::getRange(ReadYourWritesTransactio
 	return FaultToleranceMetricsImplActor(ryw, kr);
 }
 
+double FaultToleranceMetricsImpl::cacheTTL() const {
+	return CLIENT_KNOBS->SPECIAL_KEY_SPACE_CACHE_TTL;
+}
+
 ACTOR Future<Void> validateSpecialSubrangeRead(ReadYourWritesTransaction* ryw,
                                                KeySelector begin,
                                                KeySelector end,
@@ -3109,3 +3155,90 @@ ACTOR Future<Void> validateSpecialSubrangeRead(ReadYourWritesTransaction* ryw,
 	}
 	return Void();
 }
+
+namespace {
+
+// A module of a test-only key space with the keys <begin>1 and <begin>2, whose values are the number of the read that
+// returned them
+class SKSCTestCountingReadImpl : public SpecialKeyRangeReadImpl {
+public:
+	SKSCTestCountingReadImpl(KeyRangeRef kr, double ttl) : SpecialKeyRangeReadImpl(kr), ttl(ttl) {}
+
+	Future<RangeResult> getRange(ReadYourWritesTransaction* ryw,
+	                             KeyRangeRef kr,
+	                             GetRangeLimits limitsHint) const override {
+		++reads;
+		RangeResult result;
+		for (auto suffix : { "1"_sr, "2"_sr }) {
+			Key key = range.begin.withSuffix(suffix);
+			if (kr.contains(key)) {
+				result.push_back_deep(result.arena(), KeyValueRef(key, StringRef(std::to_string(reads))));
+			}
+		}
+		return result;
+	}
+
+	double cacheTTL() const override { return ttl; }
+
+	mutable int reads = 0;
+
+private:
+	double ttl;
+};
+
+Future<RangeResult> readTestKeys(SpecialKeySpace* sks,
+                                 ReadYourWritesTransaction* ryw,
+                                 KeyRef begin,
+                                 KeyRef end,
+                                 GetRangeLimits limits,
+                                 Reverse reverse) {
+	return sks->getRange(
+	    ryw, KeySelector(firstGreaterOrEqual(begin)), KeySelector(firstGreaterOrEqual(end)), limits, reverse);
+}
+
+} // namespace
+
+TEST_CASE("/fdbclient/SpecialKeySpace/moduleReads") {
+	state Database cx = DatabaseContext::create(
+	    makeReference<AsyncVar<ClientDBInfo>>(), Never(), LocalityData(), EnableLocalityLoadBalance::False);
+	state ReadYourWritesTransaction ryw(cx);
+	state SpecialKeySpace sks;
+	state SKSCTestCountingReadImpl a(KeyRangeRef("a/"_sr, "a0"_sr), 0);
+	state SKSCTestCountingReadImpl b(KeyRangeRef("b/"_sr, "b0"_sr), 0);
+	state SKSCTestCountingReadImpl c(KeyRangeRef("c/"_sr, "c0"_sr), 0);
+	state SKSCTestCountingReadImpl cached(KeyRangeRef("d/"_sr, "d0"_sr), 0.5);
+	for (auto impl : { &a, &b, &c, &cached }) {
+		sks.registerKeyRange(
+		    SpecialKeySpace::MODULE::TESTONLY, SpecialKeySpace::IMPLTYPE::READONLY, impl->getKeyRange(), impl);
+	}
+	state RangeResult result;
+	state RangeResult firstCached;
+	state std::vector<Key> descending = { "c/2"_sr, "c/1"_sr, "b/2"_sr, "b/1"_sr, "a/2"_sr, "a/1"_sr };
+
+	// A read whose limit is reached in the first module never starts reading the third one
+	wait(store(result, readTestKeys(&sks, &ryw, "a/"_sr, "c0"_sr, GetRangeLimits(2), Reverse::False)));
+	ASSERT(result.size() == 2 && result[0].key == "a/1"_sr && result[1].key == "a/2"_sr && result.more);
+	ASSERT(a.reads == 1 && b.reads <= 1 && c.reads == 0);
+
+	// Reverse reads return the keys of all modules in descending order, with and without a limit
+	wait(store(result, readTestKeys(&sks, &ryw, "a/"_sr, "c0"_sr, GetRangeLimits(), Reverse::True)));
+	ASSERT(result.size() == descending.size());
+	for (int i = 0; i < result.size(); i++) {
+		ASSERT(result[i].key == descending[i]);
+	}
+	wait(store(result, readTestKeys(&sks, &ryw, "a/"_sr, "c0"_sr, GetRangeLimits(3), Reverse::True)));
+	ASSERT(result.size() == 3 && result.more);
+	for (int i = 0; i < result.size(); i++) {
+		ASSERT(result[i].key == descending[i]);
+	}
+
+	// A module with a TTL is read once within the TTL, and again after it expires
+	wait(store(firstCached, readTestKeys(&sks, &ryw, "d/"_sr, "d0"_sr, GetRangeLimits(), Reverse::False)));
+	wait(store(result, readTestKeys(&sks, &ryw, "d/"_sr, "d0"_sr, GetRangeLimits(), Reverse::False)));
+	ASSERT(cached.reads == 1 && result.size() == 2 && result == firstCached);
+	wait(delay(cached.cacheTTL() + 0.1));
+	wait(store(result, readTestKeys(&sks, &ryw, "d/"_sr, "d0"_sr, GetRangeLimits(), Reverse::False)));
+	ASSERT(cached.reads == 2 && result.size() == 2 && result[0].value == "2"_sr);
+
+	return Void();
+}
@@ -400,23 +400,23 @@ ThreadSafeTransaction::ThreadSafeTransaction(ReadYourWritesTransaction* ryw)
 }
 
 ThreadSafeTransaction::~ThreadSafeTransaction() {
-	ISingleThreadTransaction* tr = this->tr;
+	ISingleThreadTransaction* tr = endWriteBatch();
 	if (tr)
 		onMainThreadVoid([tr]() { tr->delref(); });
 }
 
 void ThreadSafeTransaction::cancel() {
-	ISingleThreadTransaction* tr = this->tr;
+	ISingleThreadTransaction* tr = endWriteBatch();
 	onMainThreadVoid([tr]() { tr->cancel(); });
 }
 
 void ThreadSafeTransaction::setVersion(Version v) {
-	ISingleThreadTransaction* tr = this->tr;
+	ISingleThreadTransaction* tr = endWriteBatch();
 	onMainThreadVoid([tr, v]() { tr->setVersion(v); }, tr, &ISingleThreadTransaction::deferredError);
 }
 
 ThreadFuture<Version> ThreadSafeTransaction::getReadVersion() {
-	ISingleThreadTransaction* tr = this->tr;
+	ISingleThreadTransaction* tr = endWriteBatch();
 	return onMainThread([tr]() -> Future<Version> {
 		tr->checkDeferredError();
 		return tr->getReadVersion();
@@ -426,7 +426,7 @@ ThreadFuture<Version> ThreadSafeTransaction::getReadVersion() {
 ThreadFuture<Optional<Value>> ThreadSafeTransaction::get(const KeyRef& key, bool snapshot) {
 	Key k = key;
 
-	ISingleThreadTransaction* tr = this->tr;
+	ISingleThreadTransaction* tr = endWriteBatch();
 	return onMainThread([tr, k, snapshot]() -> Future<Optional<Value>> {
 		tr->checkDeferredError();
 		return tr->get(k, Snapshot{ snapshot });
@@ -436,7 +436,7 @@ ThreadFuture<Optional<Value>> ThreadSafeTransaction::get(const KeyRef& key, bool
 ThreadFuture<Key> ThreadSafeTransaction::getKey(const KeySelectorRef& key, bool snapshot) {
 	KeySelector k = key;
 
-	ISingleThreadTransaction* tr = this->tr;
+	ISingleThreadTransaction* tr = endWriteBatch();
 	return onMainThread([tr, k, snapshot]() -> Future<Key> {
 		tr->checkDeferredError();
 		return tr->getKey(k, Snapshot{ snapshot });
@@ -446,7 +446,7 @@ ThreadFuture<Key> ThreadSafeTransaction::getKey(const KeySelectorRef& key, bool
 ThreadFuture<int64_t> ThreadSafeTransaction::getEstimatedRangeSizeBytes(const KeyRangeRef& keys) {
 	KeyRange r = keys;
 
-	ISingleThreadTransaction* tr = this->tr;
+	ISingleThreadTransaction* tr = endWriteBatch();
 	return onMainThread([tr, r]() -> Future<int64_t> {
 		tr->checkDeferredError();
 		return tr->getEstimatedRangeSizeBytes(r);
@@ -457,7 +457,7 @@ ThreadFuture<Standalone<VectorRef<KeyRef>>> ThreadSafeTransaction::getRangeSplit
                                                                                        int64_t chunkSize) {
 	KeyRange r = range;
 
-	ISingleThreadTransaction* tr = this->tr;
+	ISingleThreadTransaction* tr = endWriteBatch();
 	return onMainThread([tr, r, chunkSize]() -> Future<Standalone<VectorRef<KeyRef>>> {
 		tr->checkDeferredError();
 		return tr->getRangeSplitPoints(r, chunkSize);
@@ -472,7 +472,7 @@ ThreadFuture<RangeResult> ThreadSafeTransaction::getRange(const KeySelectorRef&
 	KeySelector b = begin;
 	KeySelector e = end;
 
-	ISingleThreadTransaction* tr = this->tr;
+	ISingleThreadTransaction* tr = endWriteBatch();
 	return onMainThread([tr, b, e, limit, snapshot, reverse]() -> Future<RangeResult> {
 		tr->checkDeferredError();
 		return tr->getRange(b, e, limit, Snapshot{ snapshot }, Reverse{ reverse });
@@ -487,7 +487,7 @@ ThreadFuture<RangeResult> ThreadSafeTransaction::getRange(const KeySelectorRef&
 	KeySelector b = begin;
 	KeySelector e = end;
 
-	ISingleThreadTransaction* tr = this->tr;
+	ISingleThreadTransaction* tr = endWriteBatch();
 	return onMainThread([tr, b, e, limits, snapshot, reverse]() -> Future<RangeResult> {
 		tr->checkDeferredError();
 		return tr->getRange(b, e, limits, Snapshot{ snapshot }, Reverse{ reverse });
@@ -504,7 +504,7 @@ ThreadFuture<MappedRangeResult> ThreadSafeTransaction::getMappedRange(const KeyS
 	KeySelector e = end;
 	Key h = mapper;
 
-	ISingleThreadTransaction* tr = this->tr;
+	ISingleThreadTransaction* tr = endWriteBatch();
 	return onMainThread([tr, b, e, h, limits, snapshot, reverse]() -> Future<MappedRangeResult> {
 		tr->checkDeferredError();
 		return tr->getMappedRange(b, e, h, limits, Snapshot{ snapshot }, Reverse{ reverse });
@@ -514,7 +514,7 @@ ThreadFuture<MappedRangeResult> ThreadSafeTransaction::getMappedRange(const KeyS
 ThreadFuture<Standalone<VectorRef<const char*>>> ThreadSafeTransaction::getAddressesForKey(const KeyRef& key) {
 	Key k = key;
 
-	ISingleThreadTransaction* tr = this->tr;
+	ISingleThreadTransaction* tr = endWriteBatch();
 	return onMainThread([tr, k]() -> Future<Standalone<VectorRef<const char*>>> {
 		tr->checkDeferredError();
 		return tr->getAddressesForKey(k);
@@ -524,7 +524,7 @@ ThreadFuture<Standalone<VectorRef<const char*>>> ThreadSafeTransaction::getAddre
 ThreadFuture<Standalone<VectorRef<KeyRangeRef>>> ThreadSafeTransaction::getBlobGranuleRanges(
     const KeyRangeRef& keyRange,
     int rangeLimit) {
-	ISingleThreadTransaction* tr = this->tr;
+	ISingleThreadTransaction* tr = endWriteBatch();
 	KeyRange r = keyRange;
 
 	return onMainThread([=]() -> Future<Standalone<VectorRef<KeyRangeRef>>> {
@@ -546,7 +546,7 @@ ThreadFuture<Standalone<VectorRef<BlobGranuleChunkRef>>> ThreadSafeTransaction::
     Version beginVersion,
     Optional<Version> readVersion,
     Version* readVersionOut) {
-	ISingleThreadTransaction* tr = this->tr;
+	ISingleThreadTransaction* tr = endWriteBatch();
 	KeyRange r = keyRange;
 
 	return onMainThread(
@@ -567,7 +567,7 @@ ThreadResult<RangeResult> ThreadSafeTransaction::readBlobGranulesFinish(
 	GranuleMaterializeStats stats;
 	auto ret = loadAndMaterializeBlobGranules(files, keyRange, beginVersion, readVersion, granuleContext, stats);
 	if (!ret.isError()) {
-		ISingleThreadTransaction* tr = this->tr;
+		ISingleThreadTransaction* tr = endWriteBatch();
 		onMainThreadVoid([tr, stats]() { tr->addGranuleMaterializeStats(stats); });
 	}
 	return ret;
@@ -577,7 +577,7 @@ ThreadFuture<Standalone<VectorRef<BlobGranuleSummaryRef>>> ThreadSafeTransaction
     const KeyRangeRef& keyRange,
     Optional<Version> summaryVersion,
     int rangeLimit) {
-	ISingleThreadTransaction* tr = this->tr;
+	ISingleThreadTransaction* tr = endWriteBatch();
 	KeyRange r = keyRange;
 
 	return onMainThread([=]() -> Future<Standalone<VectorRef<BlobGranuleSummaryRef>>> {
@@ -587,69 +587,38 @@ ThreadFuture<Standalone<VectorRef<BlobGranuleSummaryRef>>> ThreadSafeTransaction
 }
 
 void ThreadSafeTransaction::addReadConflictRange(const KeyRangeRef& keys) {
-	KeyRange r = keys;
-
-	ISingleThreadTransaction* tr = this->tr;
-	onMainThreadVoid([tr, r]() { tr->addReadConflictRange(r); }, tr, &ISingleThreadTransaction::deferredError);
+	bufferWrite(ThreadSafeTransactionWrites::Type::ReadConflictRange, keys.begin, keys.end);
 }
 
 void ThreadSafeTransaction::makeSelfConflicting() {
-	ISingleThreadTransaction* tr = this->tr;
+	ISingleThreadTransaction* tr = endWriteBatch();
 	onMainThreadVoid([tr]() { tr->makeSelfConflicting(); }, tr, &ISingleThreadTransaction::deferredError);
 }
 
 void ThreadSafeTransaction::atomicOp(const KeyRef& key, const ValueRef& value, uint32_t operationType) {
-	Key k = key;
-	Value v = value;
-
-	ISingleThreadTransaction* tr = this->tr;
-	onMainThreadVoid([tr, k, v, operationType]() { tr->atomicOp(k, v, operationType); },
-	                 tr,
-	                 &ISingleThreadTransaction::deferredError);
+	bufferWrite(ThreadSafeTransactionWrites::Type::AtomicOp, key, value, operationType);
 }
 
 void ThreadSafeTransaction::set(const KeyRef& key, const ValueRef& value) {
-	Key k = key;
-	Value v = value;
-
-	ISingleThreadTransaction* tr = this->tr;
-	onMainThreadVoid([tr, k, v]() { tr->set(k, v); }, tr, &ISingleThreadTransaction::deferredError);
+	bufferWrite(ThreadSafeTransactionWrites::Type::Set, key, value);
 }
 
 void ThreadSafeTransaction::clear(const KeyRangeRef& range) {
-	KeyRange r = range;
-
-	ISingleThreadTransaction* tr = this->tr;
-	onMainThreadVoid([tr, r]() { tr->clear(r); }, tr, &ISingleThreadTransaction::deferredError);
+	bufferWrite(ThreadSafeTransactionWrites::Type::ClearRange, range.begin, range.end);
 }
 
 void ThreadSafeTransaction::clear(const KeyRef& begin, const KeyRef& end) {
-	Key b = begin;
-	Key e = end;
-
-	ISingleThreadTransaction* tr = this->tr;
-	onMainThreadVoid(
-	    [tr, b, e]() {
-		    if (b > e)
-			    throw inverted_range();
-
-		    tr->clear(KeyRangeRef(b, e));
-	    },
-	    tr,
-	    &ISingleThreadTransaction::deferredError);
+	bufferWrite(ThreadSafeTransactionWrites::Type::ClearRange, begin, end);
 }
 
 void ThreadSafeTransaction::clear(const KeyRef& key) {
-	Key k = key;
-
-	ISingleThreadTransaction* tr = this->tr;
-	onMainThreadVoid([tr, k]() { tr->clear(k); }, tr, &ISingleThreadTransaction::deferredError);
+	bufferWrite(ThreadSafeTransactionWrites::Type::Clear, key, KeyRef());
 }
 
 ThreadFuture<Void> ThreadSafeTransaction::watch(const KeyRef& key) {
 	Key k = key;
 
-	ISingleThreadTransaction* tr = this->tr;
+	ISingleThreadTransaction* tr = endWriteBatch();
 	return onMainThread([tr, k]() -> Future<Void> {
 		tr->checkDeferredError();
 		return tr->watch(k);
@@ -657,14 +626,82 @@ ThreadFuture<Void> ThreadSafeTransaction::watch(const KeyRef& key) {
 }
 
 void ThreadSafeTransaction::addWriteConflictRange(const KeyRangeRef& keys) {
-	KeyRange r = keys;
+	bufferWrite(ThreadSafeTransactionWrites::Type::WriteConflictRange, keys.begin, keys.end);
+}
+
+bool ThreadSafeTransactionWrites::tryAdd(Type type, KeyRef key, KeyRef param, uint32_t operationType) {
+	ThreadSpinLockHolder holder(lock);
+	// A batch that is never applied (because the transaction already has a deferred error) stops growing here
+	if (applied || (!writes.empty() && bytes >= CLIENT_KNOBS->THREAD_SAFE_TRANSACTION_WRITE_BATCH_BYTES)) {
+		return false;
+	}
+	writes.push_back(Write{ type, operationType, KeyRef(arena, key), KeyRef(arena, param) });
+	bytes += key.size() + param.size() + sizeof(Write);
+	return true;
+}
+
+void ThreadSafeTransactionWrites::apply(ISingleThreadTransaction* tr) {
+	{
+		ThreadSpinLockHolder holder(lock);
+		applied = true;
+	}
+	for (const Write& w : writes) {
+		switch (w.type) {
+		case Type::Set:
+			tr->set(w.key, w.param);
+			break;
+		case Type::Clear:
+			tr->clear(w.key);
+			break;
+		case Type::ClearRange:
+			if (w.key > w.param)
+				throw inverted_range();
+			tr->clear(KeyRangeRef(w.key, w.param));
+			break;
+		case Type::AtomicOp:
+			tr->atomicOp(w.key, w.param, w.operationType);
+			break;
+		case Type::ReadConflictRange:
+			tr->addReadConflictRange(KeyRangeRef(w.key, w.param));
+			break;
+		case Type::WriteConflictRange:
+			tr->addWriteConflictRange(KeyRangeRef(w.key, w.param));
+			break;
+		}
+	}
+}
+
+void ThreadSafeTransaction::bufferWrite(ThreadSafeTransactionWrites::Type type,
+                                        KeyRef key,
+                                        KeyRef param,
+                                        uint32_t operationType) {
+	Reference<ThreadSafeTransactionWrites> batch;
+	{
+		ThreadSpinLockHolder holder(writeBatchLock);
+		if (writeBatch && writeBatch->tryAdd(type, key, param, operationType)) {
+			return;
+		}
+		batch = makeReference<ThreadSafeTransactionWrites>();
+		bool added = batch->tryAdd(type, key, param, operationType);
+		ASSERT(added);
+		writeBatch = batch;
+	}
 
 	ISingleThreadTransaction* tr = this->tr;
-	onMainThreadVoid([tr, r]() { tr->addWriteConflictRange(r); }, tr, &ISingleThreadTransaction::deferredError);
+	onMainThreadVoid([tr, batch]() { batch->apply(tr); }, tr, &ISingleThreadTransaction::deferredError);
+}
+
+ISingleThreadTransaction* ThreadSafeTransaction::endWriteBatch() {
+	Reference<ThreadSafeTransactionWrites> batch;
+	{
+		ThreadSpinLockHolder holder(writeBatchLock);
+		batch = std::move(writeBatch);
+	}
+	return tr;
 }
 
 ThreadFuture<Void> ThreadSafeTransaction::commit() {
-	ISingleThreadTransaction* tr = this->tr;
+	ISingleThreadTransaction* tr = endWriteBatch();
 	return onMainThread([tr]() -> Future<Void> {
 		tr->checkDeferredError();
 		return tr->commit();
@@ -680,7 +717,7 @@ Version ThreadSafeTransaction::getCommittedVersion() {
 }
 
 ThreadFuture<VersionVector> ThreadSafeTransaction::getVersionVector() {
-	ISingleThreadTransaction* tr = this->tr;
+	ISingleThreadTransaction* tr = endWriteBatch();
 	return onMainThread([tr]() -> Future<VersionVector> {
 		tr->checkDeferredError();
 		return tr->getVersionVector();
@@ -688,7 +725,7 @@ ThreadFuture<VersionVector> ThreadSafeTransaction::getVersionVector() {
 }
 
 ThreadFuture<SpanContext> ThreadSafeTransaction::getSpanContext() {
-	ISingleThreadTransaction* tr = this->tr;
+	ISingleThreadTransaction* tr = endWriteBatch();
 	return onMainThread([tr]() -> Future<SpanContext> {
 		tr->checkDeferredError();
 		return tr->getSpanContext();
@@ -696,7 +733,7 @@ ThreadFuture<SpanContext> ThreadSafeTransaction::getSpanContext() {
 }
 
 ThreadFuture<double> ThreadSafeTransaction::getTagThrottledDuration() {
-	ISingleThreadTransaction* tr = this->tr;
+	ISingleThreadTransaction* tr = endWriteBatch();
 	return onMainThread([tr]() -> Future<double> {
 		tr->checkDeferredError();
 		return tr->getTagThrottledDuration();
@@ -704,7 +741,7 @@ ThreadFuture<double> ThreadSafeTransaction::getTagThrottledDuration() {
 }
 
 ThreadFuture<int64_t> ThreadSafeTransaction::getTotalCost() {
-	ISingleThreadTransaction* tr = this->tr;
+	ISingleThreadTransaction* tr = endWriteBatch();
 	return onMainThread([tr]() -> Future<int64_t> {
 		tr->checkDeferredError();
 		return tr->getTotalCost();
@@ -712,7 +749,7 @@ ThreadFuture<int64_t> ThreadSafeTransaction::getTotalCost() {
 }
 
 ThreadFuture<int64_t> ThreadSafeTransaction::getApproximateSize() {
-	ISingleThreadTransaction* tr = this->tr;
+	ISingleThreadTransaction* tr = endWriteBatch();
 	return onMainThread([tr]() -> Future<int64_t> {
 		tr->checkDeferredError();
 		return tr->getApproximateSize();
@@ -720,7 +757,7 @@ ThreadFuture<int64_t> ThreadSafeTransaction::getApproximateSize() {
 }
 
 ThreadFuture<Standalone<StringRef>> ThreadSafeTransaction::getVersionstamp() {
-	ISingleThreadTransaction* tr = this->tr;
+	ISingleThreadTransaction* tr = endWriteBatch();
 	return onMainThread([tr]() -> Future<Standalone<StringRef>> {
 		tr->checkDeferredError();
 		return tr->getVersionstamp();
@@ -733,7 +770,7 @@ void ThreadSafeTransaction::setOption(FDBTransactionOptions::Option option, Opti
 		TraceEvent("UnknownTransactionOption").detail("Option", option);
 		throw invalid_option();
 	}
-	ISingleThreadTransaction* tr = this->tr;
+	ISingleThreadTransaction* tr = endWriteBatch();
 	Standalone<Optional<StringRef>> passValue = value;
 
 	// ThreadSafeTransaction is not allowed to do anything with options except pass them through to RYW.
@@ -743,7 +780,7 @@ void ThreadSafeTransaction::setOption(FDBTransactionOptions::Option option, Opti
 }
 
 ThreadFuture<Void> ThreadSafeTransaction::checkDeferredError() {
-	ISingleThreadTransaction* tr = this->tr;
+	ISingleThreadTransaction* tr = endWriteBatch();
 	return onMainThread([tr]() {
 		try {
 			tr->checkDeferredError();
@@ -756,7 +793,7 @@ ThreadFuture<Void> ThreadSafeTransaction::checkDeferredError() {
 }
 
 ThreadFuture<Void> ThreadSafeTransaction::onError(Error const& e) {
-	ISingleThreadTransaction* tr = this->tr;
+	ISingleThreadTransaction* tr = endWriteBatch();
 	return onMainThread([tr, e]() { return tr->onError(e); });
 }
 
@@ -768,29 +805,31 @@ void ThreadSafeTransaction::operator=(ThreadSafeTransaction&& r) noexcept {
 	tr = r.tr;
 	r.tr = nullptr;
 	initialized = std::move(r.initialized);
+	writeBatch = std::move(r.writeBatch);
 }
 
 ThreadSafeTransaction::ThreadSafeTransaction(ThreadSafeTransaction&& r) noexcept {
 	tr = r.tr;
 	r.tr = nullptr;
 	initialized = std::move(r.initialized);
+	writeBatch = std::move(r.writeBatch);
 }
 
 void ThreadSafeTransaction::reset() {
-	ISingleThreadTransaction* tr = this->tr;
+	ISingleThreadTransaction* tr = endWriteBatch();
 	onMainThreadVoid([tr]() { tr->reset(); });
 }
 
 void ThreadSafeTransaction::debugTrace(BaseTraceEvent&& ev) {
 	if (ev.isEnabled()) {
-		ISingleThreadTransaction* tr = this->tr;
+		ISingleThreadTransaction* tr = endWriteBatch();
 		std::shared_ptr<BaseTraceEvent> evPtr = std::make_shared<BaseTraceEvent>(std::move(ev));
 		onMainThreadVoid([tr, evPtr]() { tr->debugTrace(std::move(*evPtr)); });
 	}
 };
 
 void ThreadSafeTransaction::debugPrint(std::string const& message) {
-	ISingleThreadTransaction* tr = this->tr;
+	ISingleThreadTransaction* tr = endWriteBatch();
 	onMainThreadVoid([tr, message]() { tr->debugPrint(message); });
 }
 
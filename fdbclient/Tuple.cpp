@@ -38,15 +38,55 @@ static double bigEndianDouble(double orig) {
 	return *(double*)&big;
 }
 
+static bool isUserTypeCode(uint8_t code) {
+	return code >= USER_TYPE_START && code <= USER_TYPE_END;
+}
+
+// Zero bytes inside a string are escaped as \x00\xff, so the terminator is the first zero byte not followed by \xff.
+// memchr() skips the runs of non-zero bytes between candidates much faster than a byte at a time loop.
 static size_t findStringTerminator(const StringRef data, size_t offset) {
 	size_t i = offset;
-	while (i < data.size() - 1 && !(data[i] == '\x00' && data[i + 1] != (uint8_t)'\xff')) {
-		i += (data[i] == '\x00' ? 2 : 1);
+	while (i < data.size() - 1) {
+		const uint8_t* zero = (const uint8_t*)memchr(data.begin() + i, '\x00', data.size() - 1 - i);
+		if (zero == nullptr) {
+			return data.size() - 1;
+		}
+		i = zero - data.begin();
+		if (data[i + 1] != (uint8_t)'\xff') {
+			return i;
+		}
+		i += 2;
 	}
 
 	return i;
 }
 
+// Returns the offset just past the element starting at offset i of data. For a truncated numeric element, this is
+// beyond the end of data.
+static size_t findElementEnd(const StringRef data, size_t i, bool include_user_type) {
+	const uint8_t code = data[i];
+	if (code == '\x01' || code == '\x02') {
+		return findStringTerminator(data, i + 1) + 1;
+	} else if (code >= '\x0c' && code <= '\x1c') {
+		return i + abs(code - '\x14') + 1;
+	} else if (code == 0x20) {
+		return i + sizeof(float) + 1;
+	} else if (code == 0x21) {
+		return i + sizeof(double) + 1;
+	} else if (code == 0x26 || code == 0x27) {
+		return i + 1;
+	} else if (code == '\x00') {
+		return i + 1;
+	} else if (code == VERSIONSTAMP_96_CODE) {
+		return i + VERSIONSTAMP_TUPLE_SIZE + 1;
+	} else if (include_user_type && isUserTypeCode(code)) {
+		// User defined codes must come at the end of a Tuple and are not delimited.
+		return data.size();
+	} else {
+		throw invalid_tuple_data_type();
+	}
+}
+
 // If encoding and the sign bit is 1 (the number is negative), flip all the bits.
 // If decoding and the sign bit is 0 (the number is negative), flip all the bits.
 // Otherwise, the number is positive, so flip the sign bit.
@@ -61,33 +101,156 @@ static void adjustFloatingPoint(uint8_t* bytes, size_t size, bool encode) {
 	}
 }
 
+static Tuple::ElementType decodeType(uint8_t code) {
+	if (code == '\x00') {
+		return Tuple::NULL_TYPE;
+	} else if (code == '\x01') {
+		return Tuple::BYTES;
+	} else if (code == '\x02') {
+		return Tuple::UTF8;
+	} else if (code >= '\x0c' && code <= '\x1c') {
+		return Tuple::INT;
+	} else if (code == 0x20) {
+		return Tuple::FLOAT;
+	} else if (code == 0x21) {
+		return Tuple::DOUBLE;
+	} else if (code == 0x26 || code == 0x27) {
+		return Tuple::BOOL;
+	} else if (code == VERSIONSTAMP_96_CODE) {
+		return Tuple::VERSIONSTAMP;
+	} else if (isUserTypeCode(code)) {
+		return Tuple::USER_TYPE;
+	} else {
+		throw invalid_tuple_data_type();
+	}
+}
+
+// Unescapes the bytes of a string element that follow its type code, up to the next element. The result refers into
+// encoded unless the string contains escaped zero bytes, in which case it is unescaped into arena.
+static StringRef decodeString(StringRef encoded, Arena& arena) {
+	const uint8_t* zero = (const uint8_t*)memchr(encoded.begin(), '\x00', encoded.size());
+	if (zero == nullptr) {
+		// A truncated string has no terminator
+		return encoded;
+	}
+	if (zero == encoded.end() - 1) {
+		return encoded.substr(0, encoded.size() - 1);
+	}
+
+	uint8_t* out = new (arena) uint8_t[encoded.size()];
+	size_t size = 0;
+	const uint8_t* pos = encoded.begin();
+	while (zero != nullptr) {
+		memcpy(out + size, pos, zero - pos);
+		size += zero - pos;
+		if (zero + 1 < encoded.end()) {
+			// An escaped zero byte, followed by \xff
+			out[size++] = '\x00';
+			pos = zero + 2;
+		} else {
+			// The terminator
+			pos = zero + 1;
+		}
+		zero = pos < encoded.end() ? (const uint8_t*)memchr(pos, '\x00', encoded.end() - pos) : nullptr;
+	}
+	if (pos < encoded.end()) {
+		memcpy(out + size, pos, encoded.end() - pos);
+		size += encoded.end() - pos;
+	}
+	return StringRef(out, size);
+}
+
+// element starts with the type code and extends to the end of the packed tuple
+static int64_t decodeInt(StringRef element, bool allow_incomplete) {
+	int64_t swap;
+	bool neg = false;
+
+	uint8_t code = element[0];
+	if (code < '\x0c' || code > '\x1c') {
+		throw invalid_tuple_data_type();
+	}
+
+	int8_t len = code - '\x14';
+
+	if (len < 0) {
+		len = -len;
+		neg = true;
+	}
+
+	memset(&swap, neg ? '\xff' : 0, 8 - len);
+	// presentLen is how many of len bytes are actually present, it will be < len if the encoded tuple was truncated
+	int presentLen = std::min<int>(len, element.size() - 1);
+	ASSERT(len == presentLen || allow_incomplete);
+	memcpy(((uint8_t*)&swap) + 8 - len, element.begin() + 1, presentLen);
+	if (presentLen < len) {
+		int suffix = len - presentLen;
+		if (presentLen == 0) {
+			// The first byte in an int would always be at least 1, because if was 0 then a shorter int type would have
+			// been used. So if we don't have the first (most significant) byte in the encoded string, use 1 so that the
+			// decoded result maintains the encoded form's sort order with an encoded value of a shorter and same-signed
+			// type.
+			*(((uint8_t*)&swap) + 8 - len) = 1;
+			--suffix; // The suffix to clear below is now 1 byte shorter.
+		}
+		memset(((uint8_t*)&swap) + 8 - suffix, 0, suffix);
+	}
+
+	swap = bigEndian64(swap);
+
+	if (neg) {
+		swap = -(~swap);
+	}
+
+	return swap;
+}
+
+static bool decodeBool(uint8_t code) {
+	if (code == 0x26) {
+		return false;
+	} else if (code == 0x27) {
+		return true;
+	} else {
+		throw invalid_tuple_data_type();
+	}
+}
+
+// element starts with the type code
+static float decodeFloat(StringRef element) {
+	if (element[0] != 0x20) {
+		throw invalid_tuple_data_type();
+	}
+
+	float swap;
+	uint8_t* bytes = (uint8_t*)&swap;
+	ASSERT_LE(1 + sizeof(float), element.size());
+	memcpy(bytes, element.begin() + 1, sizeof(float));
+	adjustFloatingPoint(bytes, sizeof(float), false);
+
+	return bigEndianFloat(swap);
+}
+
+// element starts with the type code
+static double decodeDouble(StringRef element) {
+	if (element[0] != 0x21) {
+		throw invalid_tuple_data_type();
+	}
+
+	double swap;
+	uint8_t* bytes = (uint8_t*)&swap;
+	ASSERT_LE(1 + sizeof(double), element.size());
+	memcpy(bytes, element.begin() + 1, sizeof(double));
+	adjustFloatingPoint(bytes, sizeof(double), false);
+
+	return bigEndianDouble(swap);
+}
+
 Tuple::Tuple(StringRef const& str, bool exclude_incomplete, bool include_user_type) {
 	data.append(data.arena(), str.begin(), str.size());
 
 	size_t i = 0;
 	while (i < data.size()) {
 		offsets.push_back(i);
-
-		if (data[i] == '\x01' || data[i] == '\x02') {
-			i = findStringTerminator(str, i + 1) + 1;
-		} else if (data[i] >= '\x0c' && data[i] <= '\x1c') {
-			i += abs(data[i] - '\x14') + 1;
-		} else if (data[i] == 0x20) {
-			i += sizeof(float) + 1;
-		} else if (data[i] == 0x21) {
-			i += sizeof(double) + 1;
-		} else if (data[i] == 0x26 || data[i] == 0x27) {
-			i += 1;
-		} else if (data[i] == '\x00') {
-			i += 1;
-		} else if (data[i] == VERSIONSTAMP_96_CODE) {
-			i += VERSIONSTAMP_TUPLE_SIZE + 1;
-		} else if (include_user_type && isUserType(data[i])) {
-			// User defined codes must come at the end of a Tuple and are not delimited.
-			i = data.size();
-		} else {
-			throw invalid_tuple_data_type();
-		}
+		i = findElementEnd(str, i, include_user_type);
 	}
 	// If incomplete tuples are allowed, remove the last offset if i is now beyond size()
 	// Strings will never be considered incomplete due to the way the string end is found.
@@ -146,7 +309,7 @@ Tuple Tuple::unpackUserType(StringRef const& str, bool exclude_incomplete) {
 }
 
 bool Tuple::isUserType(uint8_t code) const {
-	return code >= USER_TYPE_START && code <= USER_TYPE_END;
+	return isUserTypeCode(code);
 }
 
 Tuple& Tuple::append(Tuple const& tuple) {
@@ -172,19 +335,19 @@ Tuple& Tuple::append(StringRef const& str, bool utf8) {
 	offsets.push_back(data.size());
 
 	const uint8_t utfChar = uint8_t(utf8 ? '\x02' : '\x01');
-	data.append(data.arena(), &utfChar, 1);
-
-	size_t lastPos = 0;
-	for (size_t pos = 0; pos < str.size(); ++pos) {
-		if (str[pos] == '\x00') {
-			data.append(data.arena(), str.begin() + lastPos, pos - lastPos);
-			data.push_back(data.arena(), (uint8_t)'\x00');
-			data.push_back(data.arena(), (uint8_t)'\xff');
-			lastPos = pos + 1;
-		}
+	data.reserve(data.arena(), data.size() + str.size() + 2);
+	data.push_back(data.arena(), utfChar);
+
+	// Copy the runs between zero bytes whole, escaping each zero byte as \x00\xff
+	const uint8_t* pos = str.begin();
+	const uint8_t* zero;
+	while (pos != str.end() && (zero = (const uint8_t*)memchr(pos, '\x00', str.end() - pos)) != nullptr) {
+		data.append(data.arena(), pos, zero - pos + 1);
+		data.push_back(data.arena(), (uint8_t)'\xff');
+		pos = zero + 1;
 	}
 
-	data.append(data.arena(), str.begin() + lastPos, str.size() - lastPos);
+	data.append(data.arena(), pos, str.end() - pos);
 	data.push_back(data.arena(), (uint8_t)'\x00');
 
 	return *this;
@@ -287,29 +450,7 @@ Tuple::ElementType Tuple::getType(size_t index) const {
 		throw invalid_tuple_index();
 	}
 
-	uint8_t code = data[offsets[index]];
-
-	if (code == '\x00') {
-		return ElementType::NULL_TYPE;
-	} else if (code == '\x01') {
-		return ElementType::BYTES;
-	} else if (code == '\x02') {
-		return ElementType::UTF8;
-	} else if (code >= '\x0c' && code <= '\x1c') {
-		return ElementType::INT;
-	} else if (code == 0x20) {
-		return ElementType::FLOAT;
-	} else if (code == 0x21) {
-		return ElementType::DOUBLE;
-	} else if (code == 0x26 || code == 0x27) {
-		return ElementType::BOOL;
-	} else if (code == VERSIONSTAMP_96_CODE) {
-		return ElementType::VERSIONSTAMP;
-	} else if (isUserType(code)) {
-		return ElementType::USER_TYPE;
-	} else {
-		throw invalid_tuple_data_type();
-	}
+	return decodeType(data[offsets[index]]);
 }
 
 Standalone<StringRef> Tuple::getString(size_t index) const {
@@ -330,27 +471,11 @@ Standalone<StringRef> Tuple::getString(size_t index) const {
 		e = data.size();
 	}
 
-	Standalone<StringRef> result;
-	VectorRef<uint8_t> staging;
-
-	for (size_t i = b; i < e; ++i) {
-		if (data[i] == '\x00') {
-			staging.append(result.arena(), data.begin() + b, i - b);
-			++i;
-			b = i + 1;
-
-			if (i < e) {
-				staging.push_back(result.arena(), '\x00');
-			}
-		}
-	}
-
-	if (b < e) {
-		staging.append(result.arena(), data.begin() + b, e - b);
-	}
-
-	result.StringRef::operator=(StringRef(staging.begin(), staging.size()));
-	return result;
+	const StringRef encoded(data.begin() + b, e - b);
+	Arena arena;
+	const StringRef str = decodeString(encoded, arena);
+	// Share the tuple's memory unless the string had to be unescaped
+	return Standalone<StringRef>(str, str.begin() == encoded.begin() ? data.arena() : arena);
 }
 
 int64_t Tuple::getInt(size_t index, bool allow_incomplete) const {
@@ -358,47 +483,8 @@ int64_t Tuple::getInt(size_t index, bool allow_incomplete) const {
 		throw invalid_tuple_index();
 	}
 
-	int64_t swap;
-	bool neg = false;
-
 	ASSERT(offsets[index] < data.size());
-	uint8_t code = data[offsets[index]];
-	if (code < '\x0c' || code > '\x1c') {
-		throw invalid_tuple_data_type();
-	}
-
-	int8_t len = code - '\x14';
-
-	if (len < 0) {
-		len = -len;
-		neg = true;
-	}
-
-	memset(&swap, neg ? '\xff' : 0, 8 - len);
-	// presentLen is how many of len bytes are actually present, it will be < len if the encoded tuple was truncated
-	int presentLen = std::min<int8_t>(len, data.size() - offsets[index] - 1);
-	ASSERT(len == presentLen || allow_incomplete);
-	memcpy(((uint8_t*)&swap) + 8 - len, data.begin() + offsets[index] + 1, presentLen);
-	if (presentLen < len) {
-		int suffix = len - presentLen;
-		if (presentLen == 0) {
-			// The first byte in an int would always be at least 1, because if was 0 then a shorter int type would have
-			// been used. So if we don't have the first (most significant) byte in the encoded string, use 1 so that the
-			// decoded result maintains the encoded form's sort order with an encoded value of a shorter and same-signed
-			// type.
-			*(((uint8_t*)&swap) + 8 - len) = 1;
-			--suffix; // The suffix to clear below is now 1 byte shorter.
-		}
-		memset(((uint8_t*)&swap) + 8 - suffix, 0, suffix);
-	}
-
-	swap = bigEndian64(swap);
-
-	if (neg) {
-		swap = -(~swap);
-	}
-
-	return swap;
+	return decodeInt(StringRef(data.begin() + offsets[index], data.size() - offsets[index]), allow_incomplete);
 }
 
 // TODO: Combine with bindings/flow/Tuple.*. This code is copied from there.
@@ -407,14 +493,7 @@ bool Tuple::getBool(size_t index) const {
 		throw invalid_tuple_index();
 	}
 	ASSERT_LT(offsets[index], data.size());
-	uint8_t code = data[offsets[index]];
-	if (code == 0x26) {
-		return false;
-	} else if (code == 0x27) {
-		return true;
-	} else {
-		throw invalid_tuple_data_type();
-	}
+	return decodeBool(data[offsets[index]]);
 }
 
 float Tuple::getFloat(size_t index) const {
@@ -422,18 +501,7 @@ float Tuple::getFloat(size_t index) const {
 		throw invalid_tuple_index();
 	}
 	ASSERT_LT(offsets[index], data.size());
-	uint8_t code = data[offsets[index]];
-	if (code != 0x20) {
-		throw invalid_tuple_data_type();
-	}
-
-	float swap;
-	uint8_t* bytes = (uint8_t*)&swap;
-	ASSERT_LE(offsets[index] + 1 + sizeof(float), data.size());
-	swap = *(float*)(data.begin() + offsets[index] + 1);
-	adjustFloatingPoint(bytes, sizeof(float), false);
-
-	return bigEndianFloat(swap);
+	return decodeFloat(StringRef(data.begin() + offsets[index], data.size() - offsets[index]));
 }
 
 double Tuple::getDouble(size_t index) const {
@@ -441,18 +509,7 @@ double Tuple::getDouble(size_t index) const {
 		throw invalid_tuple_index();
 	}
 	ASSERT_LT(offsets[index], data.size());
-	uint8_t code = data[offsets[index]];
-	if (code != 0x21) {
-		throw invalid_tuple_data_type();
-	}
-
-	double swap;
-	uint8_t* bytes = (uint8_t*)&swap;
-	ASSERT_LE(offsets[index] + 1 + sizeof(double), data.size());
-	swap = *(double*)(data.begin() + offsets[index] + 1);
-	adjustFloatingPoint(bytes, sizeof(double), false);
-
-	return bigEndianDouble(swap);
+	return decodeDouble(StringRef(data.begin() + offsets[index], data.size() - offsets[index]));
 }
 
 TupleVersionstamp Tuple::getVersionstamp(size_t index) const {
@@ -529,6 +586,63 @@ StringRef Tuple::subTupleRawString(size_t index) const {
 	return StringRef(data.begin() + offsets[index], endPos - offsets[index]);
 }
 
+bool TupleReader::next() {
+	if (end >= packed.size()) {
+		return false;
+	}
+	const size_t elementEnd = findElementEnd(packed, end, false);
+	if (excludeIncomplete && elementEnd > packed.size()) {
+		end = elementEnd;
+		return false;
+	}
+	begin = end;
+	end = elementEnd;
+	return true;
+}
+
+Tuple::ElementType TupleReader::getType() const {
+	ASSERT_LT(begin, packed.size());
+	return decodeType(packed[begin]);
+}
+
+StringRef TupleReader::getString(Arena& arena) const {
+	ASSERT_LT(begin, packed.size());
+	const uint8_t code = packed[begin];
+	if (code != '\x01' && code != '\x02') {
+		throw invalid_tuple_data_type();
+	}
+	return decodeString(packed.substr(begin + 1, std::min<size_t>(end, packed.size()) - begin - 1), arena);
+}
+
+int64_t TupleReader::getInt(bool allow_incomplete) const {
+	ASSERT_LT(begin, packed.size());
+	return decodeInt(packed.substr(begin), allow_incomplete);
+}
+
+bool TupleReader::getBool() const {
+	ASSERT_LT(begin, packed.size());
+	return decodeBool(packed[begin]);
+}
+
+float TupleReader::getFloat() const {
+	ASSERT_LT(begin, packed.size());
+	return decodeFloat(packed.substr(begin));
+}
+
+double TupleReader::getDouble() const {
+	ASSERT_LT(begin, packed.size());
+	return decodeDouble(packed.substr(begin));
+}
+
+TupleVersionstamp TupleReader::getVersionstamp() const {
+	ASSERT_LT(begin, packed.size());
+	if (packed[begin] != VERSIONSTAMP_96_CODE) {
+		throw invalid_tuple_data_type();
+	}
+	ASSERT_LE(begin + 1 + VERSIONSTAMP_TUPLE_SIZE, packed.size());
+	return TupleVersionstamp(packed.substr(begin + 1, VERSIONSTAMP_TUPLE_SIZE));
+}
+
 TEST_CASE("/fdbclient/Tuple/makeTuple") {
 	Tuple t1 = Tuple::makeTuple(1,
 	                            1.0f,
@@ -601,3 +715,44 @@ TEST_CASE("/fdbclient/Tuple/unpack") {
 
 	return Void();
 }
+
+TEST_CASE("/fdbclient/Tuple/reader") {
+	for (int i = 0; i < 1000; i++) {
+		// Strings with runs of zero bytes exercise escaping, including at both ends
+		std::string bytes;
+		const int length = deterministicRandom()->randomInt(0, 20);
+		for (int j = 0; j < length; j++) {
+			const bool zero = deterministicRandom()->coinflip();
+			bytes.push_back(zero ? '\x00' : (char)deterministicRandom()->randomInt(1, 256));
+		}
+		const int64_t number = deterministicRandom()->randomInt64(std::numeric_limits<int64_t>::min(),
+		                                                          std::numeric_limits<int64_t>::max());
+		const double real = deterministicRandom()->random01();
+
+		Tuple t = Tuple::makeTuple(StringRef(bytes), number, real, true, nullptr, Tuple::UnicodeStr(StringRef(bytes)));
+		Standalone<StringRef> packed = t.pack();
+		Tuple unpacked = Tuple::unpack(packed);
+		ASSERT(unpacked.getString(0) == StringRef(bytes));
+		ASSERT(unpacked.getString(5) == StringRef(bytes));
+
+		Arena arena;
+		TupleReader reader(packed);
+		ASSERT(reader.next() && reader.getType() == Tuple::BYTES && reader.getString(arena) == StringRef(bytes));
+		ASSERT(reader.rawElement() == t.subTupleRawString(0));
+		ASSERT(reader.next() && reader.getType() == Tuple::INT && reader.getInt() == number);
+		ASSERT(reader.next() && reader.getType() == Tuple::DOUBLE && reader.getDouble() == real);
+		ASSERT(reader.next() && reader.getType() == Tuple::BOOL && reader.getBool());
+		ASSERT(reader.next() && reader.getType() == Tuple::NULL_TYPE);
+		ASSERT(reader.next() && reader.getType() == Tuple::UTF8 && reader.getString(arena) == StringRef(bytes));
+		ASSERT(!reader.next());
+	}
+
+	// A truncated trailing int is excluded like it is by Tuple::unpack()
+	Standalone<StringRef> packed = Tuple::makeTuple("a"_sr, 1000000).pack();
+	StringRef truncated = packed.substr(0, packed.size() - 1);
+	TupleReader reader(truncated, true);
+	ASSERT(reader.next() && !reader.next());
+	ASSERT(Tuple::unpack(truncated, true).size() == 1);
+
+	return Void();
+}
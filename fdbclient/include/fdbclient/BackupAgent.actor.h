@@ -1014,10 +1014,16 @@ struct StringRefReader {
 namespace fileBackup {
 Standalone<VectorRef<KeyValueRef>> decodeRangeFileBlock(const Standalone<StringRef>& buf);
 
+// Returns the key range of a range file block without decoding it, if the block's format records it.
+Optional<KeyRange> getRangeFileBlockRange(const StringRef& buf);
+
+// If ranges is not empty, a block which records its range and doesn't intersect any of them is returned as just its
+// begin and end keys.
 ACTOR Future<Standalone<VectorRef<KeyValueRef>>> decodeRangeFileBlock(Reference<IAsyncFile> file,
                                                                       int64_t offset,
                                                                       int len,
-                                                                      Database cx);
+                                                                      Database cx,
+                                                                      std::vector<KeyRange> ranges = {});
 
 Standalone<VectorRef<KeyValueRef>> decodeMutationLogFileBlock(const Standalone<StringRef>& buf);
 
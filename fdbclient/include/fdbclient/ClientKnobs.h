@@ -85,6 +85,7 @@ public:
 	int64_t CHANGE_FEED_CACHE_LIMIT_BYTES;
 
 	int MAX_BATCH_SIZE;
+	int64_t THREAD_SAFE_TRANSACTION_WRITE_BATCH_BYTES; // Max bytes of buffered writes per network thread task
 	double GRV_BATCH_TIMEOUT;
 	int BROADCAST_BATCH_SIZE;
 	double TRANSACTION_TIMEOUT_DELAY_INTERVAL;
@@ -107,6 +108,13 @@ public:
 	bool TAG_ENCODE_KEY_SERVERS;
 	int64_t RANGESTREAM_FRAGMENT_SIZE;
 	int RANGESTREAM_BUFFERED_FRAGMENTS_LIMIT;
+	bool ENABLE_RANGE_PREFETCH; // If true, a transaction scanning a range reads the next batches ahead of time
+	int RANGE_PREFETCH_MAX_DEPTH; // Max range reads a transaction keeps in flight ahead of a scan
+	int64_t RANGE_PREFETCH_MAX_BYTES; // Max bytes a transaction reads ahead of a scan
+	bool ENABLE_PREFIX_COMPRESSED_RANGE_REPLIES; // If true, range read replies may elide prefixes shared by keys
+	bool SPECIAL_KEY_SPACE_PARALLEL_READS; // If true, a special key range read evaluates its modules concurrently
+	double SPECIAL_KEY_SPACE_CACHE_TTL; // Seconds status, worker interface and DD stats special keys are reused across
+	                                    // transactions, 0 to always recompute them
 	bool QUARANTINE_TSS_ON_MISMATCH;
 	double CHANGE_FEED_EMPTY_BATCH_TIME;
 
@@ -180,6 +188,9 @@ public:
 	int SIM_BACKUP_TASKS_PER_AGENT;
 	int BACKUP_RANGEFILE_BLOCK_SIZE;
 	int BACKUP_LOGFILE_BLOCK_SIZE;
+	int MUTATION_LOG_READER_MAX_PIPELINE_DEPTH; // Max blocks each MutationLogReader stream reads ahead when it stalls
+	bool ENABLE_BACKUP_RANGEFILE_COMPRESSION; // Write unencrypted range files in the compressed, prefix-compressed format
+	std::string BACKUP_RANGEFILE_COMPRESSION_FILTER; // Falls back to NONE if the filter isn't supported by this build
 	int BACKUP_DISPATCH_ADDTASK_SIZE;
 	bool BACKUP_ALLOW_DRYRUN;
 	int RESTORE_DISPATCH_ADDTASK_SIZE;
@@ -354,7 +354,11 @@ public:
 	                                                          StorageMetrics const& estimated,
 	                                                          Optional<int> const& minSplitBytes = {});
 
-	Future<Standalone<VectorRef<ReadHotRangeWithMetrics>>> getReadHotRanges(KeyRange const& keys);
+	// With HOT_KEYS, each storage server queried returns up to chunkCount of its hot key ranges instead of dividing keys
+	Future<Standalone<VectorRef<ReadHotRangeWithMetrics>>> getReadHotRanges(
+	    KeyRange const& keys,
+	    ReadHotSubRangeRequest::SplitType type = ReadHotSubRangeRequest::SplitType::BYTES,
+	    int chunkCount = 1);
 	Future<Standalone<VectorRef<ReadHotRangeWithMetrics>>> getHotRangeMetrics(StorageServerInterface ssi,
 	                                                                          KeyRange const& keys,
 	                                                                          ReadHotSubRangeRequest::SplitType type,
@@ -597,6 +601,11 @@ public:
 	Counter transactionLogicalReads;
 	Counter transactionPhysicalReads;
 	Counter transactionPhysicalReadsCompleted;
+	Counter transactionRangePrefetches;
+	Counter transactionRangePrefetchHits;
+	Counter transactionSpecialKeyModuleReads;
+	Counter transactionSpecialKeyModuleCacheHits;
+	Counter transactionSpecialKeyModuleReadMicroseconds;
 	Counter transactionGetKeyRequests;
 	Counter transactionGetValueRequests;
 	Counter transactionGetRangeRequests;
@@ -1165,6 +1165,82 @@ public:
 	friend class MultiVersionTransaction;
 };
 
+// An implementation of ITenant that spreads the transactions of a tenant across the shards of a ShardedDatabase
+class ShardedTenant final : public ITenant, ThreadSafeReferenceCounted<ShardedTenant> {
+public:
+	explicit ShardedTenant(std::vector<Reference<ITenant>> shards);
+
+	Reference<ITransaction> createTransaction() override;
+
+	ThreadFuture<int64_t> getId() override;
+	ThreadFuture<Key> purgeBlobGranules(const KeyRangeRef& keyRange, Version purgeVersion, bool force) override;
+	ThreadFuture<Void> waitPurgeGranulesComplete(const KeyRef& purgeKey) override;
+
+	ThreadFuture<bool> blobbifyRange(const KeyRangeRef& keyRange) override;
+	ThreadFuture<bool> blobbifyRangeBlocking(const KeyRangeRef& keyRange) override;
+	ThreadFuture<bool> unblobbifyRange(const KeyRangeRef& keyRange) override;
+	ThreadFuture<Standalone<VectorRef<KeyRangeRef>>> listBlobbifiedRanges(const KeyRangeRef& keyRange,
+	                                                                      int rangeLimit) override;
+	ThreadFuture<Version> verifyBlobRange(const KeyRangeRef& keyRange, Optional<Version> version) override;
+	ThreadFuture<bool> flushBlobRange(const KeyRangeRef& keyRange, bool compact, Optional<Version> version) override;
+
+	void addref() override { ThreadSafeReferenceCounted<ShardedTenant>::addref(); }
+	void delref() override { ThreadSafeReferenceCounted<ShardedTenant>::delref(); }
+
+private:
+	const std::vector<Reference<ITenant>> shards;
+	std::atomic<uint32_t> nextShard;
+};
+
+// An implementation of IDatabase that spreads its transactions across one MultiVersionDatabase per client thread, so
+// that a single database handle can use more than one network thread. Each transaction is created on the less busy of
+// two shards, chosen round robin. Options are applied to every shard, and operations that are not transactions are
+// run on the first shard.
+class ShardedDatabase final : public IDatabase, ThreadSafeReferenceCounted<ShardedDatabase> {
+public:
+	explicit ShardedDatabase(std::vector<Reference<IDatabase>> shards);
+
+	Reference<ITenant> openTenant(TenantNameRef tenantName) override;
+	Reference<ITransaction> createTransaction() override;
+	void setOption(FDBDatabaseOptions::Option option, Optional<StringRef> value = Optional<StringRef>()) override;
+
+	// Returns the average busyness of the shards' network threads
+	double getMainThreadBusyness() override;
+
+	ThreadFuture<ProtocolVersion> getServerProtocol(
+	    Optional<ProtocolVersion> expectedVersion = Optional<ProtocolVersion>()) override;
+
+	void addref() override { ThreadSafeReferenceCounted<ShardedDatabase>::addref(); }
+	void delref() override { ThreadSafeReferenceCounted<ShardedDatabase>::delref(); }
+
+	ThreadFuture<int64_t> rebootWorker(const StringRef& address, bool check, int duration) override;
+	ThreadFuture<Void> forceRecoveryWithDataLoss(const StringRef& dcid) override;
+	ThreadFuture<Void> createSnapshot(const StringRef& uid, const StringRef& snapshot_command) override;
+
+	ThreadFuture<Key> purgeBlobGranules(const KeyRangeRef& keyRange, Version purgeVersion, bool force) override;
+	ThreadFuture<Void> waitPurgeGranulesComplete(const KeyRef& purgeKey) override;
+
+	ThreadFuture<bool> blobbifyRange(const KeyRangeRef& keyRange) override;
+	ThreadFuture<bool> blobbifyRangeBlocking(const KeyRangeRef& keyRange) override;
+	ThreadFuture<bool> unblobbifyRange(const KeyRangeRef& keyRange) override;
+	ThreadFuture<Standalone<VectorRef<KeyRangeRef>>> listBlobbifiedRanges(const KeyRangeRef& keyRange,
+	                                                                      int rangeLimit) override;
+	ThreadFuture<Version> verifyBlobRange(const KeyRangeRef& keyRange, Optional<Version> version) override;
+	ThreadFuture<bool> flushBlobRange(const KeyRangeRef& keyRange, bool compact, Optional<Version> version) override;
+
+	// Shared state belongs to a single client library copy, and each shard runs on its own copy, so only the first
+	// shard takes part in it. The other shards keep their own state, e.g. their own GRV cache.
+	ThreadFuture<DatabaseSharedState*> createSharedState() override;
+	void setSharedState(DatabaseSharedState* p) override;
+
+	// The status of the first shard, with the status of every shard under "Shards"
+	ThreadFuture<Standalone<StringRef>> getClientStatus() override;
+
+private:
+	const std::vector<Reference<IDatabase>> shards;
+	std::atomic<uint32_t> nextShard;
+};
+
 // An implementation of IClientApi that can choose between multiple different client implementations either provided
 // locally within the primary loaded fdb_c client or through any number of dynamically loaded clients.
 //
@@ -1246,6 +1322,7 @@ private:
 	bool ignoreExternalClientFailures;
 	bool failIncompatibleClient;
 	bool retainClientLibCopies;
+	bool shardDatabases;
 	ApiVersion apiVersion;
 
 	int nextThread = 0;
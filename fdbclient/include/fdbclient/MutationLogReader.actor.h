@@ -59,21 +59,28 @@ struct RangeResultBlock {
 };
 
 // PipelinedReader is the class actually doing range read (getRange). A MutationLogReader has 256 PipelinedReaders, each
-// in charge of one hash value from 0-255.
+// in charge of one hash value from 0-255. A PipelinedReader reads ahead up to pipelineDepth RangeResultBlocks, and the
+// depth grows, up to MUTATION_LOG_READER_MAX_PIPELINE_DEPTH, each time the consumer has to wait for this reader.
 class PipelinedReader {
 public:
 	PipelinedReader(uint8_t h, Version bv, Version ev, unsigned pd, Key p)
-	  : readerLimit(pd), hash(h), prefix(StringRef(&hash, sizeof(uint8_t)).withPrefix(p)), beginVersion(bv),
-	    endVersion(ev), currentBeginVersion(bv), pipelineDepth(pd) {}
+	  : hash(h), prefix(StringRef(&hash, sizeof(uint8_t)).withPrefix(p)), beginVersion(bv), endVersion(ev),
+	    currentBeginVersion(bv), pipelineDepth(pd), unconsumed(0) {}
 
 	void startReading(Database cx);
 	Future<Void> getNext(Database cx);
 	ACTOR static Future<Void> getNext_impl(PipelinedReader* self, Database cx);
 
-	void release() { readerLimit.release(); }
+	// Called when the consumer is done with a RangeResultBlock
+	void release() {
+		--unconsumed;
+		readerLimitChanged.trigger();
+	}
+
+	// Called when the consumer has to wait for this reader's next RangeResultBlock
+	void stalled();
 
 	PromiseStream<RangeResultBlock> reads;
-	FlowLock readerLimit;
 	uint8_t hash;
 	Key prefix; // "\xff\x02/alog/UID/hash/" for restore, or "\xff\x02/blog/UID/hash/" for backup
 
@@ -82,7 +89,9 @@ public:
 private:
 	[[maybe_unused]] Version beginVersion;
 	Version endVersion, currentBeginVersion;
-	[[maybe_unused]] unsigned pipelineDepth;
+	unsigned pipelineDepth;
+	unsigned unconsumed; // RangeResultBlocks read but not yet released by the consumer
+	AsyncTrigger readerLimitChanged;
 	Future<Void> reader;
 };
 
@@ -94,6 +103,9 @@ private:
 // has at most one RangeResultBlock in MutationLogReader's min heap. When the consumer reads from MutationLogReader, the
 // MutationLogReader calls the heap's top RangeResultBlock's consume() function, to make sure it does deliver perfectly
 // ordered mutations.
+//
+// getNextBatch() merges consecutive consume() results into one version ordered batch of up to a given size. It returns
+// a partial batch rather than waiting for a PipelinedReader whose next RangeResultBlock isn't read yet.
 class MutationLogReader : public ReferenceCounted<MutationLogReader> {
 public:
 	MutationLogReader() : finished(256) {}
@@ -122,9 +134,12 @@ public:
 
 	Future<Standalone<RangeResultRef>> getNext();
 
+	// Returns the next version ordered KV pairs, about maxBytes of them unless fewer are read already
+	Future<Standalone<RangeResultRef>> getNextBatch(int64_t maxBytes);
+
 private:
 	ACTOR static Future<Void> initializePQ(MutationLogReader* self);
-	ACTOR static Future<Standalone<RangeResultRef>> getNext_impl(MutationLogReader* self);
+	ACTOR static Future<Standalone<RangeResultRef>> getNextBatch_impl(MutationLogReader* self, int64_t maxBytes);
 
 	std::vector<std::unique_ptr<mutation_log_reader::PipelinedReader>> pipelinedReaders;
 	std::priority_queue<mutation_log_reader::RangeResultBlock> priorityQueue;
@@ -132,6 +147,9 @@ private:
 	Key prefix; // "\xff\x02/alog/UID/" for restore, or "\xff\x02/blog/UID/" for backup
 	unsigned pipelineDepth;
 	unsigned finished;
+	// The PipelinedReader whose RangeResultBlock was used up, and must provide its next one before anything else is
+	// consumed
+	Optional<uint8_t> refill;
 };
 
 #include "flow/unactorcompiler.h"
@@ -574,11 +574,36 @@ private:
 
 	void resetImpl(bool generateNewSpan);
 
+	// A range read, and the selector and parameters that a read continuing it has to share
+	struct RangeRead {
+		Future<RangeResult> result;
+		KeySelector fixedSelector; // The end of a forward read, or the begin of a reverse one
+		GetRangeLimits limits;
+		Snapshot snapshot = Snapshot::False;
+		Reverse reverse = Reverse::False;
+		Promise<std::pair<Key, Key>> conflictRange; // Only used by prefetched reads
+	};
+
+	// Returns true if a read of [begin, end) picks up where lastRangeRead left off
+	bool continuesLastRangeRead(KeySelector const& begin, KeySelector const& end, Snapshot snapshot, Reverse reverse);
+
+	// Serves a range read from rangePrefetches if it continues a scan, and keeps reads in flight ahead of the scan
+	Future<RangeResult> getRangeWithPrefetch(KeySelector begin,
+	                                         KeySelector end,
+	                                         GetRangeLimits limits,
+	                                         Snapshot snapshot,
+	                                         Reverse reverse);
+
 	double backoff;
 	CommitTransactionRequest tr;
 	std::vector<Future<std::pair<Key, Key>>> extraConflictRanges;
 	Promise<Void> commitResult;
 	Future<Void> committing;
+
+	RangeRead lastRangeRead;
+	// Continuations of lastRangeRead, each one continuing the one before it
+	std::deque<RangeRead> rangePrefetches;
+	int rangePrefetchDepth = 1;
 };
 
 template <std::invocable<Transaction*> Fun>
@@ -0,0 +1,67 @@
+/*
+ * PrefixCompressedKeyValues.h
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FDBCLIENT_PREFIXCOMPRESSEDKEYVALUES_H
+#define FDBCLIENT_PREFIXCOMPRESSEDKEYVALUES_H
+
+#pragma once
+
+#include "flow/flow.h"
+#include "fdbclient/FDBTypes.h"
+
+// A sorted run of key-value pairs, as returned by a range read, in which each key is stored as the length of the
+// prefix it shares with the key before it followed by the rest of the key. Keys of a range usually share long
+// prefixes (tenant, directory and index prefixes), so this is often much smaller than the plain encoding.
+//
+// Encoding: varint count, then for each pair varint sharedLength, varint suffixLength, suffix, varint valueLength, value
+
+// Returns the encoding of kvs, allocated in arena
+StringRef encodePrefixCompressed(VectorRef<KeyValueRef> const& kvs, Arena& arena);
+
+// Size in bytes of kvs in the encoding used for uncompressed replies, for deciding whether compressing pays off
+int64_t uncompressedEncodedSize(VectorRef<KeyValueRef> const& kvs);
+
+// Decodes every pair of encoded into arena. Values refer into encoded, which must outlive the result.
+// Throws serialization_failed() if encoded is malformed.
+VectorRef<KeyValueRef> decodePrefixCompressed(StringRef encoded, Arena& arena);
+
+// Walks the pairs of an encoding without materializing them. The key of the current pair is kept in a buffer owned by
+// the iterator and is only valid until the next call to next(); the value refers into the encoding.
+class PrefixCompressedKeyValuesIterator {
+public:
+	explicit PrefixCompressedKeyValuesIterator(StringRef encoded);
+
+	// Number of pairs in the encoding
+	int count() const { return total; }
+
+	// Moves to the next pair, which is the first one on the first call. Returns false after the last pair.
+	bool next();
+
+	KeyValueRef get() const { return KeyValueRef(StringRef(key.data(), key.size()), value); }
+
+private:
+	StringRef remaining;
+	int total;
+	int visited;
+	std::vector<uint8_t> key;
+	ValueRef value;
+};
+
+#endif /* FDBCLIENT_PREFIXCOMPRESSEDKEYVALUES_H */
@@ -88,9 +88,15 @@ public:
 	int64_t TLOG_SPILL_REFERENCE_MAX_PEEK_MEMORY_BYTES;
 	int64_t TLOG_SPILL_REFERENCE_MAX_BATCHES_PER_PEEK;
 	int64_t TLOG_SPILL_REFERENCE_MAX_BYTES_PER_BATCH;
+	bool ENABLE_TLOG_SPILL_COMPACTION; // Rewrite spilled-by-reference data of lagging tags into per-tag segments
+	int64_t TLOG_SPILL_COMPACTION_MIN_BATCHES; // Spilled reference batches a tag accumulates before being compacted
+	int64_t TLOG_SPILL_COMPACTION_SEGMENT_BYTES; // Target mutation bytes of a compacted segment
+	int64_t TLOG_SPILL_COMPACTION_MAX_SEGMENTS_PER_PEEK;
+	std::string TLOG_SPILL_COMPACTION_FILTER; // Compression filter of compacted segments
 	int64_t DISK_QUEUE_FILE_EXTENSION_BYTES; // When we grow the disk queue, by how many bytes should it grow?
 	int64_t DISK_QUEUE_FILE_SHRINK_BYTES; // When we shrink the disk queue, by how many bytes should it shrink?
 	int64_t DISK_QUEUE_MAX_TRUNCATE_BYTES; // A truncate larger than this will cause the file to be replaced instead.
+	int DISK_QUEUE_RECOVERY_READ_AHEAD_CHUNKS; // Number of reads (of up to 1MB each) kept in flight while recovering
 	double TLOG_DEGRADED_DURATION;
 	int64_t MAX_CACHE_VERSIONS;
 	double TXS_POPPED_MAX_DELAY;
@@ -133,6 +139,14 @@ public:
 	double RELOCATION_PARALLELISM_PER_SOURCE_SERVER;
 	double RELOCATION_PARALLELISM_PER_DEST_SERVER;
 	double MERGE_RELOCATION_PARALLELISM_PER_TEAM;
+	bool DD_BANDWIDTH_AWARE_RELOCATION; // Admit moves to destination servers by their fetch bandwidth budget instead of
+	                                    // RELOCATION_PARALLELISM_PER_DEST_SERVER, and let unhealthy relocations
+	                                    // preempt rebalances that are still choosing a destination
+	double DD_DEST_BANDWIDTH_INITIAL_BYTES_PER_SECOND; // Assumed fetch throughput of a server with no completed moves
+	double DD_DEST_BANDWIDTH_WINDOW; // Seconds of fetch throughput a destination server may have in flight
+	double DD_DEST_BANDWIDTH_SMOOTHING; // Weight of the latest completed move in a server's throughput estimate
+	double DD_REBALANCE_DEST_BANDWIDTH_FRACTION; // Fraction of the budget rebalance moves may use, leaving headroom
+	                                             // for foreground traffic and higher priority moves
 	int DD_QUEUE_MAX_KEY_SERVERS;
 	int DD_REBALANCE_PARALLELISM;
 	int DD_REBALANCE_RESET_AMOUNT;
@@ -454,6 +468,9 @@ public:
 
 	// KeyValueStoreMemory
 	int64_t REPLACE_CONTENTS_BYTES;
+	int64_t MEMORY_KVS_SNAPSHOT_READ_RANGE_BYTES; // Range reads larger than this are finished by a snapshot reader
+	                                              // thread; 0 disables snapshot reads
+	int MEMORY_KVS_SNAPSHOT_READ_THREADS;
 
 	// KeyValueStoreRocksDB
 	bool ROCKSDB_SET_READ_TIMEOUT;
@@ -718,6 +735,8 @@ public:
 	int BACKUP_FILE_BLOCK_BYTES;
 	int64_t BACKUP_LOCK_BYTES;
 	double BACKUP_UPLOAD_DELAY;
+	int64_t BACKUP_MAX_PENDING_UPLOAD_BYTES; // Bytes of mutation log files that can still be uploading while the backup
+	                                         // worker writes the next files. 0 uploads one batch of files at a time.
 
 	// Cluster Controller
 	double CLUSTER_CONTROLLER_LOGGING_DELAY;
@@ -1030,11 +1049,26 @@ public:
 	int64_t EMPTY_READ_PENALTY;
 	int DD_SHARD_COMPARE_LIMIT; // when read-aware DD is enabled, at most how many shards are compared together
 	bool READ_SAMPLING_ENABLED;
+	int READ_HOT_SKETCH_WIDTH; // counters per row of the storage server's read hot key count-min sketch
+	int READ_HOT_SKETCH_DEPTH; // rows of the read hot key count-min sketch
+	int READ_HOT_SKETCH_KEYS; // number of heavy hitter keys each storage server tracks
+	int64_t READ_HOT_SKETCH_MERGE_BYTES; // hot keys closer than this many sampled bytes are reported as one range
+	bool DD_SPLIT_READ_HOT_KEY_RANGES; // split read hot shards around the hot key ranges reported by storage servers
+	double DD_READ_HOT_KEY_RANGE_MIN_FRACTION; // minimum fraction of a shard's read bandwidth a hot key range must
+	                                           // serve to be split into its own shard
 	bool DD_PREFER_LOW_READ_UTIL_TEAM;
 	// Rolling window duration over which the average bytes moved by DD is calculated for the 'MovingData' trace event.
 	double DD_TRACE_MOVE_BYTES_AVERAGE_INTERVAL;
 	int64_t MOVING_WINDOW_SAMPLE_SIZE;
 
+	// Storage Cache
+	bool STORAGE_CACHE_ADMISSION_CONTROL; // cache only keys read often enough within the configured cache ranges
+	int STORAGE_CACHE_ADMISSION_READS; // reads of a key over the last one to two STORAGE_METRICS_AVERAGE_INTERVALs
+	                                   // before it is admitted to the cache
+	int64_t STORAGE_CACHE_MEMORY_BUDGET; // bytes of admitted data a cache server keeps before evicting the coldest keys
+	int64_t STORAGE_CACHE_ADMISSION_ESTIMATE_BYTES; // bytes charged for an admitted key until it is fetched
+	double STORAGE_CACHE_EVICTION_INTERVAL;
+
 	// Storage Server
 	double STORAGE_LOGGING_DELAY;
 	double STORAGE_SERVER_POLL_METRICS_DELAY;
@@ -1082,6 +1116,8 @@ public:
 	int BYTE_SAMPLE_LOAD_PARALLELISM;
 	double BYTE_SAMPLE_LOAD_DELAY;
 	double BYTE_SAMPLE_START_DELAY;
+	int BYTE_SAMPLE_RESTORE_BLOCK_BYTES; // Keys restored into the byte sample share arenas of about this many bytes
+	                                     // instead of allocating one each; 0 disables
 	double BEHIND_CHECK_DELAY;
 	int BEHIND_CHECK_COUNT;
 	int64_t BEHIND_CHECK_VERSIONS;
@@ -1203,6 +1239,8 @@ public:
 	// Status
 	double STATUS_MIN_TIME_BETWEEN_REQUESTS;
 	double MAX_STATUS_REQUESTS_PER_SECOND;
+	double STATUS_MAX_STALENESS; // Status requests may be answered with a status generated up to this many seconds ago
+	double STATUS_WORKER_METRICS_MAX_STALENESS; // Max age of per-worker metrics events reused across status requests
 	int CONFIGURATION_ROWS_TO_FETCH;
 	bool DISABLE_DUPLICATE_LOG_WARNING;
 	double HISTOGRAM_REPORT_INTERVAL;
@@ -1263,6 +1301,10 @@ public:
 	double FASTRESTORE_RATE_UPDATE_SECONDS; // how long to update appliers target write rate
 	bool FASTRESTORE_DUMP_INSERT_RANGE_VERSION; // Dump all the range version after insertion. This is for debugging
 	                                            // purpose.
+	std::string FASTRESTORE_APPLIER_BULKLOAD_FOLDER; // Folder shared with storage servers where appliers write SST
+	                                                 // files to bulk load batches into empty ranges; empty disables
+	int64_t FASTRESTORE_APPLIER_BULKLOAD_MIN_BYTES; // Smallest applier batch worth ingesting through bulk load
+	double FASTRESTORE_APPLIER_BULKLOAD_POLL_SECONDS; // Interval between checks of a submitted bulk load task
 
 	int REDWOOD_DEFAULT_PAGE_SIZE; // Page size for new Redwood files
 	int REDWOOD_DEFAULT_EXTENT_SIZE; // Extent size for new Redwood files
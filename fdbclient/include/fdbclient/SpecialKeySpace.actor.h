@@ -62,6 +62,10 @@ public:
 
 	virtual bool supportsTenants() const { return false; }
 
+	// How long, in seconds, a result may be reused for later reads of the same range by any transaction on the
+	// database. 0 for ranges whose contents depend on the reading transaction or have to be fresh.
+	virtual double cacheTTL() const { return 0; }
+
 	virtual ~SpecialKeyRangeReadImpl() {}
 
 protected:
@@ -251,6 +255,13 @@ private:
 	                                                          KeySelector end,
 	                                                          GetRangeLimits limits,
 	                                                          Reverse reverse);
+	// Reads kr from impl, from readCache if impl allows it
+	ACTOR static Future<RangeResult> readModule(SpecialKeySpace* sks,
+	                                            ReadYourWritesTransaction* ryw,
+	                                            const SpecialKeyRangeReadImpl* impl,
+	                                            KeyRange kr,
+	                                            GetRangeLimits limits,
+	                                            KeyRangeMap<Optional<RangeResult>>* cache);
 
 	KeyRangeMap<SpecialKeyRangeReadImpl*> readImpls;
 	KeyRangeMap<SpecialKeySpace::MODULE> modules;
@@ -259,6 +270,13 @@ private:
 	// key space range, (\xff\xff, \xff\xff\xff) in prod and (, \xff) in test
 	KeyRange range;
 
+	struct CachedRead {
+		double expiresAt;
+		RangeResult result;
+	};
+	// Results of reads from impls with a cacheTTL(), by impl and range read
+	std::map<std::tuple<const SpecialKeyRangeReadImpl*, Key, Key>, CachedRead> readCache;
+
 	static std::unordered_map<SpecialKeySpace::MODULE, KeyRange> moduleToBoundary;
 
 	// management command to its special keys' range
@@ -339,6 +357,7 @@ public:
 	Future<RangeResult> getRange(ReadYourWritesTransaction* ryw,
 	                             KeyRangeRef kr,
 	                             GetRangeLimits limitsHint) const override;
+	double cacheTTL() const override;
 };
 
 class ManagementCommandsOptionsImpl : public SpecialKeyRangeRWImpl {
@@ -569,6 +588,7 @@ public:
 	Future<RangeResult> getRange(ReadYourWritesTransaction* ryw,
 	                             KeyRangeRef kr,
 	                             GetRangeLimits limitsHint) const override;
+	double cacheTTL() const override;
 };
 
 class FaultToleranceMetricsImpl : public SpecialKeyRangeReadImpl {
@@ -577,6 +597,7 @@ public:
 	Future<RangeResult> getRange(ReadYourWritesTransaction* ryw,
 	                             KeyRangeRef kr,
 	                             GetRangeLimits limitsHint) const override;
+	double cacheTTL() const override;
 };
 
 // If the underlying set of key-value pairs of a key space is not changing, then we expect repeating a read to give the
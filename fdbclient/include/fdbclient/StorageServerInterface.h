@@ -25,6 +25,7 @@
 #include "fdbclient/Audit.h"
 #include "fdbclient/BulkDumping.h"
 #include "fdbclient/FDBTypes.h"
+#include "fdbclient/PrefixCompressedKeyValues.h"
 #include "fdbclient/StorageCheckpoint.h"
 #include "fdbclient/StorageServerShard.h"
 #include "fdbrpc/Locality.h"
@@ -365,12 +366,40 @@ struct GetKeyValuesReply : public LoadBalancedReply {
 	Version version; // useful when latestVersion was requested
 	bool more;
 	bool cached = false;
+	// When not empty, data is sent in this prefix compressed form (see PrefixCompressedKeyValues.h) instead, and
+	// decoded back into data on receipt. Only set for requests with acceptPrefixCompressed.
+	StringRef prefixCompressedData;
 
 	GetKeyValuesReply() : version(invalidVersion), more(false), cached(false) {}
 
 	template <class Ar>
 	void serialize(Ar& ar) {
-		serializer(ar, LoadBalancedReply::penalty, LoadBalancedReply::error, data, version, more, cached, arena);
+		if (!ar.isDeserializing && prefixCompressedData.size()) {
+			VectorRef<KeyValueRef, VecSerStrategy::String> none;
+			serializer(ar,
+			           LoadBalancedReply::penalty,
+			           LoadBalancedReply::error,
+			           none,
+			           version,
+			           more,
+			           cached,
+			           prefixCompressedData,
+			           arena);
+			return;
+		}
+		serializer(ar,
+		           LoadBalancedReply::penalty,
+		           LoadBalancedReply::error,
+		           data,
+		           version,
+		           more,
+		           cached,
+		           prefixCompressedData,
+		           arena);
+		if (ar.isDeserializing && prefixCompressedData.size()) {
+			data = decodePrefixCompressed(prefixCompressedData, arena);
+			prefixCompressedData = StringRef();
+		}
 	}
 };
 
@@ -391,6 +420,7 @@ struct GetKeyValuesRequest : TimedRequest {
 	VersionVector ssLatestCommitVersions; // includes the latest commit versions, as known
 	                                      // to this client, of all storage replicas that
 	                                      // serve the given key
+	bool acceptPrefixCompressed = false; // the reply may be sent in GetKeyValuesReply::prefixCompressedData
 
 	GetKeyValuesRequest() {}
 
@@ -410,6 +440,7 @@ struct GetKeyValuesRequest : TimedRequest {
 		           tenantInfo,
 		           options,
 		           ssLatestCommitVersions,
+		           acceptPrefixCompressed,
 		           arena);
 	}
 };
@@ -815,15 +846,23 @@ struct ReadHotRangeWithMetrics {
 struct ReadHotSubRangeReply {
 	constexpr static FileIdentifier file_identifier = 10424537;
 	Standalone<VectorRef<ReadHotRangeWithMetrics>> readHotRanges;
+	// Set when readHotRanges answers a HOT_KEYS request. Storage servers which predate HOT_KEYS answer it as a
+	// READ_BYTES request and leave this unset.
+	bool hotKeys = false;
 
 	template <class Ar>
 	void serialize(Ar& ar) {
-		serializer(ar, readHotRanges);
+		serializer(ar, readHotRanges, hotKeys);
 	}
+
+	// readHotRanges if they answer a request of the given type, and nothing otherwise
+	Standalone<VectorRef<ReadHotRangeWithMetrics>> rangesFor(uint8_t type) const;
 };
 struct ReadHotSubRangeRequest {
 	constexpr static FileIdentifier file_identifier = 10259266;
-	enum SplitType : uint8_t { BYTES, READ_BYTES, READ_OPS };
+	// HOT_KEYS returns up to chunkCount of the most read key ranges tracked by the storage server's sketch instead of
+	// dividing the range
+	enum SplitType : uint8_t { BYTES, READ_BYTES, READ_OPS, HOT_KEYS };
 
 	Arena arena;
 	KeyRangeRef keys;
@@ -838,10 +877,24 @@ struct ReadHotSubRangeRequest {
 
 	template <class Ar>
 	void serialize(Ar& ar) {
-		serializer(ar, keys, reply, type, chunkCount, arena);
+		// Storage servers which predate HOT_KEYS fail on a split type they do not know, so HOT_KEYS is sent as a
+		// READ_BYTES request with hotKeys set
+		uint8_t wireType = type == SplitType::HOT_KEYS ? (uint8_t)SplitType::READ_BYTES : type;
+		bool hotKeys = type == SplitType::HOT_KEYS;
+		serializer(ar, keys, reply, wireType, chunkCount, hotKeys, arena);
+		if (ar.isDeserializing) {
+			type = hotKeys ? (uint8_t)SplitType::HOT_KEYS : wireType;
+		}
 	}
 };
 
+inline Standalone<VectorRef<ReadHotRangeWithMetrics>> ReadHotSubRangeReply::rangesFor(uint8_t type) const {
+	if (type == ReadHotSubRangeRequest::SplitType::HOT_KEYS && !hotKeys) {
+		return Standalone<VectorRef<ReadHotRangeWithMetrics>>();
+	}
+	return readHotRanges;
+}
+
 struct SplitRangeReply {
 	constexpr static FileIdentifier file_identifier = 11813134;
 	// If the given range can be divided, contains the split points.
@@ -120,6 +120,32 @@ private:
 	Tenant* tenant;
 };
 
+// A run of writes to a ThreadSafeTransaction that don't return a result. The writes are buffered on the calling thread
+// and handed to the network thread as a single task, instead of one task and one copy of the arguments per call.
+struct ThreadSafeTransactionWrites : ThreadSafeReferenceCounted<ThreadSafeTransactionWrites>, NonCopyable {
+	enum class Type : uint8_t { Set, Clear, ClearRange, AtomicOp, ReadConflictRange, WriteConflictRange };
+
+	// Adds a write unless the batch has already been applied or is full. Called on the thread using the transaction.
+	bool tryAdd(Type type, KeyRef key, KeyRef param, uint32_t operationType = 0);
+
+	// Applies the buffered writes in order. Called on the network thread; no writes can be added afterwards.
+	void apply(ISingleThreadTransaction* tr);
+
+private:
+	struct Write {
+		Type type;
+		uint32_t operationType; // Only used by AtomicOp
+		KeyRef key;
+		KeyRef param; // The value, or the end of the range
+	};
+
+	ThreadSpinLock lock;
+	bool applied = false;
+	int64_t bytes = 0;
+	Arena arena;
+	std::vector<Write> writes;
+};
+
 // An implementation of ITransaction that serializes operations onto the network thread and interacts with the
 // lower-level client APIs exposed by ISingleThreadTransaction
 class ThreadSafeTransaction : public ITransaction, ThreadSafeReferenceCounted<ThreadSafeTransaction>, NonCopyable {
@@ -241,9 +267,18 @@ public:
 	void debugPrint(std::string const& message) override;
 
 private:
+	// Adds a write to the current write batch, starting and scheduling a new batch if there is none or it is closed
+	void bufferWrite(ThreadSafeTransactionWrites::Type type, KeyRef key, KeyRef param, uint32_t operationType = 0);
+
+	// Ends the current write batch so that operations scheduled afterwards are ordered after it, and returns tr
+	ISingleThreadTransaction* endWriteBatch();
+
 	ISingleThreadTransaction* tr;
 	const Optional<TenantName> tenantName;
 	std::shared_ptr<std::atomic_bool> initialized;
+	// cancel() may be called on another thread while a write is being buffered, so writeBatch is guarded
+	ThreadSpinLock writeBatchLock;
+	Reference<ThreadSafeTransactionWrites> writeBatch;
 };
 
 // An implementation of IClientApi that serializes operations onto the network thread and interacts with the lower-level
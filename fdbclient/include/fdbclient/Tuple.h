@@ -126,4 +126,34 @@ private:
 	std::vector<size_t> offsets;
 };
 
+// Reads the elements of a packed tuple in place. Unlike Tuple::unpack(), it neither copies the packed tuple nor
+// records the offsets of its elements, so decoding a key into its fields allocates nothing unless a string element
+// contains escaped zero bytes. The packed tuple must outlive the reader and the strings it returns.
+class TupleReader {
+public:
+	// exclude_incomplete has the same meaning as for Tuple::unpack()
+	explicit TupleReader(StringRef packed, bool exclude_incomplete = false)
+	  : packed(packed), excludeIncomplete(exclude_incomplete), begin(0), end(0) {}
+
+	// Moves to the next element, which is the first one on the first call. Returns false after the last element.
+	bool next();
+
+	Tuple::ElementType getType() const;
+	// Refers into the packed tuple, unless the string contains escaped zero bytes and is unescaped into arena
+	StringRef getString(Arena& arena) const;
+	int64_t getInt(bool allow_incomplete = false) const;
+	bool getBool() const;
+	float getFloat() const;
+	double getDouble() const;
+	TupleVersionstamp getVersionstamp() const;
+
+	// The encoding of the current element, type code included
+	StringRef rawElement() const { return packed.substr(begin, std::min<size_t>(end, packed.size()) - begin); }
+
+private:
+	StringRef packed;
+	bool excludeIncomplete;
+	size_t begin, end; // the current element is [begin, end) of packed
+};
+
 #endif /* FDBCLIENT_TUPLE_H */
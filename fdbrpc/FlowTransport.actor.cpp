@@ -45,6 +45,7 @@
 #include "fdbrpc/TokenCache.h"
 #include "fdbrpc/simulator.h"
 #include "flow/ActorCollection.h"
+#include "flow/CompressionUtils.h"
 #include "flow/Error.h"
 #include "flow/flow.h"
 #include "flow/Net2Packet.h"
@@ -72,6 +73,9 @@ Future<Void> g_currentDeliveryPeerDisconnect;
 } // namespace
 
 constexpr int PACKET_LEN_WIDTH = sizeof(uint32_t);
+// Set in the packet length of packets whose payload is {uint8_t filter, compressed(token + message)}. PACKET_LIMIT is
+// far below 2^31, so the bit is never part of a real length.
+constexpr uint32_t PACKET_COMPRESSED_FLAG = 0x80000000;
 const uint64_t TOKEN_STREAM_FLAG = 1;
 
 FDB_BOOLEAN_PARAM(InReadSocket);
@@ -492,6 +496,7 @@ ACTOR Future<Void> pingLatencyLogger(TransportData* self) {
 				    .detail("Count", peer->pingLatencies.getPopulationSize())
 				    .detail("BytesReceived", peer->bytesReceived - peer->lastLoggedBytesReceived)
 				    .detail("BytesSent", peer->bytesSent - peer->lastLoggedBytesSent)
+				    .detail("WriteCount", peer->writeCount)
 				    .detail("TimeoutCount", peer->timeoutCount)
 				    .detail("ConnectOutgoingCount", peer->connectOutgoingCount)
 				    .detail("ConnectIncomingCount", peer->connectIncomingCount)
@@ -500,7 +505,12 @@ ACTOR Future<Void> pingLatencyLogger(TransportData* self) {
 				    .detail("ConnectMaxLatency", peer->connectLatencies.max())
 				    .detail("ConnectMeanLatency", peer->connectLatencies.mean())
 				    .detail("ConnectMedianLatency", peer->connectLatencies.median())
-				    .detail("ConnectP90Latency", peer->connectLatencies.percentile(0.90));
+				    .detail("ConnectP90Latency", peer->connectLatencies.percentile(0.90))
+				    .detail("CompressionFilter", CompressionUtils::toString(peer->compressionFilter))
+				    .detail("CompressionBytesIn", peer->compressionBytesIn)
+				    .detail("CompressionBytesOut", peer->compressionBytesOut)
+				    .detail("CompressionTime", peer->compressionTime)
+				    .detail("DecompressionTime", peer->decompressionTime);
 				peer->lastLoggedTime = now();
 				peer->connectOutgoingCount = 0;
 				peer->connectIncomingCount = 0;
@@ -510,6 +520,11 @@ ACTOR Future<Void> pingLatencyLogger(TransportData* self) {
 				peer->lastLoggedBytesReceived = peer->bytesReceived;
 				peer->lastLoggedBytesSent = peer->bytesSent;
 				peer->timeoutCount = 0;
+				peer->writeCount = 0;
+				peer->compressionBytesIn = 0;
+				peer->compressionBytesOut = 0;
+				peer->compressionTime = 0;
+				peer->decompressionTime = 0;
 				wait(delay(FLOW_KNOBS->PING_LOGGING_INTERVAL));
 			} else if (it == self->orderedAddresses.begin()) {
 				wait(delay(FLOW_KNOBS->PING_LOGGING_INTERVAL));
@@ -547,7 +562,9 @@ struct ConnectPacket {
 	// IP Address to reconnect to the originating process. Only one of these must be populated.
 	uint32_t canonicalRemoteIp4 = 0;
 
-	enum ConnectPacketFlags { FLAG_IPV6 = 1 };
+	// FLAG_COMPRESSION_* advertise the filters the sender can decompress. Peers that do not know about these flags
+	// never set them, so nothing is ever sent compressed to them.
+	enum ConnectPacketFlags { FLAG_IPV6 = 1, FLAG_COMPRESSION_ZSTD = 2 };
 	uint16_t flags = 0;
 	uint8_t canonicalRemoteIp6[16] = { 0 };
 
@@ -575,6 +592,16 @@ struct ConnectPacket {
 
 	bool isIPv6() const { return flags & FLAG_IPV6; }
 
+	void setSupportedCompressionFilters() {
+		if (CompressionUtils::supportedFilters.count(CompressionFilter::ZSTD)) {
+			flags = flags | FLAG_COMPRESSION_ZSTD;
+		}
+	}
+
+	bool supportsCompressionFilter(CompressionFilter filter) const {
+		return filter == CompressionFilter::ZSTD && (flags & FLAG_COMPRESSION_ZSTD);
+	}
+
 	uint32_t totalPacketSize() const { return connectPacketLength + sizeof(connectPacketLength); }
 
 	template <class Ar>
@@ -596,6 +623,17 @@ struct ConnectPacket {
 
 #pragma pack(pop)
 
+// Returns the filter used for packets sent to the process which sent pkt, or NONE if it cannot decompress what this
+// process is configured to send.
+static CompressionFilter negotiateCompressionFilter(const ConnectPacket& pkt) {
+	CompressionFilter filter = CompressionUtils::fromFilterString(FLOW_KNOBS->NETWORK_COMPRESSION_FILTER);
+	if (filter == CompressionFilter::NONE || !CompressionUtils::supportedFilters.count(filter) ||
+	    !pkt.supportsCompressionFilter(filter)) {
+		return CompressionFilter::NONE;
+	}
+	return filter;
+}
+
 ACTOR static Future<Void> connectionReader(TransportData* transport,
                                            Reference<IConnection> conn,
                                            Reference<struct Peer> peer,
@@ -707,7 +745,10 @@ ACTOR Future<Void> connectionWriter(Reference<Peer> self, Reference<IConnection>
 		loop {
 			lastWriteTime = now();
 
+			// A single write hands the whole unsent PacketBuffer chain, up to the limit, to the socket as one vectored
+			// send, so every packet queued since the last write goes out in one system call.
 			int sent = conn->write(self->unsent.getUnsent(), /* limit= */ FLOW_KNOBS->MAX_PACKET_SEND_BYTES);
+			++self->writeCount;
 			if (sent) {
 				self->bytesSent += sent;
 				self->transport->bytesSent += sent;
@@ -718,6 +759,14 @@ ACTOR Future<Void> connectionWriter(Reference<Peer> self, Reference<IConnection>
 				break;
 			}
 
+			if (sent == FLOW_KNOBS->MAX_PACKET_SEND_BYTES) {
+				// The write was cut short by the limit rather than by a full socket buffer, so there is no need to
+				// probe the reactor for writability before sending the rest.
+				CODE_PROBE(true, "Write limited by MAX_PACKET_SEND_BYTES");
+				wait(yield(TaskPriority::WriteSocket));
+				continue;
+			}
+
 			CODE_PROBE(
 			    true, "We didn't write everything, so apparently the write buffer is full.  Wait for it to be nonfull");
 			wait(conn->onWritable());
@@ -883,6 +932,7 @@ ACTOR Future<Void> connectionKeeper(Reference<Peer> self,
 			}
 		} catch (Error& e) {
 			self->connected = false;
+			self->compressionFilter = CompressionFilter::NONE;
 			delayedHealthUpdateF.cancel();
 			if (now() - self->lastConnectTime > FLOW_KNOBS->RECONNECTION_RESET_TIME) {
 				self->reconnectionDelay = FLOW_KNOBS->INITIAL_RECONNECTION_TIME;
@@ -1013,7 +1063,9 @@ Peer::Peer(TransportData* transport, NetworkAddress const& destination)
     lastConnectTime(0.0), reconnectionDelay(FLOW_KNOBS->INITIAL_RECONNECTION_TIME), peerReferences(-1),
     bytesReceived(0), bytesSent(0), lastDataPacketSentTime(now()), outstandingReplies(0),
     pingLatencies(destination.isPublic() ? FLOW_KNOBS->PING_SKETCH_ACCURACY : 0.1), lastLoggedTime(0.0),
-    lastLoggedBytesReceived(0), lastLoggedBytesSent(0), timeoutCount(0),
+    lastLoggedBytesReceived(0), lastLoggedBytesSent(0), timeoutCount(0), writeCount(0),
+    compressionFilter(CompressionFilter::NONE), compressedReliablePackets(false),
+    compressionBytesIn(0), compressionBytesOut(0), compressionTime(0), decompressionTime(0),
     protocolVersion(Reference<AsyncVar<Optional<ProtocolVersion>>>(new AsyncVar<Optional<ProtocolVersion>>())),
     connectOutgoingCount(0), connectIncomingCount(0), connectFailedCount(0),
     connectLatencies(destination.isPublic() ? FLOW_KNOBS->PING_SKETCH_ACCURACY : 0.1) {
@@ -1047,6 +1099,7 @@ void Peer::prependConnectPacket() {
 	pkt.protocolVersion = g_network->protocolVersion();
 	pkt.protocolVersion.addObjectSerializerFlag();
 	pkt.connectionId = transport->transportId;
+	pkt.setSupportedCompressionFilters();
 
 	PacketBuffer *pb_first = PacketBuffer::create(), *pb_end = nullptr;
 	PacketWriter wr(pb_first, nullptr, Unversioned());
@@ -1064,11 +1117,50 @@ void Peer::prependConnectPacket() {
 	unsent.prependWriteBuffer(pb_first, pb_end);
 }
 
+// Returns packet, a packet sent with the compressed flag, as it would have been sent without compression, or nothing if
+// it was not sent compressed
+static Optional<Standalone<StringRef>> uncompressedPacket(StringRef packet, bool checksumEnabled) {
+	uint32_t lenField;
+	memcpy(&lenField, packet.begin(), sizeof(lenField));
+	if (!(lenField & PACKET_COMPRESSED_FLAG)) {
+		return Optional<Standalone<StringRef>>();
+	}
+	const int headerSize = PACKET_LEN_WIDTH + (checksumEnabled ? sizeof(XXH64_hash_t) : 0);
+	StringRef payload = packet.substr(headerSize);
+	Arena arena;
+	StringRef uncompressed = CompressionUtils::decompress(
+	    static_cast<CompressionFilter>(payload[0]), payload.substr(1), (size_t)FLOW_KNOBS->PACKET_LIMIT, arena);
+
+	Standalone<StringRef> result = makeString(headerSize + uncompressed.size());
+	uint8_t* out = mutateString(result);
+	uint32_t len = uncompressed.size();
+	memcpy(out, &len, sizeof(len));
+	if (checksumEnabled) {
+		XXH64_hash_t checksum = XXH3_64bits(uncompressed.begin(), uncompressed.size());
+		memcpy(out + PACKET_LEN_WIDTH, &checksum, sizeof(checksum));
+	}
+	uncompressed.copyTo(out + headerSize);
+	if (FLOW_KNOBS->WIPE_SENSITIVE_DATA_FROM_PACKET_BUFFER) {
+		::memset(mutateString(uncompressed), 0, uncompressed.size());
+	}
+	return result;
+}
+
 void Peer::discardUnreliablePackets() {
 	// Throw away the current unsent list, dropping the reference count on each PacketBuffer that accounts for presence
 	// in the unsent list
 	unsent.discardAll();
 
+	// Compression is negotiated per connection, and the next one may be to a process which cannot decompress what was
+	// sent on this one. Reliable packets are replayed uncompressed, like everything sent before the remote
+	// ConnectPacket arrives.
+	if (compressedReliablePackets) {
+		CODE_PROBE(true, "Replaying compressed reliable packets uncompressed");
+		const bool checksumEnabled = !destination.isTLS();
+		reliable.rewrite([checksumEnabled](StringRef packet) { return uncompressedPacket(packet, checksumEnabled); });
+		compressedReliablePackets = false;
+	}
+
 	// If there are reliable packets, compact reliable packets into a new unsent range
 	if (!reliable.empty()) {
 		PacketBuffer* pb = unsent.getWriteBuffer();
@@ -1232,7 +1324,8 @@ static void scanPackets(TransportData* transport,
                         bool isTrustedPeer,
                         ProtocolVersion peerProtocolVersion,
                         Future<Void> disconnect,
-                        IsStableConnection isStableConnection) {
+                        IsStableConnection isStableConnection,
+                        Peer* peer) {
 	// Find each complete packet in the given byte range and queue a ready task to deliver it.
 	// Remove the complete packets from the range by increasing unprocessed_begin.
 	// There won't be more than 64K of data plus one packet, so this shouldn't take a long time.
@@ -1248,6 +1341,8 @@ static void scanPackets(TransportData* transport,
 			break;
 		packetLen = *(uint32_t*)p;
 		p += PACKET_LEN_WIDTH;
+		const bool compressed = packetLen & PACKET_COMPRESSED_FLAG;
+		packetLen &= ~PACKET_COMPRESSED_FLAG;
 
 		// Read checksum if present
 		if (checksumEnabled) {
@@ -1268,7 +1363,7 @@ static void scanPackets(TransportData* transport,
 		if (e - p < packetLen)
 			break;
 
-		if (packetLen < sizeof(UID)) {
+		if (packetLen < (compressed ? 1 : sizeof(UID))) {
 			if (g_network->isSimulated()) {
 				// Same as ASSERT(false), but prints packet length:
 				ASSERT_GE(packetLen, sizeof(UID));
@@ -1330,19 +1425,48 @@ static void scanPackets(TransportData* transport,
 #if VALGRIND
 		VALGRIND_CHECK_MEM_IS_DEFINED(p, packetLen);
 #endif
+		StringRef packet(p, packetLen);
+		if (compressed) {
+			// The decompressed packet is allocated in the same arena as the receive buffer, so it lives as long as
+			// any reader of it just like an uncompressed packet does.
+			double decompressStart = timer_monotonic();
+			CompressionFilter filter = static_cast<CompressionFilter>(p[0]);
+			if (filter == CompressionFilter::NONE || filter >= CompressionFilter::LAST ||
+			    !CompressionUtils::supportedFilters.count(filter)) {
+				TraceEvent(SevWarnAlways, "UnsupportedPacketCompression")
+				    .suppressFor(1.0)
+				    .detail("FromPeer", peerAddress.toString())
+				    .detail("Filter", (int)p[0]);
+				throw platform_error();
+			}
+			packet = CompressionUtils::decompress(
+			    filter, StringRef(p + 1, packetLen - 1), (size_t)FLOW_KNOBS->PACKET_LIMIT, arena);
+			if (packet.size() < sizeof(UID)) {
+				TraceEvent(SevError, "PacketTooSmall")
+				    .detail("FromPeer", peerAddress.toString())
+				    .detail("Length", packet.size())
+				    .detail("CompressedLength", packetLen);
+				throw platform_error();
+			}
+			if (peer) {
+				peer->decompressionTime += timer_monotonic() - decompressStart;
+			}
+		}
+
 		// remove object serializer flag to account for flat buffer
 		peerProtocolVersion.removeObjectSerializerFlag();
-		ArenaReader reader(arena, StringRef(p, packetLen), AssumeVersion(peerProtocolVersion));
+		ArenaReader reader(arena, packet, AssumeVersion(peerProtocolVersion));
 		UID token;
 		reader >> token;
 
 		++transport->countPacketsReceived;
 
-		if (packetLen > FLOW_KNOBS->PACKET_WARNING) {
+		if (packet.size() > FLOW_KNOBS->PACKET_WARNING) {
 			TraceEvent(SevWarn, "LargePacketReceived")
 			    .suppressFor(1.0)
 			    .detail("FromPeer", peerAddress.toString())
-			    .detail("Length", (int)packetLen)
+			    .detail("Length", packet.size())
+			    .detail("CompressedLength", compressed ? (int)packetLen : 0)
 			    .detail("Token", token);
 		}
 
@@ -1380,7 +1504,7 @@ static int getNewBufferSize(const uint8_t* begin,
 	if (len < PACKET_LEN_WIDTH) {
 		return FLOW_KNOBS->MIN_PACKET_BUFFER_BYTES;
 	}
-	const uint32_t packetLen = *(uint32_t*)begin;
+	const uint32_t packetLen = *(uint32_t*)begin & ~PACKET_COMPRESSED_FLAG;
 	if (packetLen > FLOW_KNOBS->PACKET_LIMIT) {
 		TraceEvent(SevError, "PacketLimitExceeded")
 		    .detail("FromPeer", peerAddress.toString())
@@ -1407,6 +1531,7 @@ ACTOR static Future<Void> connectionReader(TransportData* transport,
 	state bool incompatiblePeerCounted = false;
 	state NetworkAddress peerAddress;
 	state ProtocolVersion peerProtocolVersion;
+	state CompressionFilter peerCompressionFilter = CompressionFilter::NONE;
 	state bool trusted = transport->allowList(conn->getPeerAddress().ip) && conn->hasTrustedPeer();
 	peerAddress = conn->getPeerAddress();
 
@@ -1461,6 +1586,7 @@ ACTOR static Future<Void> connectionReader(TransportData* transport,
 						BinaryReader pktReader(unprocessed_begin, connectPacketSize, AssumeVersion(protocolVersion));
 						ConnectPacket pkt;
 						serializer(pktReader, pkt);
+						peerCompressionFilter = negotiateCompressionFilter(pkt);
 
 						uint64_t connectionId = pkt.connectionId;
 						if (!pkt.protocolVersion.hasObjectSerializerFlag() ||
@@ -1555,6 +1681,8 @@ ACTOR static Future<Void> connectionReader(TransportData* transport,
 							onConnected.send(peer);
 							wait(delay(0)); // Check for cancellation
 						}
+						// Set after onIncomingConnection() has torn down any previous connection of this peer
+						peer->compressionFilter = compatible ? peerCompressionFilter : CompressionFilter::NONE;
 						peer->protocolVersion->set(peerProtocolVersion);
 					}
 				}
@@ -1569,7 +1697,8 @@ ACTOR static Future<Void> connectionReader(TransportData* transport,
 						            trusted,
 						            peerProtocolVersion,
 						            peer->disconnect.getFuture(),
-						            IsStableConnection(g_network->isSimulated() && conn->isStableConnection()));
+						            IsStableConnection(g_network->isSimulated() && conn->isStableConnection()),
+						            peer.getPtr());
 					} else {
 						unprocessed_begin = unprocessed_end;
 						peer->resetPing.trigger();
@@ -1913,6 +2042,77 @@ static void sendLocal(TransportData* self, ISerializeSource const& what, const E
 	}
 }
 
+// Serializes the token and message of a packet to a peer which negotiated compression. The size of the message is only
+// known once the ObjectWriter asks for its buffer, so the allocator decides: small messages are written straight into
+// the PacketWriter like any other packet, larger ones into a temporary buffer which serialize() compresses.
+struct PacketCompressor {
+	Peer* peer;
+	PacketWriter& wr;
+	const Endpoint& destination;
+	Arena arena;
+	uint8_t* uncompressed = nullptr; // {token, message}, if the message is large enough to compress
+	size_t uncompressedSize = 0;
+
+	PacketCompressor(Peer* peer, PacketWriter& wr, const Endpoint& destination)
+	  : peer(peer), wr(wr), destination(destination) {}
+
+	static uint8_t* allocate(const size_t size, void* context) {
+		PacketCompressor* self = static_cast<PacketCompressor*>(context);
+		if (sizeof(UID) + size < (size_t)FLOW_KNOBS->NETWORK_COMPRESSION_MIN_BYTES) {
+			self->wr << self->destination.token;
+			return self->wr.writeBytes(size);
+		}
+		self->uncompressedSize = sizeof(UID) + size;
+		self->uncompressed = new (self->arena) uint8_t[self->uncompressedSize];
+		uint64_t token[2] = { self->destination.token.first(), self->destination.token.second() };
+		memcpy(self->uncompressed, token, sizeof(UID));
+		return self->uncompressed + sizeof(UID);
+	}
+
+	static void markForWipe(uint8_t* begin, size_t size, void* context) {
+		PacketCompressor* self = static_cast<PacketCompressor*>(context);
+		// The temporary buffer is wiped as a whole in serialize()
+		if (!self->uncompressed) {
+			PacketWriter::packetWriterMarkForWipe(begin, size, &self->wr);
+		}
+	}
+
+	// Returns true if the packet was written compressed
+	bool serialize(ISerializeSource const& what) {
+		ObjectWriter objectWriter(&PacketCompressor::allocate,
+		                          FLOW_KNOBS->WIPE_SENSITIVE_DATA_FROM_PACKET_BUFFER ? &PacketCompressor::markForWipe
+		                                                                             : nullptr,
+		                          this,
+		                          AssumeVersion(wr.protocolVersion()));
+		what.serializeObjectWriter(objectWriter);
+		if (!uncompressed) {
+			return false;
+		}
+
+		double compressStart = timer_monotonic();
+		StringRef compressed = CompressionUtils::compress(peer->compressionFilter,
+		                                                  StringRef(uncompressed, uncompressedSize),
+		                                                  FLOW_KNOBS->NETWORK_COMPRESSION_LEVEL,
+		                                                  arena);
+		bool useCompressed = compressed.size() + 1 < uncompressedSize;
+		if (useCompressed) {
+			uint8_t filter = static_cast<uint8_t>(peer->compressionFilter);
+			wr.serializeBinaryItem(filter);
+			wr.serializeBytes(compressed);
+		} else {
+			wr.serializeBytes(uncompressed, uncompressedSize);
+		}
+		peer->compressionTime += timer_monotonic() - compressStart;
+		peer->compressionBytesIn += uncompressedSize;
+		peer->compressionBytesOut += useCompressed ? compressed.size() + 1 : uncompressedSize;
+
+		if (FLOW_KNOBS->WIPE_SENSITIVE_DATA_FROM_PACKET_BUFFER) {
+			::memset(uncompressed, 0, uncompressedSize);
+		}
+		return useCompressed;
+	}
+};
+
 static ReliablePacket* sendPacket(TransportData* self,
                                   Reference<Peer> peer,
                                   ISerializeSource const& what,
@@ -1957,10 +2157,23 @@ static ReliablePacket* sendPacket(TransportData* self,
 	}
 
 	wr.writeAhead(packetInfoSize, &packetInfoBuffer);
-	wr << destination.token;
-	what.serializePacketWriter(wr);
+	bool compressed = false;
+	// Size of the packet once the receiver decompresses it, which is what it checks against PACKET_LIMIT
+	size_t uncompressedLen = 0;
+	if (peer->compressionFilter != CompressionFilter::NONE) {
+		PacketCompressor compressor(peer.getPtr(), wr, destination);
+		compressed = compressor.serialize(what);
+		uncompressedLen = compressor.uncompressedSize;
+		peer->compressedReliablePackets |= compressed && reliable;
+	} else {
+		wr << destination.token;
+		what.serializePacketWriter(wr);
+	}
 	pb = wr.finish();
 	len = wr.size() - packetInfoSize;
+	if (!compressed) {
+		uncompressedLen = len;
+	}
 
 	if (checksumEnabled) {
 		// Find the correct place to start calculating checksum
@@ -2010,21 +2223,23 @@ static ReliablePacket* sendPacket(TransportData* self,
 	}
 
 	// Write packet length and checksum into packet buffer
-	packetInfoBuffer.write(&len, sizeof(len));
+	uint32_t lenField = compressed ? len | PACKET_COMPRESSED_FLAG : len;
+	packetInfoBuffer.write(&lenField, sizeof(lenField));
 	if (checksumEnabled) {
 		packetInfoBuffer.write(&checksum, sizeof(checksum), sizeof(len));
 	}
 
-	if (len > FLOW_KNOBS->PACKET_LIMIT) {
+	if (uncompressedLen > FLOW_KNOBS->PACKET_LIMIT) {
 		TraceEvent(SevError, "PacketLimitExceeded")
 		    .detail("ToPeer", destination.getPrimaryAddress())
-		    .detail("Length", (int)len);
+		    .detail("Length", (int)uncompressedLen)
+		    .detail("CompressedLength", compressed ? (int)len : 0);
 		// throw platform_error();  // FIXME: How to recover from this situation?
-	} else if (len > FLOW_KNOBS->PACKET_WARNING) {
+	} else if (uncompressedLen > FLOW_KNOBS->PACKET_WARNING) {
 		TraceEvent(SevWarn, "LargePacketSent")
 		    .suppressFor(1.0)
 		    .detail("ToPeer", destination.getPrimaryAddress())
-		    .detail("Length", (int)len)
+		    .detail("Length", (int)uncompressedLen)
 		    .detail("Token", destination.token)
 		    .backtrace();
 	}
@@ -27,6 +27,7 @@
 
 #include "fdbrpc/DDSketch.h"
 #include "fdbrpc/HealthMonitor.h"
+#include "flow/CompressionUtils.h"
 #include "flow/genericactors.actor.h"
 #include "flow/network.h"
 #include "flow/FileIdentifier.h"
@@ -169,6 +170,16 @@ struct Peer : public ReferenceCounted<Peer> {
 	int64_t lastLoggedBytesReceived;
 	int64_t lastLoggedBytesSent;
 	int timeoutCount;
+	int64_t writeCount; // Calls to IConnection::write(), cleared every time stats are logged for this peer
+
+	// Compression used for packets sent on the current connection. It stays NONE until the remote ConnectPacket
+	// advertises support for the locally configured filter.
+	CompressionFilter compressionFilter;
+	bool compressedReliablePackets; // Some packet in reliable was sent compressed
+	int64_t compressionBytesIn; // Size of packets before compression
+	int64_t compressionBytesOut; // Size of the same packets on the wire
+	double compressionTime;
+	double decompressionTime;
 
 	Reference<AsyncVar<Optional<ProtocolVersion>>> protocolVersion;
 
@@ -2616,7 +2616,7 @@ public:
 	}
 
 	// Implementation
-	struct PromiseTask final : public FastAllocated<PromiseTask> {
+	struct PromiseTask final : public TaskQueueNode, public FastAllocated<PromiseTask> {
 		Promise<Void> promise;
 		ProcessInfo* machine;
 		swift::Job* _Nullable swiftJob = nullptr;
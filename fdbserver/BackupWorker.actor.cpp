@@ -123,6 +123,9 @@ struct BackupData {
 	Version minKnownCommittedVersion;
 	Version savedVersion; // Largest version saved to blob storage
 	Version popVersion; // Largest version popped in NOOP mode, can be larger than savedVersion.
+	// Largest version whose messages are written to log files and erased. The files may still be uploading, so this
+	// can be larger than savedVersion.
+	Version erasedVersion;
 	Reference<AsyncVar<ServerDBInfo> const> db;
 	AsyncVar<Reference<ILogSystem>> logSystem;
 	Database cx;
@@ -274,14 +277,19 @@ struct BackupData {
 	AsyncTrigger doneTrigger;
 
 	CounterCollection cc;
+	Counter uploadedBytes; // Bytes of mutation log files whose upload has completed
+	Counter uploadedFiles;
+	int64_t pendingUploadBytes = 0; // Bytes written to log files that are still being uploaded
+	int pendingUploads = 0; // Number of saveMutationsToFile() batches still being uploaded
 	Future<Void> logger;
 
 	explicit BackupData(UID id, Reference<AsyncVar<ServerDBInfo> const> db, const InitializeBackupRequest& req)
 	  : myId(id), tag(req.routerTag), totalTags(req.totalTags), startVersion(req.startVersion),
 	    endVersion(req.endVersion), recruitedEpoch(req.recruitedEpoch), backupEpoch(req.backupEpoch),
 	    minKnownCommittedVersion(invalidVersion), savedVersion(req.startVersion - 1), popVersion(req.startVersion - 1),
-	    db(db), pulledVersion(0), paused(false), lock(new FlowLock(SERVER_KNOBS->BACKUP_LOCK_BYTES)),
-	    cc("BackupWorker", myId.toString()) {
+	    erasedVersion(req.startVersion - 1), db(db), pulledVersion(0), paused(false),
+	    lock(new FlowLock(SERVER_KNOBS->BACKUP_LOCK_BYTES)),
+	    cc("BackupWorker", myId.toString()), uploadedBytes("UploadedBytes", cc), uploadedFiles("UploadedFiles", cc) {
 		cx = openDBOnServer(db, TaskPriority::DefaultEndpoint, LockAware::True);
 
 		specialCounter(cc, "SavedVersion", [this]() { return this->savedVersion; });
@@ -289,6 +297,8 @@ struct BackupData {
 		specialCounter(cc, "MsgQ", [this]() { return this->messages.size(); });
 		specialCounter(cc, "BufferedBytes", [this]() { return this->lock->activePermits(); });
 		specialCounter(cc, "AvailableBytes", [this]() { return this->lock->available(); });
+		specialCounter(cc, "PendingUploadBytes", [this]() { return this->pendingUploadBytes; });
+		specialCounter(cc, "PendingUploads", [this]() { return this->pendingUploads; });
 		logger =
 		    cc.traceCounters("BackupWorkerMetrics", myId, SERVER_KNOBS->WORKER_LOGGING_INTERVAL, "BackupWorkerMetrics");
 	}
@@ -677,9 +687,12 @@ ACTOR Future<Void> addMutation(Reference<IBackupFile> logFile,
 	// The decoder assumes 0xFF is the end, so little endian can easily be
 	// mistaken as the end. In contrast, big endian for version almost guarantee
 	// the first byte is not 0xFF (should always be 0x00).
+	// The header and the mutation are written with a single append, so that a
+	// mutation costs one write to the underlying file instead of two.
 	BinaryWriter wr(Unversioned());
 	wr << bigEndian64(message.version.version) << bigEndian32(message.version.sub) << bigEndian32(mutation.size());
-	state Standalone<StringRef> header = wr.toValue();
+	wr.serializeBytes(mutation);
+	state Standalone<StringRef> entry = wr.toValue();
 
 	// Start a new block if needed
 	if (logFile->size() + bytes > *blockEnd) {
@@ -695,8 +708,7 @@ ACTOR Future<Void> addMutation(Reference<IBackupFile> logFile,
 		wait(logFile->append((uint8_t*)&PARTITIONED_MLOG_VERSION, sizeof(PARTITIONED_MLOG_VERSION)));
 	}
 
-	wait(logFile->append((void*)header.begin(), header.size()));
-	wait(logFile->append(mutation.begin(), mutation.size()));
+	wait(logFile->append((void*)entry.begin(), entry.size()));
 	return Void();
 }
 
@@ -724,13 +736,55 @@ ACTOR static Future<Void> updateLogBytesWritten(BackupData* self,
 	}
 }
 
+// Log files written by one saveMutationsToFile() call. The files are complete
+// once "done" is ready, and only then can progress be saved up to popVersion.
+struct PendingLogUpload {
+	Version popVersion;
+	int64_t bytes;
+	Future<Void> done;
+};
+
+// Finishes the given log files, i.e., waits for their remaining parts to be
+// uploaded, and then updates the backups' logBytesWritten.
+ACTOR static Future<Void> finishMutationFiles(BackupData* self,
+                                              std::vector<UID> activeUids,
+                                              std::vector<Reference<IBackupFile>> logFiles,
+                                              int64_t bytes) {
+	state double startTime = now();
+	std::vector<Future<Void>> finished;
+	std::transform(logFiles.begin(), logFiles.end(), std::back_inserter(finished), [](const Reference<IBackupFile>& f) {
+		return f->finish();
+	});
+
+	wait(waitForAll(finished));
+
+	const double duration = now() - startTime;
+	for (const auto& file : logFiles) {
+		TraceEvent("CloseMutationFile", self->myId)
+		    .detail("FileSize", file->size())
+		    .detail("TagId", self->tag.id)
+		    .detail("File", file->getFileName())
+		    .detail("FinishSeconds", duration);
+	}
+	self->uploadedBytes += bytes;
+	self->uploadedFiles += logFiles.size();
+	self->pendingUploadBytes -= bytes;
+	self->pendingUploads--;
+
+	wait(updateLogBytesWritten(self, activeUids, logFiles));
+	return Void();
+}
+
 // Saves messages in the range of [0, numMsg) to a file and then remove these
 // messages. The file content format is a sequence of (Version, sub#, msgSize, message).
-// Note only ready backups are saved.
-ACTOR Future<Void> saveMutationsToFile(BackupData* self,
-                                       Version popVersion,
-                                       int numMsg,
-                                       std::unordered_set<BlobCipherDetails> cipherDetails) {
+// Note only ready backups are saved. The returned future is ready once all
+// messages are written to the files, i.e., the messages can be erased, while
+// the files' uploads are finished in the background. The caller must not save
+// progress for popVersion until the returned PendingLogUpload is done.
+ACTOR Future<PendingLogUpload> saveMutationsToFile(BackupData* self,
+                                                   Version popVersion,
+                                                   int numMsg,
+                                                   std::unordered_set<BlobCipherDetails> cipherDetails) {
 	state int blockSize = SERVER_KNOBS->BACKUP_FILE_BLOCK_BYTES;
 	state std::vector<Future<Reference<IBackupFile>>> logFileFutures;
 	state std::vector<Reference<IBackupFile>> logFiles;
@@ -762,7 +816,10 @@ ACTOR Future<Void> saveMutationsToFile(BackupData* self,
 				// True-up first mutation log's begin version
 				it->second.lastSavedVersion = self->messages[0].getVersion();
 			} else {
-				it->second.lastSavedVersion = std::max({ self->popVersion, self->savedVersion, self->startVersion });
+				// Messages are erased once written, before their files are uploaded and savedVersion advances, so
+				// the new backup starts after the last erased version rather than after savedVersion
+				it->second.lastSavedVersion = std::max(
+				    { self->popVersion, self->savedVersion, self->erasedVersion, self->startVersion });
 			}
 			TraceEvent("BackupWorkerTrueUp", self->myId).detail("LastSavedVersion", it->second.lastSavedVersion);
 		}
@@ -842,30 +899,30 @@ ACTOR Future<Void> saveMutationsToFile(BackupData* self,
 		mutations.clear();
 	}
 
-	std::vector<Future<Void>> finished;
-	std::transform(logFiles.begin(), logFiles.end(), std::back_inserter(finished), [](const Reference<IBackupFile>& f) {
-		return f->finish();
-	});
-
-	wait(waitForAll(finished));
-
-	for (const auto& file : logFiles) {
-		TraceEvent("CloseMutationFile", self->myId)
-		    .detail("FileSize", file->size())
-		    .detail("TagId", self->tag.id)
-		    .detail("File", file->getFileName());
-	}
 	for (const UID& uid : activeUids) {
 		self->backups[uid].lastSavedVersion = popVersion + 1;
 	}
 
-	wait(updateLogBytesWritten(self, activeUids, logFiles));
-	return Void();
+	PendingLogUpload upload;
+	upload.popVersion = popVersion;
+	upload.bytes = 0;
+	for (const auto& file : logFiles) {
+		upload.bytes += file->size();
+	}
+	self->pendingUploadBytes += upload.bytes;
+	self->pendingUploads++;
+	upload.done = finishMutationFiles(self, activeUids, logFiles, upload.bytes);
+	return upload;
 }
 
-// Uploads self->messages to cloud storage and updates savedVersion.
+// Uploads self->messages to cloud storage and updates savedVersion. Log files
+// are written in version order, but up to BACKUP_MAX_PENDING_UPLOAD_BYTES of
+// them can still be uploading while the next files are written. Progress is
+// saved, and tLogs popped, only up to the oldest file that is not yet uploaded.
 ACTOR Future<Void> uploadData(BackupData* self) {
 	state Version popVersion = invalidVersion;
+	state std::deque<PendingLogUpload> pendingUploads;
+	state Version uploadedVersion = invalidVersion; // all files up to this version are uploaded
 
 	loop {
 		// Too large uploadDelay will delay popping tLog data for too long.
@@ -912,8 +969,20 @@ ACTOR Future<Void> uploadData(BackupData* self) {
 			    .detail("NumMsg", numMsg)
 			    .detail("MsgQ", self->messages.size());
 			// save an empty file for old epochs so that log file versions are continuous
-			wait(saveMutationsToFile(self, popVersion, numMsg, cipherDetails));
+			PendingLogUpload upload = wait(saveMutationsToFile(self, popVersion, numMsg, cipherDetails));
+			pendingUploads.push_back(upload);
 			self->eraseMessages(numMsg);
+			self->erasedVersion = std::max(self->erasedVersion, popVersion);
+		}
+
+		// Bound the bytes of log files held in memory while being uploaded, and
+		// flush everything once pulling is done so that the worker can finish.
+		while (!pendingUploads.empty() &&
+		       (pendingUploads.front().done.isReady() || self->pullFinished() ||
+		        self->pendingUploadBytes >= SERVER_KNOBS->BACKUP_MAX_PENDING_UPLOAD_BYTES)) {
+			wait(pendingUploads.front().done);
+			uploadedVersion = pendingUploads.front().popVersion;
+			pendingUploads.pop_front();
 		}
 
 		// If transition into NOOP mode, should clear messages
@@ -921,13 +990,16 @@ ACTOR Future<Void> uploadData(BackupData* self) {
 			self->eraseMessages(self->messages.size());
 		}
 
-		if (popVersion > self->savedVersion && popVersion > self->popVersion) {
-			wait(saveProgress(self, popVersion));
+		// Versions without files still uploading, e.g., in NOOP mode, are durable.
+		state Version progressVersion = pendingUploads.empty() ? popVersion : uploadedVersion;
+		if (progressVersion > self->savedVersion && progressVersion > self->popVersion) {
+			wait(saveProgress(self, progressVersion));
 			TraceEvent("BackupWorkerSavedProgress", self->myId)
 			    .detail("Tag", self->tag.toString())
-			    .detail("Version", popVersion)
+			    .detail("Version", progressVersion)
+			    .detail("PendingUploads", pendingUploads.size())
 			    .detail("MsgQ", self->messages.size());
-			self->savedVersion = std::max(popVersion, self->savedVersion);
+			self->savedVersion = std::max(progressVersion, self->savedVersion);
 			self->pop();
 		}
 
@@ -936,7 +1008,9 @@ ACTOR Future<Void> uploadData(BackupData* self) {
 		}
 
 		if (!self->pullFinished()) {
-			wait(uploadDelay || self->doneTrigger.onTrigger());
+			// Wake up early when the oldest upload completes to advance progress.
+			wait(uploadDelay || self->doneTrigger.onTrigger() ||
+			     (pendingUploads.empty() ? Never() : pendingUploads.front().done));
 		}
 	}
 }
@@ -1512,6 +1512,13 @@ ACTOR Future<Void> statusServer(FutureStream<StatusRequest> requests,
 	// Place to accumulate a batch of requests to respond to
 	state std::vector<StatusRequest> requests_batch;
 
+	// The last status generated and when its generation started, for answering requests within STATUS_MAX_STALENESS
+	state Optional<StatusReply> lastStatus;
+	state double lastStatusTime = 0.0;
+
+	// Worker events reused across status requests
+	state WorkerEventCache workerEventCache;
+
 	loop {
 		try {
 			// Wait til first request is ready
@@ -1544,50 +1551,65 @@ ACTOR Future<Void> statusServer(FutureStream<StatusRequest> requests,
 				}
 			}
 
-			// Get status but trap errors to send back to client.
-			std::vector<WorkerDetails> workers;
-			std::vector<ProcessIssues> workerIssues;
+			state ErrorOr<StatusReply> result;
+			if (lastStatus.present() && now() - lastStatusTime <= SERVER_KNOBS->STATUS_MAX_STALENESS) {
+				CODE_PROBE(true, "Status request answered with the last status");
+				result = lastStatus.get();
+			} else {
+				state double statusStartTime = now();
+				// Get status but trap errors to send back to client.
+				std::vector<WorkerDetails> workers;
+				std::vector<ProcessIssues> workerIssues;
+
+				for (auto& it : self->id_worker) {
+					workers.push_back(it.second.details);
+					if (it.second.issues.size()) {
+						workerIssues.emplace_back(it.second.details.interf.address(), it.second.issues);
+					}
+				}
 
-			for (auto& it : self->id_worker) {
-				workers.push_back(it.second.details);
-				if (it.second.issues.size()) {
-					workerIssues.emplace_back(it.second.details.interf.address(), it.second.issues);
+				std::vector<NetworkAddress> incompatibleConnections;
+				auto& connections = self->db.incompatibleConnections;
+				for (auto it = connections.begin(); it != connections.end();) {
+					if (it->second < now()) {
+						it = connections.erase(it);
+					} else {
+						incompatibleConnections.push_back(it->first);
+						it++;
+					}
 				}
-			}
 
-			std::vector<NetworkAddress> incompatibleConnections;
-			for (auto it = self->db.incompatibleConnections.begin(); it != self->db.incompatibleConnections.end();) {
-				if (it->second < now()) {
-					it = self->db.incompatibleConnections.erase(it);
-				} else {
-					incompatibleConnections.push_back(it->first);
-					it++;
+				ErrorOr<StatusReply> _result = wait(errorOr(clusterGetStatus(self->db.serverInfo,
+				                                                             self->cx,
+				                                                             workers,
+				                                                             workerIssues,
+				                                                             self->storageStatusInfos,
+				                                                             &self->db.clientStatus,
+				                                                             coordinators,
+				                                                             incompatibleConnections,
+				                                                             self->datacenterVersionDifference,
+				                                                             self->dcLogServerVersionDifference,
+				                                                             self->dcStorageServerVersionDifference,
+				                                                             configBroadcaster,
+				                                                             self->db.metaclusterRegistration,
+				                                                             self->db.metaclusterMetrics,
+				                                                             self->excludedDegradedServers,
+				                                                             &workerEventCache)));
+				result = _result;
+
+				if (result.isError() && result.getError().code() == error_code_actor_cancelled)
+					throw result.getError();
+
+				// Update last_request_time now because GetStatus is finished and the delay is to be measured between
+				// requests
+				last_request_time = now();
+
+				if (!result.isError()) {
+					lastStatus = result.get();
+					lastStatusTime = statusStartTime;
 				}
 			}
 
-			state ErrorOr<StatusReply> result = wait(errorOr(clusterGetStatus(self->db.serverInfo,
-			                                                                  self->cx,
-			                                                                  workers,
-			                                                                  workerIssues,
-			                                                                  self->storageStatusInfos,
-			                                                                  &self->db.clientStatus,
-			                                                                  coordinators,
-			                                                                  incompatibleConnections,
-			                                                                  self->datacenterVersionDifference,
-			                                                                  self->dcLogServerVersionDifference,
-			                                                                  self->dcStorageServerVersionDifference,
-			                                                                  configBroadcaster,
-			                                                                  self->db.metaclusterRegistration,
-			                                                                  self->db.metaclusterMetrics,
-			                                                                  self->excludedDegradedServers)));
-
-			if (result.isError() && result.getError().code() == error_code_actor_cancelled)
-				throw result.getError();
-
-			// Update last_request_time now because GetStatus is finished and the delay is to be measured between
-			// requests
-			last_request_time = now();
-
 			state Optional<StatusReply> faultToleranceRelatedStatus;
 			while (!requests_batch.empty()) {
 				if (result.isError())
@@ -66,6 +66,12 @@ inline bool isValleyFillerPriority(int priority) {
 	       priority == SERVER_KNOBS->PRIORITY_REBALANCE_READ_UNDERUTIL_TEAM;
 }
 
+inline bool isRebalancePriority(int priority) {
+	return isValleyFillerPriority(priority) || priority == SERVER_KNOBS->PRIORITY_REBALANCE_OVERUTILIZED_TEAM ||
+	       priority == SERVER_KNOBS->PRIORITY_REBALANCE_READ_OVERUTIL_TEAM ||
+	       priority == SERVER_KNOBS->PRIORITY_REBALANCE_STORAGE_QUEUE;
+}
+
 inline bool isDataMovementForValleyFiller(DataMovementReason reason) {
 	return reason == DataMovementReason::REBALANCE_UNDERUTILIZED_TEAM ||
 	       reason == DataMovementReason::REBALANCE_READ_UNDERUTIL_TEAM;
@@ -129,7 +135,8 @@ DataMovementReason priorityToDataMovementReason(int priority) {
 
 RelocateData::RelocateData()
   : priority(-1), boundaryPriority(-1), healthPriority(-1), reason(RelocateReason::OTHER), startTime(-1),
-    dataMoveId(anonymousShardId), workFactor(0), wantsNewServers(false), cancellable(false),
+    dataMoveId(anonymousShardId), workFactor(0), destBytes(0), destLaunchTime(0), wantsNewServers(false),
+    cancellable(false),
     interval("QueuedRelocation"){};
 
 RelocateData::RelocateData(RelocateShard const& rs)
@@ -137,7 +144,7 @@ RelocateData::RelocateData(RelocateShard const& rs)
     boundaryPriority(isBoundaryPriority(rs.priority) ? rs.priority : -1),
     healthPriority(isHealthPriority(rs.priority) ? rs.priority : -1), reason(rs.reason), dmReason(rs.moveReason),
     startTime(now()), randomId(rs.traceId.isValid() ? rs.traceId : deterministicRandom()->randomUniqueID()),
-    dataMoveId(rs.dataMoveId), workFactor(0),
+    dataMoveId(rs.dataMoveId), workFactor(0), destBytes(0), destLaunchTime(0),
     wantsNewServers(isDataMovementForMountainChopper(rs.moveReason) || isDataMovementForValleyFiller(rs.moveReason) ||
                     rs.moveReason == DataMovementReason::SPLIT_SHARD ||
                     rs.moveReason == DataMovementReason::TEAM_REDUNDANT ||
@@ -414,6 +421,32 @@ std::string Busyness::toString() {
 	return result;
 }
 
+DestBandwidth::DestBandwidth()
+  : bytesInFlight(0), bytesPerSecond(SERVER_KNOBS->DD_DEST_BANDWIDTH_INITIAL_BYTES_PER_SECOND) {}
+
+int64_t DestBandwidth::budget(int prio) const {
+	double bytes = bytesPerSecond * SERVER_KNOBS->DD_DEST_BANDWIDTH_WINDOW;
+	if (isRebalancePriority(prio)) {
+		bytes *= SERVER_KNOBS->DD_REBALANCE_DEST_BANDWIDTH_FRACTION;
+	}
+	return static_cast<int64_t>(bytes);
+}
+
+bool DestBandwidth::canLaunch(int prio, int64_t bytes) const {
+	// A server with nothing in flight always takes one move, so shards larger than the budget still make progress
+	return bytesInFlight == 0 || bytesInFlight + bytes <= budget(prio);
+}
+
+// Called when a move of bytes to this server finishes after seconds. The server's throughput is estimated from all the
+// bytes it had in flight (Little's law) rather than from this move alone, since concurrent moves share its bandwidth.
+void DestBandwidth::recordTransfer(int64_t bytes, double seconds) {
+	if (bytes <= 0 || seconds <= 0) {
+		return;
+	}
+	const double sample = std::max(bytesInFlight, bytes) / seconds;
+	bytesPerSecond += SERVER_KNOBS->DD_DEST_BANDWIDTH_SMOOTHING * (sample - bytesPerSecond);
+}
+
 // find the "workFactor" for this, were it launched now
 int getSrcWorkFactor(RelocateData const& relocation, int singleRegionTeamSize) {
 	if (relocation.bulkLoadTask.present())
@@ -493,16 +526,28 @@ bool canLaunchSrc(RelocateData& relocation,
 // candidateTeams is a vector containing one team per datacenter, the team(s) DD is planning on moving the shard to.
 bool canLaunchDest(const std::vector<std::pair<Reference<IDataDistributionTeam>, bool>>& candidateTeams,
                    int priority,
-                   std::map<UID, Busyness>& busymapDest) {
-	// fail switch if this is causing issues
-	if (SERVER_KNOBS->RELOCATION_PARALLELISM_PER_DEST_SERVER <= 0) {
-		return true;
+                   int64_t bytes,
+                   std::map<UID, Busyness>& busymapDest,
+                   std::map<UID, DestBandwidth>& bandwidthDest) {
+	// The per destination relocation count is a hard cap. The bandwidth budget is checked on top of it, since small
+	// shards add almost no bytes and would otherwise let one destination take any number of concurrent relocations.
+	// Setting RELOCATION_PARALLELISM_PER_DEST_SERVER to 0 is a fail switch for the count limit if it causes issues.
+	if (SERVER_KNOBS->RELOCATION_PARALLELISM_PER_DEST_SERVER > 0) {
+		int workFactor = getDestWorkFactor();
+		for (auto& [team, _] : candidateTeams) {
+			for (UID id : team->getServerIDs()) {
+				if (!busymapDest[id].canLaunch(priority, workFactor)) {
+					return false;
+				}
+			}
+		}
 	}
-	int workFactor = getDestWorkFactor();
-	for (auto& [team, _] : candidateTeams) {
-		for (UID id : team->getServerIDs()) {
-			if (!busymapDest[id].canLaunch(priority, workFactor)) {
-				return false;
+	if (SERVER_KNOBS->DD_BANDWIDTH_AWARE_RELOCATION) {
+		for (auto& [team, _] : candidateTeams) {
+			for (UID id : team->getServerIDs()) {
+				if (!bandwidthDest[id].canLaunch(priority, bytes)) {
+					return false;
+				}
 			}
 		}
 	}
@@ -519,29 +564,48 @@ void launch(RelocateData& relocation, std::map<UID, Busyness>& busymap, int sing
 
 void launchDest(RelocateData& relocation,
                 const std::vector<std::pair<Reference<IDataDistributionTeam>, bool>>& candidateTeams,
-                std::map<UID, Busyness>& destBusymap) {
+                int64_t bytes,
+                std::map<UID, Busyness>& destBusymap,
+                std::map<UID, DestBandwidth>& destBandwidth) {
 	ASSERT(relocation.completeDests.empty());
 	int destWorkFactor = getDestWorkFactor();
+	relocation.destBytes = bytes;
+	relocation.destLaunchTime = now();
 	for (auto& [team, _] : candidateTeams) {
 		for (UID id : team->getServerIDs()) {
 			relocation.completeDests.push_back(id);
 			destBusymap[id].addWork(relocation.priority, destWorkFactor);
+			destBandwidth[id].bytesInFlight += bytes;
 		}
 	}
 }
-void completeDest(RelocateData const& relocation, std::map<UID, Busyness>& destBusymap) {
+void completeDest(RelocateData const& relocation,
+                  std::map<UID, Busyness>& destBusymap,
+                  std::map<UID, DestBandwidth>& destBandwidth) {
 	int destWorkFactor = getDestWorkFactor();
 	for (UID id : relocation.completeDests) {
 		destBusymap[id].removeWork(relocation.priority, destWorkFactor);
+		destBandwidth[id].bytesInFlight -= relocation.destBytes;
+	}
+}
+
+// Feeds the duration of a successful transfer into the throughput estimate of each destination. Must be called
+// before completeDest() releases the relocation's bytes.
+void recordDestTransfer(RelocateData const& relocation, std::map<UID, DestBandwidth>& destBandwidth) {
+	for (UID id : relocation.completeDests) {
+		destBandwidth[id].recordTransfer(relocation.destBytes, now() - relocation.destLaunchTime);
 	}
 }
 
-void complete(RelocateData const& relocation, std::map<UID, Busyness>& busymap, std::map<UID, Busyness>& destBusymap) {
+void complete(RelocateData const& relocation,
+              std::map<UID, Busyness>& busymap,
+              std::map<UID, Busyness>& destBusymap,
+              std::map<UID, DestBandwidth>& destBandwidth) {
 	ASSERT(relocation.bulkLoadTask.present() || relocation.workFactor > 0);
 	for (int i = 0; i < relocation.src.size(); i++)
 		busymap[relocation.src[i]].removeWork(relocation.priority, relocation.workFactor);
 
-	completeDest(relocation, destBusymap);
+	completeDest(relocation, destBusymap, destBandwidth);
 }
 
 // Cancels in-flight data moves intersecting with range.
@@ -1039,6 +1103,50 @@ bool runPendingBulkLoadTaskWithRelocateData(DDQueue* self, RelocateData& rd) {
 	return doBulkLoading;
 }
 
+int DDQueue::preemptRebalances(RelocateData const& rd, const DDEnabledState* ddEnabledState) {
+	std::vector<RelocateData> victims;
+	for (auto& [_, inFlightRd] : preemptibleRelocations) {
+		for (UID id : inFlightRd.src) {
+			if (std::find(rd.src.begin(), rd.src.end(), id) != rd.src.end()) {
+				victims.push_back(inFlightRd);
+				break;
+			}
+		}
+	}
+	// Cancelling a relocator removes it from preemptibleRelocations, so the victims are collected first
+	for (auto& victim : victims) {
+		CODE_PROBE(true, "Unhealthy relocation preempts a rebalance");
+		TraceEvent(SevDebug, "DDPreemptRebalance", distributorId)
+		    .detail("KeyBegin", victim.keys.begin)
+		    .detail("KeyEnd", victim.keys.end)
+		    .detail("Priority", victim.priority)
+		    .detail("PreemptingPriority", rd.priority)
+		    .detail("Src", describe(victim.src));
+		// As when launchQueuedWork() replaces a relocation: the cancelled relocator releases its source servers' work
+		// through dataTransferComplete, so its inFlight entry must no longer count as cancellable work, and any data
+		// move it started is cleaned up
+		inFlightActors.cancel(victim.keys);
+		auto victimRanges = inFlight.intersectingRanges(victim.keys);
+		for (auto it = victimRanges.begin(); it != victimRanges.end(); ++it) {
+			if (it->value().randomId == victim.randomId) {
+				it->value().cancellable = false;
+			}
+		}
+		if (SERVER_KNOBS->SHARD_ENCODE_LOCATION_METADATA) {
+			noErrorActors.add(cancelDataMove(this, victim.keys, ddEnabledState));
+		}
+		preemptedRelocations++;
+	}
+	return victims.size();
+}
+
+void clearPreemptible(DDQueue* self, RelocateData const& rd) {
+	auto it = self->preemptibleRelocations.find(rd.keys.begin);
+	if (it != self->preemptibleRelocations.end() && it->second.randomId == rd.randomId) {
+		self->preemptibleRelocations.erase(it);
+	}
+}
+
 // For each relocateData rd in the queue, check if there exist inflight relocate data whose keyrange is overlapped
 // with rd. If there exist, cancel them by cancelling their actors and reducing the src servers' busyness of those
 // canceled inflight relocateData. Launch the relocation for the rd.
@@ -1103,6 +1211,12 @@ void DDQueue::launchQueuedWork(std::set<RelocateData, std::greater<RelocateData>
 		// FIXME: we need spare capacity even when we're just going to be cancelling work via TEAM_HEALTHY
 		if (!rd.isRestore() && !canLaunchSrc(rd, teamSize, singleRegionTeamSize, busymap, cancellableRelocations)) {
 			// logRelocation( rd, "SkippingQueuedRelocation" );
+			// The source servers' work is released asynchronously through dataTransferComplete, which launches rd
+			// again from these servers
+			if (SERVER_KNOBS->DD_BANDWIDTH_AWARE_RELOCATION &&
+			    rd.healthPriority >= SERVER_KNOBS->PRIORITY_TEAM_UNHEALTHY) {
+				preemptRebalances(rd, ddEnabledState);
+			}
 			if (rd.bulkLoadTask.present()) {
 				TraceEvent(g_network->isSimulated() ? SevError : SevWarnAlways,
 				           "DDBulkLoadDelayedByBusySrc",
@@ -1542,6 +1656,12 @@ ACTOR Future<Void> dataDistributionRelocator(DDQueue* self,
 
 		state std::unordered_set<uint64_t> excludedDstPhysicalShards;
 
+		// Until it has a destination a rebalance holds its source servers' work without moving any data, so unhealthy
+		// relocations on the same servers may preempt it
+		if (SERVER_KNOBS->DD_BANDWIDTH_AWARE_RELOCATION && isRebalancePriority(rd.priority) && !rd.isRestore()) {
+			self->preemptibleRelocations[rd.keys.begin] = rd;
+		}
+
 		ASSERT(rd.src.size());
 		loop {
 			destOverloadedCount = 0;
@@ -1784,7 +1904,8 @@ ACTOR Future<Void> dataDistributionRelocator(DDQueue* self,
 
 				// once we've found healthy candidate teams, make sure they're not overloaded with outstanding moves
 				// already
-				anyDestOverloaded = !canLaunchDest(bestTeams, rd.priority, self->destBusymap);
+				anyDestOverloaded =
+				    !canLaunchDest(bestTeams, rd.priority, metrics.bytes, self->destBusymap, self->destBandwidth);
 
 				if (foundTeams && anyHealthy && !anyDestOverloaded) {
 					ASSERT(rd.completeDests.empty());
@@ -1895,6 +2016,7 @@ ACTOR Future<Void> dataDistributionRelocator(DDQueue* self,
 			ASSERT(inFlightRange.range() == rd.keys);
 			ASSERT(inFlightRange.value().randomId == rd.randomId);
 			inFlightRange.value().cancellable = false;
+			clearPreemptible(self, rd);
 
 			destIds.clear();
 			state std::vector<UID> healthyIds;
@@ -1966,7 +2088,7 @@ ACTOR Future<Void> dataDistributionRelocator(DDQueue* self,
 			healthyDestinations.addDataInFlightToTeam(+metrics.bytes);
 			healthyDestinations.addReadInFlightToTeam(+metrics.readLoadKSecond());
 
-			launchDest(rd, bestTeams, self->destBusymap);
+			launchDest(rd, bestTeams, metrics.bytes, self->destBusymap, self->destBandwidth);
 
 			TraceEvent ev(relocateShardInterval.severity, "RelocateShardHasDestination", distributorId);
 			RelocateDecision decision{ rd, destIds, extraIds, metrics, parentMetrics };
@@ -2088,6 +2210,7 @@ ACTOR Future<Void> dataDistributionRelocator(DDQueue* self,
 						when(wait(signalledTransferComplete ? Never() : dataMovementComplete.getFuture())) {
 							self->fetchKeysComplete.insert(rd);
 							if (!signalledTransferComplete) {
+								recordDestTransfer(rd, self->destBandwidth);
 								signalledTransferComplete = true;
 								self->dataTransferComplete.send(rd);
 							}
@@ -2148,6 +2271,7 @@ ACTOR Future<Void> dataDistributionRelocator(DDQueue* self,
 					}
 
 					if (!signalledTransferComplete) {
+						recordDestTransfer(rd, self->destBandwidth);
 						signalledTransferComplete = true;
 						dataTransferComplete.send(rd);
 					}
@@ -2211,7 +2335,7 @@ ACTOR Future<Void> dataDistributionRelocator(DDQueue* self,
 				if (!signalledTransferComplete) {
 					// signalling transferComplete calls completeDest() in complete(), so doing so here would
 					// double-complete the work
-					completeDest(rd, self->destBusymap);
+					completeDest(rd, self->destBusymap, self->destBandwidth);
 				}
 				rd.completeDests.clear();
 
@@ -2220,6 +2344,7 @@ ACTOR Future<Void> dataDistributionRelocator(DDQueue* self,
 		}
 	} catch (Error& e) {
 		state Error err = e;
+		clearPreemptible(self, rd);
 		TraceEvent(relocateShardInterval.end(), distributorId)
 		    .errorUnsuppressed(err)
 		    .detail("Duration", now() - startTime);
@@ -2693,7 +2818,7 @@ struct DDQueueImpl {
 						launchData = results;
 					}
 					when(RelocateData done = waitNext(self->dataTransferComplete.getFuture())) {
-						complete(done, self->busymap, self->destBusymap);
+						complete(done, self->busymap, self->destBusymap, self->destBandwidth);
 						if (serversToLaunchFrom.empty() && !done.src.empty())
 							launchQueuedWorkTimeout = delay(0, TaskPriority::DataDistributionLaunch);
 						serversToLaunchFrom.insert(done.src.begin(), done.src.end());
@@ -2732,6 +2857,7 @@ struct DDQueueImpl {
 						    .detail("InQueue", self->queuedRelocations)
 						    .detail("AverageShardSize", req.getFuture().isReady() ? req.getFuture().get() : -1)
 						    .detail("UnhealthyRelocations", self->unhealthyRelocations)
+						    .detail("PreemptedRelocations", self->preemptedRelocations)
 						    .detail("HighestPriority", highestPriorityRelocation)
 						    .detail("BytesWritten", self->moveBytesRate.getTotal())
 						    .detail("BytesWrittenAverageRate", self->moveBytesRate.getAverage())
@@ -2855,3 +2981,34 @@ TEST_CASE("/DataDistribution/DDQueue/ServerCounterTrace") {
 	std::cout << "Finished.";
 	return Void();
 }
+
+TEST_CASE("/DataDistribution/DDQueue/DestBandwidth") {
+	const int prio = SERVER_KNOBS->PRIORITY_TEAM_UNHEALTHY;
+	const int rebalancePrio = SERVER_KNOBS->PRIORITY_REBALANCE_OVERUTILIZED_TEAM;
+	DestBandwidth bandwidth;
+	bandwidth.bytesPerSecond = 1e6;
+	const int64_t budget = bandwidth.budget(prio);
+	ASSERT(bandwidth.budget(rebalancePrio) <= budget);
+
+	// An idle server takes a move of any size
+	ASSERT(bandwidth.canLaunch(prio, budget * 10));
+	ASSERT(bandwidth.canLaunch(rebalancePrio, budget * 10));
+
+	bandwidth.bytesInFlight = budget / 2;
+	ASSERT(bandwidth.canLaunch(prio, budget - bandwidth.bytesInFlight));
+	ASSERT(!bandwidth.canLaunch(prio, budget - bandwidth.bytesInFlight + 1));
+
+	// Moves that finish faster than estimated raise the budget, slower ones lower it
+	bandwidth.recordTransfer(budget / 2, 0.001);
+	ASSERT(bandwidth.bytesPerSecond > 1e6);
+	const double fast = bandwidth.bytesPerSecond;
+	bandwidth.recordTransfer(budget / 2, 1e6);
+	ASSERT(bandwidth.bytesPerSecond < fast);
+
+	// Empty or instantaneous transfers carry no information
+	const double before = bandwidth.bytesPerSecond;
+	bandwidth.recordTransfer(0, 1.0);
+	bandwidth.recordTransfer(budget, 0);
+	ASSERT(bandwidth.bytesPerSecond == before);
+	return Void();
+}
@@ -350,11 +350,14 @@ ACTOR Future<Void> trackShardMetrics(DataDistributionTracker::SafeAccessor self,
 	}
 }
 
+ACTOR Future<Void> splitReadHotShard(DataDistributionTracker* self, KeyRange keys);
+
 ACTOR Future<Void> readHotDetector(DataDistributionTracker* self) {
+	state Standalone<VectorRef<ReadHotRangeWithMetrics>> readHotRanges;
 	try {
 		loop {
 			state KeyRange keys = waitNext(self->readHotShard.getFuture());
-			Standalone<VectorRef<ReadHotRangeWithMetrics>> readHotRanges = wait(self->db->getReadHotRanges(keys));
+			wait(store(readHotRanges, self->db->getReadHotRanges(keys)));
 
 			for (const auto& keyRange : readHotRanges) {
 				TraceEvent("ReadHotRangeLog")
@@ -364,6 +367,10 @@ ACTOR Future<Void> readHotDetector(DataDistributionTracker* self) {
 				    .detail("KeyRangeBegin", keyRange.keys.begin)
 				    .detail("KeyRangeEnd", keyRange.keys.end);
 			}
+
+			if (SERVER_KNOBS->DD_SPLIT_READ_HOT_KEY_RANGES && SERVER_KNOBS->READ_SAMPLING_ENABLED) {
+				wait(splitReadHotShard(self, keys));
+			}
 		}
 	} catch (Error& e) {
 		if (e.code() != error_code_actor_cancelled) {
@@ -499,12 +506,13 @@ void executeShardSplit(DataDistributionTracker* self,
                        Standalone<VectorRef<KeyRef>> splitKeys,
                        Reference<AsyncVar<Optional<ShardMetrics>>> shardSize,
                        bool relocate,
-                       RelocateReason reason) {
+                       RelocateReason reason,
+                       Optional<int> keepInPlace = Optional<int>()) {
 
 	int numShards = splitKeys.size() - 1;
 	ASSERT(numShards > 1);
 
-	int skipRange = deterministicRandom()->randomInt(0, numShards);
+	int skipRange = keepInPlace.present() ? keepInPlace.get() : deterministicRandom()->randomInt(0, numShards);
 
 	auto s = describeSplit(keys, splitKeys);
 	TraceEvent(SevInfo, "ExecutingShardSplit").suppressFor(0.5).detail("Splitting", s).detail("NumShards", numShards);
@@ -539,6 +547,76 @@ void executeShardSplit(DataDistributionTracker* self,
 	self->actors.add(changeSizes(self, keys, shardSize->get().get().metrics.bytes, "ShardSplit"));
 }
 
+// Splits a read hot shard around the key ranges its storage servers' sketches report as hot. Every hot range becomes
+// its own shard and is moved to a new team, while one of the cold pieces stays where it is.
+ACTOR Future<Void> splitReadHotShard(DataDistributionTracker* self, KeyRange keys) {
+	Standalone<VectorRef<ReadHotRangeWithMetrics>> hotRanges = wait(self->db->getReadHotKeyRanges(keys));
+
+	auto shard = self->shards->rangeContaining(keys.begin);
+	if (shard->range() != keys || !shard->value().stats->get().present()) {
+		// The shard was split or merged while its storage servers were queried
+		return Void();
+	}
+	const double shardReadBandwidth = shard->value().stats->get().get().metrics.bytesReadPerKSecond / 1000.0;
+
+	std::vector<KeyRangeRef> hot;
+	for (const auto& hotRange : hotRanges) {
+		if (hotRange.readBandwidthSec < SERVER_KNOBS->DD_READ_HOT_KEY_RANGE_MIN_FRACTION * shardReadBandwidth ||
+		    hotRange.keys.begin < (hot.empty() ? keys.begin : hot.back().end)) {
+			continue;
+		}
+		// A shard of a single key is too small for the shard merger to leave alone, and its reads cannot be spread
+		// by splitting it further, so a lone hot key stays with its neighbours
+		if (hotRange.keys.singleKeyRange()) {
+			CODE_PROBE(true, "Read hot split skips a single hot key");
+			continue;
+		}
+		hot.emplace_back(hotRange.keys.begin, std::min(hotRange.keys.end, keys.end));
+	}
+
+	// Pieces alternate between the cold gaps and the hot ranges
+	Standalone<VectorRef<KeyRef>> splitKeys;
+	std::vector<bool> pieceIsHot;
+	KeyRef cursor = keys.begin;
+	splitKeys.push_back_deep(splitKeys.arena(), keys.begin);
+	for (const auto& range : hot) {
+		if (range.begin > cursor) {
+			splitKeys.push_back_deep(splitKeys.arena(), range.begin);
+			pieceIsHot.push_back(false);
+		}
+		splitKeys.push_back_deep(splitKeys.arena(), range.end);
+		pieceIsHot.push_back(true);
+		cursor = range.end;
+	}
+	if (cursor < keys.end) {
+		splitKeys.push_back_deep(splitKeys.arena(), keys.end);
+		pieceIsHot.push_back(false);
+	}
+
+	const int numShards = splitKeys.size() - 1;
+	if (numShards < 2) {
+		return Void();
+	}
+
+	Optional<int> keepInPlace;
+	for (int i = 0; i < numShards && !keepInPlace.present(); ++i) {
+		if (!pieceIsHot[i]) {
+			keepInPlace = i;
+		}
+	}
+
+	CODE_PROBE(true, "Split read hot shard around hot key ranges");
+	TraceEvent("RelocateShardStartReadHotSplit", self->distributorId)
+	    .suppressFor(1.0)
+	    .detail("Begin", keys.begin)
+	    .detail("End", keys.end)
+	    .detail("ReadBandwidth", shardReadBandwidth)
+	    .detail("HotRanges", hotRanges.size())
+	    .detail("NumShards", numShards);
+	executeShardSplit(self, keys, splitKeys, shard->value().stats, true, RelocateReason::READ_SPLIT, keepInPlace);
+	return Void();
+}
+
 struct RangeToSplit {
 	RangeMap<Standalone<StringRef>, ShardTrackedData, KeyRangeRef>::iterator shard;
 	Standalone<VectorRef<KeyRef>> faultLines;
@@ -5061,36 +5061,40 @@ int DDTeamCollection::addBestMachineTeams(int machineTeamsToBuild) {
 	// Step 1: Create machineLocalityMap which will be used in building machine team
 	rebuildMachineLocalityMap();
 
+	// Index the machines by their number of machine teams. Machine health and locality do not change while teams are
+	// being built, so only the members of each added machine team need to be updated afterwards.
+	// healthyMachines answers notEnoughMachineTeamsForAMachine(), candidateMachines holds the machines that may be
+	// chosen for a new machine team.
+	TeamCountIndex<TCMachineInfo> healthyMachines;
+	TeamCountIndex<TCMachineInfo> candidateMachines;
+	for (auto& machine : machine_info) {
+		// Skip invalid machine whose representative server is not in server_info
+		ASSERT_WE_THINK(server_info.find(machine.second->serversOnMachine[0]->getId()) != server_info.end());
+		// Skip unhealthy machines
+		if (!isMachineHealthy(machine.second))
+			continue;
+		// Invariant: We only create correct size machine teams.
+		// When configuration (e.g., team size) is changed, the DDTeamCollection will be destroyed and rebuilt
+		// so that the invariant will not be violated.
+		int teamCount = machine.second->machineTeams.size();
+		healthyMachines.add(machine.second, teamCount);
+		// Skip machine with incomplete locality
+		if (!isValidLocality(configuration.storagePolicy,
+		                     machine.second->serversOnMachine[0]->getLastKnownInterface().locality)) {
+			continue;
+		}
+		candidateMachines.add(machine.second, teamCount);
+	}
+	const int targetMachineTeamNumPerMachine = getTargetMachineTeamNumPerMachine();
+
 	// Add a team in each iteration
-	while (addedMachineTeams < machineTeamsToBuild || notEnoughMachineTeamsForAMachine()) {
+	while (addedMachineTeams < machineTeamsToBuild ||
+	       (!healthyMachines.empty() && healthyMachines.minTeamCount() < targetMachineTeamNumPerMachine)) {
 		// Step 2: Get least used machines from which we choose machines as a machine team
-		std::vector<Reference<TCMachineInfo>> leastUsedMachines; // A less used machine has less number of teams
-		int minTeamCount = std::numeric_limits<int>::max();
-		for (auto& machine : machine_info) {
-			// Skip invalid machine whose representative server is not in server_info
-			ASSERT_WE_THINK(server_info.find(machine.second->serversOnMachine[0]->getId()) != server_info.end());
-			// Skip unhealthy machines
-			if (!isMachineHealthy(machine.second))
-				continue;
-			// Skip machine with incomplete locality
-			if (!isValidLocality(configuration.storagePolicy,
-			                     machine.second->serversOnMachine[0]->getLastKnownInterface().locality)) {
-				continue;
-			}
-
-			// Invariant: We only create correct size machine teams.
-			// When configuration (e.g., team size) is changed, the DDTeamCollection will be destroyed and rebuilt
-			// so that the invariant will not be violated.
-			int teamCount = machine.second->machineTeams.size();
-
-			if (teamCount < minTeamCount) {
-				leastUsedMachines.clear();
-				minTeamCount = teamCount;
-			}
-			if (teamCount == minTeamCount) {
-				leastUsedMachines.push_back(machine.second);
-			}
-		}
+		// A less used machine has less number of teams
+		static const std::vector<Reference<TCMachineInfo>> noMachines;
+		const std::vector<Reference<TCMachineInfo>>& leastUsedMachines =
+		    candidateMachines.empty() ? noMachines : candidateMachines.leastUsed();
 
 		std::vector<UID*> team;
 		std::vector<LocalityEntry> forcedAttributes;
@@ -5181,6 +5185,10 @@ int DDTeamCollection::addBestMachineTeams(int machineTeamsToBuild) {
 
 			addMachineTeam(machines);
 			addedMachineTeams++;
+			for (auto& machine : machines) {
+				healthyMachines.update(machine, machine->machineTeams.size());
+				candidateMachines.update(machine, machine->machineTeams.size());
+			}
 		} else {
 			// When too many teams exist in simulation, traceAllInfo will buffer too many trace logs before
 			// trace has a chance to flush its buffer, which causes assertion failure.
@@ -5197,34 +5205,16 @@ int DDTeamCollection::addBestMachineTeams(int machineTeamsToBuild) {
 	return addedMachineTeams;
 }
 
-Reference<TCServerInfo> DDTeamCollection::findOneLeastUsedServer() const {
-	std::vector<Reference<TCServerInfo>> leastUsedServers;
-	int minTeams = std::numeric_limits<int>::max();
-	for (auto& [serverID, server] : server_info) {
-		// Only pick healthy server, which is not failed or excluded.
-		if (server_status.get(serverID).isUnhealthy())
-			continue;
-		if (!isValidLocality(configuration.storagePolicy, server->getLastKnownInterface().locality))
-			continue;
-
-		int numTeams = server->getTeams().size();
-		if (numTeams < minTeams) {
-			minTeams = numTeams;
-			leastUsedServers.clear();
-		}
-		if (minTeams == numTeams) {
-			leastUsedServers.push_back(server);
-		}
-	}
-
-	if (leastUsedServers.empty()) {
+Reference<TCServerInfo> DDTeamCollection::findOneLeastUsedServer(
+    TeamCountIndex<TCServerInfo> const& candidates) const {
+	if (candidates.empty()) {
 		// If we cannot find a healthy server with valid locality
 		TraceEvent("NoHealthyAndValidLocalityServers")
 		    .detail("Servers", server_info.size())
 		    .detail("UnhealthyServers", unhealthyServers);
 		return Reference<TCServerInfo>();
 	} else {
-		return deterministicRandom()->randomChoice(leastUsedServers);
+		return deterministicRandom()->randomChoice(candidates.leastUsed());
 	}
 }
 
@@ -5420,13 +5410,29 @@ int DDTeamCollection::getHealthyMachineTeamCount() const {
 	return healthyTeamCount;
 }
 
-bool DDTeamCollection::notEnoughMachineTeamsForAMachine() const {
+int DDTeamCollection::getTargetMachineTeamNumPerMachine() const {
 	// If we want to remove the machine team with most machine teams, we use the same logic as
 	// notEnoughTeamsForAServer
-	int targetMachineTeamNumPerMachine =
-	    SERVER_KNOBS->TR_FLAG_REMOVE_MT_WITH_MOST_TEAMS
-	        ? (SERVER_KNOBS->DESIRED_TEAMS_PER_SERVER * (configuration.storageTeamSize + 1)) / 2
-	        : SERVER_KNOBS->DESIRED_TEAMS_PER_SERVER;
+	return SERVER_KNOBS->TR_FLAG_REMOVE_MT_WITH_MOST_TEAMS
+	           ? (SERVER_KNOBS->DESIRED_TEAMS_PER_SERVER * (configuration.storageTeamSize + 1)) / 2
+	           : SERVER_KNOBS->DESIRED_TEAMS_PER_SERVER;
+}
+
+int DDTeamCollection::getTargetTeamNumPerServer() const {
+	// We build more teams than we finally want so that we can use serverTeamRemover() actor to remove the teams
+	// whose member belong to too many teams. This allows us to get a more balanced number of teams per server.
+	// We want to ensure every server has targetTeamNumPerServer teams.
+	// The numTeamsPerServerFactor is calculated as
+	// (SERVER_KNOBS->DESIRED_TEAMS_PER_SERVER + ideal_num_of_teams_per_server) / 2
+	// ideal_num_of_teams_per_server is (#teams * storageTeamSize) / #servers, which is
+	// (#servers * DESIRED_TEAMS_PER_SERVER * storageTeamSize) / #servers.
+	int targetTeamNumPerServer = (SERVER_KNOBS->DESIRED_TEAMS_PER_SERVER * (configuration.storageTeamSize + 1)) / 2;
+	ASSERT_GT(targetTeamNumPerServer, 0);
+	return targetTeamNumPerServer;
+}
+
+bool DDTeamCollection::notEnoughMachineTeamsForAMachine() const {
+	int targetMachineTeamNumPerMachine = getTargetMachineTeamNumPerMachine();
 	for (auto& [_, machine] : machine_info) {
 		// If SERVER_KNOBS->TR_FLAG_REMOVE_MT_WITH_MOST_TEAMS is false,
 		// The desired machine team number is not the same with the desired server team number
@@ -5441,15 +5447,7 @@ bool DDTeamCollection::notEnoughMachineTeamsForAMachine() const {
 }
 
 bool DDTeamCollection::notEnoughTeamsForAServer() const {
-	// We build more teams than we finally want so that we can use serverTeamRemover() actor to remove the teams
-	// whose member belong to too many teams. This allows us to get a more balanced number of teams per server.
-	// We want to ensure every server has targetTeamNumPerServer teams.
-	// The numTeamsPerServerFactor is calculated as
-	// (SERVER_KNOBS->DESIRED_TEAMS_PER_SERVER + ideal_num_of_teams_per_server) / 2
-	// ideal_num_of_teams_per_server is (#teams * storageTeamSize) / #servers, which is
-	// (#servers * DESIRED_TEAMS_PER_SERVER * storageTeamSize) / #servers.
-	int targetTeamNumPerServer = (SERVER_KNOBS->DESIRED_TEAMS_PER_SERVER * (configuration.storageTeamSize + 1)) / 2;
-	ASSERT_GT(targetTeamNumPerServer, 0);
+	int targetTeamNumPerServer = getTargetTeamNumPerServer();
 	for (auto& [serverID, server] : server_info) {
 		if (server->getTeams().size() < targetTeamNumPerServer && !server_status.get(serverID).isUnhealthy()) {
 			return true;
@@ -5513,14 +5511,31 @@ int DDTeamCollection::addTeamsBestOf(int teamsToBuild, int desiredTeams, int max
 		}
 	}
 
-	while (addedTeams < teamsToBuild || notEnoughTeamsForAServer()) {
+	// Index the servers by their number of server teams; as with machines in addBestMachineTeams(), server health and
+	// locality do not change while teams are being built. healthyServers answers notEnoughTeamsForAServer(),
+	// candidateServers holds the servers that findOneLeastUsedServer() may choose.
+	TeamCountIndex<TCServerInfo> healthyServers;
+	TeamCountIndex<TCServerInfo> candidateServers;
+	for (auto& [serverID, server] : server_info) {
+		// Only pick healthy server, which is not failed or excluded.
+		if (server_status.get(serverID).isUnhealthy())
+			continue;
+		healthyServers.add(server, server->getTeams().size());
+		if (!isValidLocality(configuration.storagePolicy, server->getLastKnownInterface().locality))
+			continue;
+		candidateServers.add(server, server->getTeams().size());
+	}
+	const int targetTeamNumPerServer = getTargetTeamNumPerServer();
+
+	while (addedTeams < teamsToBuild ||
+	       (!healthyServers.empty() && healthyServers.minTeamCount() < targetTeamNumPerServer)) {
 		std::vector<UID> bestServerTeam;
 		int bestScore = std::numeric_limits<int>::max();
 		int maxAttempts = SERVER_KNOBS->BEST_OF_AMT; // BEST_OF_AMT = 4
 		bool earlyQuitBuild = false;
 		for (int i = 0; i < maxAttempts && i < 100; ++i) {
 			// Step 1: Choose 1 least used server and then choose 1 least used machine team from the server
-			Reference<TCServerInfo> chosenServer = findOneLeastUsedServer();
+			Reference<TCServerInfo> chosenServer = findOneLeastUsedServer(candidateServers);
 			if (!chosenServer.isValid()) {
 				TraceEvent(SevWarn, "NoValidServer").detail("Primary", primary);
 				earlyQuitBuild = true;
@@ -5608,6 +5623,11 @@ int DDTeamCollection::addTeamsBestOf(int teamsToBuild, int desiredTeams, int max
 		// Step 4: Add the server team
 		addTeam(bestServerTeam.begin(), bestServerTeam.end(), IsInitialTeam::False);
 		addedTeams++;
+		for (auto& serverID : bestServerTeam) {
+			auto& server = server_info[serverID];
+			healthyServers.update(server, server->getTeams().size());
+			candidateServers.update(server, server->getTeams().size());
+		}
 	}
 
 	healthyMachineTeamCount = getHealthyMachineTeamCount();
@@ -6194,7 +6214,8 @@ public:
 
 	static std::unique_ptr<DDTeamCollection> testMachineTeamCollection(int teamSize,
 	                                                                   Reference<IReplicationPolicy> policy,
-	                                                                   int processCount) {
+	                                                                   int processCount,
+	                                                                   bool verbose = true) {
 		Database database = DatabaseContext::create(
 		    makeReference<AsyncVar<ClientDBInfo>>(), Never(), LocalityData(), EnableLocalityLoadBalance::False);
 		auto txnProcessor = Reference<IDDTxnProcessor>(new DDTxnProcessor(database));
@@ -6232,11 +6253,13 @@ public:
 			int zone_id = process_id / 10;
 			int machine_id = process_id / 5;
 
-			printf("testMachineTeamCollection: process_id:%d zone_id:%d machine_id:%d ip_addr:%s\n",
-			       process_id,
-			       zone_id,
-			       machine_id,
-			       interface.address().toString().c_str());
+			if (verbose) {
+				printf("testMachineTeamCollection: process_id:%d zone_id:%d machine_id:%d ip_addr:%s\n",
+				       process_id,
+				       zone_id,
+				       machine_id,
+				       interface.address().toString().c_str());
+			}
 			interface.locality.set("processid"_sr, Standalone<StringRef>(std::to_string(process_id)));
 			interface.locality.set("machineid"_sr, Standalone<StringRef>(std::to_string(machine_id)));
 			interface.locality.set("zoneid"_sr, Standalone<StringRef>(std::to_string(zone_id)));
@@ -6249,7 +6272,9 @@ public:
 		}
 
 		int totalServerIndex = collection->constructMachinesFromServers();
-		printf("testMachineTeamCollection: construct machines for %d servers\n", totalServerIndex);
+		if (verbose) {
+			printf("testMachineTeamCollection: construct machines for %d servers\n", totalServerIndex);
+		}
 
 		return collection;
 	}
@@ -6297,6 +6322,40 @@ public:
 		return Void();
 	}
 
+	// Builds all teams for a large cluster from scratch, as after a data distributor restart, and reports how long
+	// team building took. Not run in simulation, where addTeamsBestOf() sometimes asks for every possible machine team.
+	static void AddTeamsBestOf_LargeCluster() {
+		int teamSize = 3; // replication size
+		int processSize = 1000;
+		int desiredTeams = SERVER_KNOBS->DESIRED_TEAMS_PER_SERVER * processSize;
+		int maxTeams = SERVER_KNOBS->MAX_TEAMS_PER_SERVER * processSize;
+
+		Reference<IReplicationPolicy> policy = Reference<IReplicationPolicy>(
+		    new PolicyAcross(teamSize, "zoneid", Reference<IReplicationPolicy>(new PolicyOne())));
+		std::unique_ptr<DDTeamCollection> collection =
+		    testMachineTeamCollection(teamSize, policy, processSize, /*verbose=*/false);
+
+		double start = timer_monotonic();
+		int addedTeams = collection->addTeamsBestOf(desiredTeams, desiredTeams, maxTeams);
+		double elapsed = timer_monotonic() - start;
+
+		TraceEvent("AddTeamsBestOfLargeCluster")
+		    .detail("Servers", processSize)
+		    .detail("Machines", collection->machine_info.size())
+		    .detail("ServerTeams", addedTeams)
+		    .detail("MachineTeams", collection->machineTeams.size())
+		    .detail("Elapsed", elapsed);
+		printf("addTeamsBestOf: built %d server teams and %zu machine teams for %d servers in %.3f seconds\n",
+		       addedTeams,
+		       collection->machineTeams.size(),
+		       processSize,
+		       elapsed);
+
+		ASSERT_GE(addedTeams, desiredTeams);
+		ASSERT(!collection->notEnoughTeamsForAServer());
+		ASSERT(collection->sanityCheckTeams());
+	}
+
 	static void AddAllTeams_isExhaustive() {
 		Reference<IReplicationPolicy> policy = makeReference<PolicyAcross>(3, "zoneid", makeReference<PolicyOne>());
 		int processSize = 10;
@@ -6989,6 +7048,11 @@ TEST_CASE("DataDistribution/AddTeamsBestOf/NotUseMachineID") {
 	return Void();
 }
 
+TEST_CASE("noSim/DataDistribution/AddTeamsBestOf/LargeCluster") {
+	DDTeamCollectionUnitTest::AddTeamsBestOf_LargeCluster();
+	return Void();
+}
+
 TEST_CASE("DataDistribution/AddAllTeams/isExhaustive") {
 	DDTeamCollectionUnitTest::AddAllTeams_isExhaustive();
 	return Void();
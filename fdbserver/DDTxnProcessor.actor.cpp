@@ -753,6 +753,10 @@ Future<Standalone<VectorRef<ReadHotRangeWithMetrics>>> DDTxnProcessor::getReadHo
 	return cx->getReadHotRanges(keys);
 }
 
+Future<Standalone<VectorRef<ReadHotRangeWithMetrics>>> DDTxnProcessor::getReadHotKeyRanges(const KeyRange& keys) const {
+	return cx->getReadHotRanges(keys, ReadHotSubRangeRequest::SplitType::HOT_KEYS, SERVER_KNOBS->READ_HOT_SKETCH_KEYS);
+}
+
 Future<HealthMetrics> DDTxnProcessor::getHealthMetrics(bool detailed) const {
 	return cx->getHealthMetrics(detailed);
 }
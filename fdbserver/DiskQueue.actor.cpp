@@ -171,7 +171,8 @@ public:
 	  : basename(basename), fileExtension(fileExtension), dbgid(dbgid), dbg_file0BeginSeq(0),
 	    fileSizeWarningLimit(fileSizeWarningLimit), onError(delayed(error.getFuture())), onStopped(stopped.getFuture()),
 	    readyToPush(Void()), lastCommit(Void()), isFirstCommit(true), readingBuffer(dbgid), readingFile(-1),
-	    readingPage(-1), writingPos(-1), fileExtensionBytes(SERVER_KNOBS->DISK_QUEUE_FILE_EXTENSION_BYTES),
+	    readingPage(-1), readAheadFile(-1), readAheadPage(-1), writingPos(-1),
+	    fileExtensionBytes(SERVER_KNOBS->DISK_QUEUE_FILE_EXTENSION_BYTES),
 	    fileShrinkBytes(SERVER_KNOBS->DISK_QUEUE_FILE_SHRINK_BYTES) {
 		if (BUGGIFY)
 			fileExtensionBytes = _PAGE_SIZE * deterministicRandom()->randomSkewedUInt32(1, 10 << 10);
@@ -214,6 +215,8 @@ public:
 		    .detail("File0Name", files[0].dbgFilename);
 		readingFile = file;
 		readingPage = page;
+		readAheadFile = file;
+		readAheadPage = page;
 	}
 
 	Future<Void> setPoppedPage(int file, int64_t page, int64_t debugSeq) {
@@ -286,6 +289,17 @@ public:
 	                 // files[readingFile]. readingFile = 2 if recovery is complete (all files have been read).
 	int64_t readingPage; // Page within readingFile that is the next page after readingBuffer
 
+	// Reads of the pages after readingBuffer, issued before they are needed so that recovery does not wait on the disk
+	// for every chunk.  readAheadFile and readAheadPage are where the next read ahead starts.
+	struct ReadAhead {
+		int file;
+		int64_t page;
+		Future<Standalone<StringRef>> pages;
+	};
+	std::deque<ReadAhead> readAheads;
+	int readAheadFile;
+	int64_t readAheadPage;
+
 	int64_t writingPos; // Position within files[1] that will be next written
 
 	int64_t fileExtensionBytes;
@@ -758,31 +772,62 @@ public:
 		return result;
 	}
 
-	Future<int> fillReadingBuffer() {
-		// If we're right at the end of a file...
-		if (readingPage * sizeof(Page) >= (size_t)files[readingFile].size) {
-			readingFile++;
-			readingPage = 0;
-			if (readingFile >= 2) {
-				// Recovery complete
-				readingBuffer.clear();
-				writingPos = files[1].size;
-				return 0;
+	// Read nPages from pageOffset*sizeof(Page) offset in file self->files[file] during recovery
+	ACTOR static UNCANCELLABLE Future<Standalone<StringRef>> readAhead(RawDiskQueue_TwoFiles* self,
+	                                                                   int file,
+	                                                                   int64_t pageOffset,
+	                                                                   int nPages) {
+		state TrackMe trackMe(self);
+		state const size_t bytesRequested = nPages * sizeof(Page);
+		state Standalone<StringRef> result = makeAlignedString(sizeof(Page), bytesRequested);
+		int bytesRead =
+		    wait(self->files[file].f->read(mutateString(result), bytesRequested, pageOffset * sizeof(Page)));
+		ASSERT(bytesRead == bytesRequested);
+		return result;
+	}
+
+	void issueReadAheads() {
+		while (readAheadFile < 2 && readAheads.size() < (size_t)SERVER_KNOBS->DISK_QUEUE_RECOVERY_READ_AHEAD_CHUNKS) {
+			// If we're right at the end of a file...
+			if (readAheadPage * sizeof(Page) >= (size_t)files[readAheadFile].size) {
+				readAheadFile++;
+				readAheadPage = 0;
+				continue;
 			}
+
+			// Read up to 1MB
+			int len = std::min<int64_t>((files[readAheadFile].size / sizeof(Page) - readAheadPage) * sizeof(Page),
+			                            BUGGIFY_WITH_PROB(1.0) ? sizeof(Page) * deterministicRandom()->randomInt(1, 4)
+			                                                   : (1 << 20));
+			int nPages = len / sizeof(Page);
+			readAheads.push_back(
+			    ReadAhead{ readAheadFile, readAheadPage, readAhead(this, readAheadFile, readAheadPage, nPages) });
+			readAheadPage += nPages;
 		}
+	}
 
-		// Read up to 1MB into readingBuffer
-		int len = std::min<int64_t>((files[readingFile].size / sizeof(Page) - readingPage) * sizeof(Page),
-		                            BUGGIFY_WITH_PROB(1.0) ? sizeof(Page) * deterministicRandom()->randomInt(1, 4)
-		                                                   : (1 << 20));
-		readingBuffer.clear();
-		readingBuffer.alignReserve(sizeof(Page), len);
-		void* p = readingBuffer.append(len);
+	ACTOR static Future<Void> fillReadingBuffer(RawDiskQueue_TwoFiles* self) {
+		self->issueReadAheads();
+		if (self->readAheads.empty()) {
+			// Recovery complete
+			self->readingFile = 2;
+			self->readingBuffer.clear();
+			self->writingPos = self->files[1].size;
+			return Void();
+		}
+
+		state ReadAhead next = self->readAheads.front();
+		Standalone<StringRef> pages = wait(next.pages);
+		self->readAheads.pop_front();
 
-		auto pos = readingPage * sizeof(Page);
-		readingPage += len / sizeof(Page);
-		ASSERT(int64_t(p) % sizeof(Page) == 0);
-		return files[readingFile].f->read(p, len, pos);
+		self->readingBuffer.str = pages;
+		self->readingBuffer.reserved = pages.size();
+		self->readingFile = next.file;
+		self->readingPage = next.page + pages.size() / sizeof(Page);
+
+		// Keep the disk busy while the caller consumes readingBuffer
+		self->issueReadAheads();
+		return Void();
 	}
 
 	ACTOR static UNCANCELLABLE Future<Standalone<StringRef>> readNextPage(RawDiskQueue_TwoFiles* self) {
@@ -796,8 +841,7 @@ public:
 				state Future<Void> f = Void();
 				// if (BUGGIFY) f = delay( deterministicRandom()->random01() * 0.1 );
 
-				int read = wait(self->fillReadingBuffer());
-				ASSERT(read == self->readingBuffer.size());
+				wait(fillReadingBuffer(self));
 
 				wait(f);
 			}
@@ -848,6 +892,8 @@ public:
 
 			self->readingFile = 2;
 			self->readingBuffer.clear();
+			self->readAheads.clear();
+			self->readAheadFile = 2;
 			self->writingPos = pos;
 
 			while (file < 2) {
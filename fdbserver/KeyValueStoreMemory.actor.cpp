@@ -26,6 +26,7 @@
 #include "fdbserver/ServerDBInfo.actor.h"
 #include "fdbserver/DeltaTree.h"
 #include "fdbclient/GetEncryptCipherKeys.h"
+#include "fdbserver/CoroFlow.h"
 #include "fdbserver/IDiskQueue.h"
 #include "fdbserver/IKeyValueContainer.h"
 #include "fdbserver/IKeyValueStore.h"
@@ -33,6 +34,7 @@
 #include "fdbserver/TransactionStoreMutationTracking.h"
 #include "flow/ActorCollection.h"
 #include "flow/EncryptUtils.h"
+#include "flow/IThreadPool.h"
 #include "flow/Knobs.h"
 #include "flow/actorcompiler.h" // This must be the last #include.
 
@@ -51,7 +53,8 @@ public:
 	                    bool disableSnapshot,
 	                    bool replaceContent,
 	                    bool exactRecovery,
-	                    bool enableEncryption);
+	                    bool enableEncryption,
+	                    bool allowSnapshotReads);
 
 	bool getReplaceContent() const override { return replaceContent; }
 	// IClosable
@@ -59,6 +62,7 @@ public:
 	Future<Void> onClosed() const override { return log->onClosed(); }
 	void dispose() override {
 		recovering.cancel();
+		stopSnapshotReaders();
 		log->dispose();
 		if (reserved_buffer != nullptr) {
 			delete[] reserved_buffer;
@@ -68,6 +72,7 @@ public:
 	}
 	void close() override {
 		recovering.cancel();
+		stopSnapshotReaders();
 		log->close();
 		if (reserved_buffer != nullptr) {
 			delete[] reserved_buffer;
@@ -251,6 +256,27 @@ public:
 			return result;
 		}
 
+		// Once a read has copied MEMORY_KVS_SNAPSHOT_READ_RANGE_BYTES on this thread, the remaining rows are captured
+		// rather than copied. Each KeyValueMapPair holds a reference to the arena containing its key and value, so the
+		// captured rows stay valid when later commits overwrite or clear them, and a snapshot reader thread finishes
+		// the copy.
+		std::vector<KeyValueMapPair> snapshotRows;
+		int64_t copyBytesLeft = allowSnapshotReads && SERVER_KNOBS->MEMORY_KVS_SNAPSHOT_READ_RANGE_BYTES > 0
+		                            ? SERVER_KNOBS->MEMORY_KVS_SNAPSHOT_READ_RANGE_BYTES
+		                            : std::numeric_limits<int64_t>::max();
+		auto addRow = [&](auto const& it, StringRef key) {
+			int rowBytes = key.size() + it.getValue().size();
+			byteLimit -= sizeof(KeyValueRef) + rowBytes;
+			if constexpr (std::is_same_v<Container, IKeyValueContainer>) {
+				if (copyBytesLeft <= 0) {
+					snapshotRows.push_back(*it);
+					return;
+				}
+				copyBytesLeft -= rowBytes;
+			}
+			result.push_back_deep(result.arena(), KeyValueRef(key, it.getValue()));
+		};
+
 		if (rowLimit > 0) {
 			auto it = data.lower_bound(keys.begin);
 			while (it != data.end() && rowLimit && byteLimit > 0) {
@@ -258,8 +284,7 @@ public:
 				if (tempKey >= keys.end)
 					break;
 
-				byteLimit -= sizeof(KeyValueRef) + tempKey.size() + it.getValue().size();
-				result.push_back_deep(result.arena(), KeyValueRef(tempKey, it.getValue()));
+				addRow(it, tempKey);
 				++it;
 				--rowLimit;
 			}
@@ -271,15 +296,22 @@ public:
 				if (tempKey < keys.begin)
 					break;
 
-				byteLimit -= sizeof(KeyValueRef) + tempKey.size() + it.getValue().size();
-				result.push_back_deep(result.arena(), KeyValueRef(tempKey, it.getValue()));
+				addRow(it, tempKey);
 				it = data.previous(it);
 				--rowLimit;
 			}
 		}
 
 		result.more = rowLimit == 0 || byteLimit <= 0;
-		return result;
+		if (snapshotRows.empty()) {
+			return result;
+		}
+
+		CODE_PROBE(true, "KeyValueStoreMemory finishing a range read on a snapshot reader");
+		auto a = new SnapshotReader::ReadRangeAction(std::move(result), std::move(snapshotRows));
+		auto f = a->result.getFuture();
+		getSnapshotReaders()->post(a);
+		return f;
 	}
 
 	void resyncLog() override {
@@ -409,10 +441,61 @@ private:
 	int64_t memoryLimit; // The upper limit on the memory used by the store (excluding, possibly, some clear operations)
 	std::vector<std::pair<KeyValueMapPair, uint64_t>> dataSets;
 
+	// The txnStateStore is read synchronously (readRange().get()), so only stores opened through keyValueStoreMemory()
+	// may return range reads that are not immediately ready.
+	bool allowSnapshotReads;
+
+	// Copies the rows of large range reads off the network thread. Created on the first such read, since most memory
+	// stores (e.g. the txnStateStore of every commit proxy) never see one.
+	Reference<IThreadPool> snapshotReaders;
+
+	struct SnapshotReader : IThreadPoolReceiver {
+		void init() override {}
+
+		struct ReadRangeAction final : TypedAction<SnapshotReader, ReadRangeAction>, FastAllocated<ReadRangeAction> {
+			RangeResult prefix; // Rows already copied by the network thread
+			std::vector<KeyValueMapPair> rows;
+			ThreadReturnPromise<RangeResult> result;
+			ReadRangeAction(RangeResult prefix, std::vector<KeyValueMapPair> rows)
+			  : prefix(std::move(prefix)), rows(std::move(rows)) {}
+			double getTimeEstimate() const override { return SERVER_KNOBS->READ_RANGE_TIME_ESTIMATE; }
+		};
+		void action(ReadRangeAction& rr) {
+			rr.prefix.reserve(rr.prefix.arena(), rr.prefix.size() + rr.rows.size());
+			for (auto const& row : rr.rows) {
+				rr.prefix.push_back_deep(rr.prefix.arena(), KeyValueRef(row.key, row.value));
+			}
+			rr.result.send(rr.prefix);
+		}
+	};
+
+	IThreadPool* getSnapshotReaders() {
+		if (!snapshotReaders) {
+			if (g_network->isSimulated()) {
+				snapshotReaders = CoroThreadPool::createThreadPool();
+			} else {
+				snapshotReaders = createGenericThreadPool();
+			}
+			for (int i = 0; i < SERVER_KNOBS->MEMORY_KVS_SNAPSHOT_READ_THREADS; i++) {
+				snapshotReaders->addThread(new SnapshotReader(), "fdb-kvsmem-rd");
+			}
+		}
+		return snapshotReaders.getPtr();
+	}
+
+	void stopSnapshotReaders() {
+		if (snapshotReaders) {
+			snapshotReaders->stop();
+			snapshotReaders.clear();
+		}
+	}
+
 	bool enableEncryption;
 	TextAndHeaderCipherKeys cipherKeys;
 	Future<Void> refreshCipherKeysActor;
 
+	// If sequential is true, runs of sets with ascending keys are inserted into data in bulk, which is much cheaper
+	// than inserting them one at a time.
 	int64_t commit_queue(OpQueue& ops, bool log, bool sequential = false) {
 		int64_t total = 0, count = 0;
 		IDiskQueue::location log_location = 0;
@@ -422,6 +505,10 @@ private:
 			total += o->p1.size() + o->p2.size() + OP_DISK_OVERHEAD;
 			if (o->op == OpSet) {
 				if (sequential) {
+					if (!dataSets.empty() && o->p1 <= dataSets.back().first.key) {
+						data.insert(dataSets);
+						dataSets.clear();
+					}
 					KeyValueMapPair pair(o->p1, o->p2);
 					dataSets.emplace_back(pair, pair.arena.getSize() + data.getElementBytes());
 				} else {
@@ -734,7 +821,10 @@ private:
 						} else if (h.op == OpClearToEnd) { // clear all data from begin key to end
 							recoveryQueue.clear_to_end(p1, &data.arena());
 						} else if (h.op == OpCommit) { // commit previous transaction
-							self->commit_queue(recoveryQueue, false);
+							// Snapshot items are logged in key order, so most of what is replayed forms ascending runs
+							// that the IndexedSet can insert in bulk
+							self->commit_queue(
+							    recoveryQueue, false, std::is_same_v<Container, IKeyValueContainer>);
 							++dbgCommitCount;
 							self->recoveredSnapshotKey = uncommittedNextKey;
 							self->previousSnapshotEnd = uncommittedPrevSnapshotEnd;
@@ -1020,7 +1110,8 @@ private:
 	                                                  int byteLimit,
 	                                                  Optional<ReadOptions> options) {
 		wait(self->recovering);
-		return static_cast<IKeyValueStore*>(self)->readRange(keys, rowLimit, byteLimit, options).get();
+		RangeResult result = wait(static_cast<IKeyValueStore*>(self)->readRange(keys, rowLimit, byteLimit, options));
+		return result;
 	}
 	ACTOR static Future<Void> waitAndCommit(KeyValueStoreMemory* self, bool sequential) {
 		wait(self->recovering);
@@ -1060,11 +1151,12 @@ KeyValueStoreMemory<Container>::KeyValueStoreMemory(IDiskQueue* log,
                                                     bool disableSnapshot,
                                                     bool replaceContent,
                                                     bool exactRecovery,
-                                                    bool enableEncryption)
+                                                    bool enableEncryption,
+                                                    bool allowSnapshotReads)
   : type(storeType), id(id), log(log), db(db), committedWriteBytes(0), overheadWriteBytes(0), currentSnapshotEnd(-1),
     previousSnapshotEnd(-1), committedDataSize(0), transactionSize(0), transactionIsLarge(false), resetSnapshot(false),
     disableSnapshot(disableSnapshot), replaceContent(replaceContent), firstCommitWithSnapshot(true), snapshotCount(0),
-    memoryLimit(memoryLimit), enableEncryption(enableEncryption) {
+    memoryLimit(memoryLimit), allowSnapshotReads(allowSnapshotReads), enableEncryption(enableEncryption) {
 	// create reserved buffer for radixtree store type
 	this->reserved_buffer =
 	    (storeType == KeyValueStoreType::MEMORY) ? nullptr : new uint8_t[CLIENT_KNOBS->SYSTEM_KEY_SIZE_LIMIT];
@@ -1093,10 +1185,10 @@ IKeyValueStore* keyValueStoreMemory(std::string const& basename,
 	IDiskQueue* log = openDiskQueue(basename, ext, logID, DiskQueueVersion::V2);
 	if (storeType == KeyValueStoreType::MEMORY_RADIXTREE) {
 		return new KeyValueStoreMemory<radix_tree>(
-		    log, Reference<AsyncVar<ServerDBInfo> const>(), logID, memoryLimit, storeType, false, false, false, false);
+		    log, Reference<AsyncVar<ServerDBInfo> const>(), logID, memoryLimit, storeType, false, false, false, false, true);
 	} else {
 		return new KeyValueStoreMemory<IKeyValueContainer>(
-		    log, Reference<AsyncVar<ServerDBInfo> const>(), logID, memoryLimit, storeType, false, false, false, false);
+		    log, Reference<AsyncVar<ServerDBInfo> const>(), logID, memoryLimit, storeType, false, false, false, false, true);
 	}
 }
 
@@ -1118,5 +1210,6 @@ IKeyValueStore* keyValueStoreLogSystem(class IDiskQueue* queue,
 	                                                   disableSnapshot,
 	                                                   replaceContent,
 	                                                   exactRecovery,
-	                                                   enableEncryption);
+	                                                   enableEncryption,
+	                                                   false);
 }
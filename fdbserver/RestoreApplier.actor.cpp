@@ -27,7 +27,12 @@
 #include "fdbclient/ManagementAPI.actor.h"
 #include "fdbclient/MutationList.h"
 #include "fdbclient/BackupContainer.h"
+#include "fdbclient/BulkLoading.h"
+#include "fdbserver/BulkLoadUtil.actor.h"
+#include "fdbserver/DataDistribution.actor.h"
 #include "fdbserver/Knobs.h"
+#include "fdbserver/RocksDBCheckpointUtils.actor.h"
+#include "fdbserver/StorageMetrics.actor.h"
 #include "fdbserver/RestoreCommon.actor.h"
 #include "fdbserver/RestoreUtil.h"
 #include "fdbserver/RestoreRoleCommon.actor.h"
@@ -362,10 +367,13 @@ ACTOR static Future<Void> getAndComputeStagingKeys(
 	return Void();
 }
 
+// If targetRangeEmpty, the range of the staging keys is known to be empty in DB, so keys without a base value are
+// precomputed without reading DB.
 ACTOR static Future<Void> precomputeMutationsResult(Reference<ApplierBatchData> batchData,
                                                     UID applierID,
                                                     int64_t batchIndex,
-                                                    Database cx) {
+                                                    Database cx,
+                                                    bool targetRangeEmpty) {
 	// Apply range mutations (i.e., clearRange) to database cx
 	TraceEvent("FastRestoreApplerPhasePrecomputeMutationsResultStart", applierID)
 	    .detail("BatchIndex", batchIndex)
@@ -442,6 +450,10 @@ ACTOR static Future<Void> precomputeMutationsResult(Reference<ApplierBatchData>
 		double delayTime = 0; // Start transactions at different time to avoid overwhelming FDB.
 		for (; stagingKeyIter != batchData->stagingKeys.end(); stagingKeyIter++) {
 			if (!stagingKeyIter->second.hasBaseValue()) {
+				if (targetRangeEmpty) {
+					stagingKeyIter->second.precomputeResult("TargetRangeEmpty", applierID, batchIndex);
+					continue;
+				}
 				incompleteStagingKeys.emplace(stagingKeyIter->first, stagingKeyIter);
 				numKeysInBatch++;
 			}
@@ -652,15 +664,193 @@ ACTOR static Future<Void> applyStagingKeys(Reference<ApplierBatchData> batchData
 	return Void();
 }
 
+// Bulk load can write the range only if bulk load is enabled on the cluster and the range is empty, because a bulk load
+// task replaces the content of its range.
+ACTOR static Future<bool> canBulkLoadRange(KeyRange range, Database cx) {
+	state Transaction tr(cx);
+	state Future<Optional<Value>> fMode;
+	state Future<RangeResult> fData;
+	loop {
+		try {
+			tr.setOption(FDBTransactionOptions::READ_SYSTEM_KEYS);
+			tr.setOption(FDBTransactionOptions::LOCK_AWARE);
+			fMode = tr.get(bulkLoadModeKey);
+			fData = tr.getRange(range, 1);
+			wait(success(fMode) && success(fData));
+			int mode = 0;
+			if (fMode.get().present()) {
+				BinaryReader rd(fMode.get().get(), Unversioned());
+				rd >> mode;
+			}
+			return bulkLoadIsEnabled(mode) && fData.get().empty();
+		} catch (Error& e) {
+			wait(tr.onError(e));
+		}
+	}
+}
+
+// Write the precomputed staging keys into an SST file and ingest it into the empty range with a bulk load task,
+// instead of committing them in transactions. Return false if the batch has to be applied with transactions instead.
+ACTOR static Future<bool> bulkLoadStagingKeys(Reference<ApplierBatchData> batchData,
+                                              KeyRange range,
+                                              UID applierID,
+                                              int64_t batchIndex,
+                                              Database cx) {
+	state std::string folder = joinPath(SERVER_KNOBS->FASTRESTORE_APPLIER_BULKLOAD_FOLDER,
+	                                    applierID.toString() + "-" + std::to_string(batchIndex));
+	state std::string dataFile = joinPath(folder, generateRandomBulkLoadDataFileName());
+	state std::string bytesSampleFile = joinPath(folder, generateRandomBulkLoadBytesSampleFileName());
+	state BulkLoadState bulkLoadTask = newBulkLoadTaskLocalSST(range, folder, dataFile, bytesSampleFile);
+	state Transaction tr(cx);
+	state double startTime = now();
+	state int64_t keys = 0;
+	state int64_t bytes = 0;
+	state bool submitted = false;
+
+	try {
+		platform::eraseDirectoryRecursive(folder);
+		if (!platform::createDirectory(folder)) {
+			TraceEvent(SevWarnAlways, "FastRestoreApplierBulkLoadCreateFolderFailed", applierID)
+			    .detail("BatchIndex", batchIndex)
+			    .detail("Folder", folder);
+			return false;
+		}
+		std::unique_ptr<IRocksDBSstFileWriter> sstWriter = newRocksDBSstFileWriter();
+		std::vector<KeyValue> bytesSample;
+		sstWriter->open(abspath(dataFile));
+		for (auto& [key, stagingKey] : batchData->stagingKeys) {
+			// Clears are no-ops in an empty range. stagingKeys is ordered, as the SST file requires.
+			if (stagingKey.type != MutationRef::SetValue) {
+				continue;
+			}
+			KeyValueRef kv(stagingKey.key, stagingKey.val);
+			ByteSampleInfo sampleInfo = isKeyValueInSample(kv);
+			if (sampleInfo.inSample) {
+				bytesSample.push_back(
+				    Standalone(KeyValueRef(kv.key, BinaryWriter::toValue(sampleInfo.sampledSize, Unversioned()))));
+			}
+			sstWriter->write(kv.key, kv.value);
+			keys++;
+			bytes += stagingKey.totalSize();
+		}
+		if (!sstWriter->finish()) {
+			// Nothing to write
+			platform::eraseDirectoryRecursive(folder);
+			return true;
+		}
+		if (!bytesSample.empty()) {
+			sstWriter->open(abspath(bytesSampleFile));
+			for (const auto& kv : bytesSample) {
+				sstWriter->write(kv.key, kv.value);
+			}
+			if (!sstWriter->finish()) {
+				TraceEvent(SevWarnAlways, "FastRestoreApplierBulkLoadWriteBytesSampleFailed", applierID)
+				    .detail("BatchIndex", batchIndex)
+				    .detail("Folder", folder);
+				platform::eraseDirectoryRecursive(folder);
+				return false;
+			}
+		}
+	} catch (Error& e) {
+		TraceEvent(SevWarnAlways, "FastRestoreApplierBulkLoadWriteSSTFailed", applierID)
+		    .error(e)
+		    .detail("BatchIndex", batchIndex)
+		    .detail("Folder", folder);
+		platform::eraseDirectoryRecursive(folder);
+		return false;
+	}
+
+	TraceEvent("FastRestoreApplierBulkLoadStart", applierID)
+	    .detail("BatchIndex", batchIndex)
+	    .detail("Range", range)
+	    .detail("Keys", keys)
+	    .detail("Bytes", bytes)
+	    .detail("Task", bulkLoadTask.toString());
+	try {
+		wait(submitBulkLoadTask(cx, bulkLoadTask));
+		submitted = true;
+	} catch (Error& e) {
+		if (e.code() == error_code_actor_cancelled) {
+			throw;
+		}
+		TraceEvent(SevWarnAlways, "FastRestoreApplierBulkLoadSubmitFailed", applierID)
+		    .error(e)
+		    .detail("BatchIndex", batchIndex)
+		    .detail("Task", bulkLoadTask.toString());
+	}
+	if (!submitted) {
+		platform::eraseDirectoryRecursive(folder);
+		return false;
+	}
+	batchData->totalBytesToWrite += bytes;
+	batchData->counters.bulkLoadTasks += 1;
+
+	loop {
+		try {
+			tr.setOption(FDBTransactionOptions::LOCK_AWARE);
+			tr.setOption(FDBTransactionOptions::ACCESS_SYSTEM_KEYS);
+			BulkLoadState bulkLoadState = wait(getBulkLoadTask(&tr, range, bulkLoadTask.getTaskId(), {}));
+			if (bulkLoadState.phase == BulkLoadPhase::Complete) {
+				break;
+			}
+			wait(delay(SERVER_KNOBS->FASTRESTORE_APPLIER_BULKLOAD_POLL_SECONDS));
+			tr.reset();
+		} catch (Error& e) {
+			if (e.code() == error_code_bulkload_task_outdated) {
+				// Another bulk load task took over the range, so this one will never complete
+				TraceEvent(SevWarnAlways, "FastRestoreApplierBulkLoadOutdated", applierID)
+				    .detail("BatchIndex", batchIndex)
+				    .detail("Task", bulkLoadTask.toString());
+				platform::eraseDirectoryRecursive(folder);
+				return false;
+			}
+			wait(tr.onError(e));
+		}
+	}
+	wait(acknowledgeBulkLoadTask(cx, range, bulkLoadTask.getTaskId()));
+	platform::eraseDirectoryRecursive(folder);
+
+	batchData->counters.bulkLoadedKeys += keys;
+	batchData->counters.bulkLoadedBytes += bytes;
+	batchData->counters.appliedBytes += bytes;
+	batchData->appliedBytes += bytes;
+	TraceEvent("FastRestoreApplierBulkLoadDone", applierID)
+	    .detail("BatchIndex", batchIndex)
+	    .detail("Range", range)
+	    .detail("Keys", keys)
+	    .detail("Bytes", bytes)
+	    .detail("Seconds", now() - startTime);
+	return true;
+}
+
 // Write mutations to the destination DB
 ACTOR Future<Void> writeMutationsToDB(UID applierID,
                                       int64_t batchIndex,
                                       Reference<ApplierBatchData> batchData,
                                       Database cx) {
+	state KeyRange bulkLoadRange;
+	state bool bulkLoad = false;
+	state bool bulkLoaded = false;
 	TraceEvent("FastRestoreApplierPhaseApplyTxnStart", applierID).detail("BatchIndex", batchIndex);
-	wait(precomputeMutationsResult(batchData, applierID, batchIndex, cx));
+	// A large batch into a range that is still empty is ingested as one SST file instead of many transactions
+	if (!SERVER_KNOBS->FASTRESTORE_APPLIER_BULKLOAD_FOLDER.empty() && !SERVER_KNOBS->FASTRESTORE_NOT_WRITE_DB &&
+	    !batchData->stagingKeys.empty() &&
+	    batchData->receivedBytes >= SERVER_KNOBS->FASTRESTORE_APPLIER_BULKLOAD_MIN_BYTES) {
+		bulkLoadRange =
+		    KeyRangeRef(batchData->stagingKeys.begin()->first, keyAfter(batchData->stagingKeys.rbegin()->first));
+		if (normalKeys.contains(bulkLoadRange)) {
+			wait(store(bulkLoad, canBulkLoadRange(bulkLoadRange, cx)));
+		}
+	}
+	wait(precomputeMutationsResult(batchData, applierID, batchIndex, cx, bulkLoad));
 
-	wait(applyStagingKeys(batchData, applierID, batchIndex, cx));
+	if (bulkLoad) {
+		CODE_PROBE(true, "Restore applier bulk loads a version batch");
+		wait(store(bulkLoaded, bulkLoadStagingKeys(batchData, bulkLoadRange, applierID, batchIndex, cx)));
+	}
+	if (!bulkLoaded) {
+		wait(applyStagingKeys(batchData, applierID, batchIndex, cx));
+	}
 	TraceEvent("FastRestoreApplierPhaseApplyTxnDone", applierID)
 	    .detail("BatchIndex", batchIndex)
 	    .detail("AppliedBytes", batchData->appliedBytes)
@@ -178,6 +178,59 @@ static Future<Optional<std::pair<WorkerEvents, std::set<std::string>>>> latestEr
 	return latestEventOnWorkers(workers, "");
 }
 
+void WorkerEventCache::removeMissing(std::vector<WorkerDetails> const& workers) {
+	std::set<UID> ids;
+	for (const auto& worker : workers) {
+		ids.insert(worker.interf.id());
+	}
+	for (auto it = events.begin(); it != events.end();) {
+		it = ids.count(it->first.first) ? std::next(it) : events.erase(it);
+	}
+}
+
+// Like latestEventOnWorkers, but only asks the workers whose event in cache is older than maxStaleness
+ACTOR static Future<Optional<std::pair<WorkerEvents, std::set<std::string>>>> cachedLatestEventOnWorkers(
+    std::vector<WorkerDetails> workers,
+    std::string eventName,
+    double maxStaleness,
+    WorkerEventCache* cache) {
+	state std::pair<WorkerEvents, std::set<std::string>> val;
+	state std::vector<WorkerDetails> stale;
+	for (const auto& worker : workers) {
+		auto cached = cache->events.find(std::make_pair(worker.interf.id(), eventName));
+		if (cached != cache->events.end() && now() - cached->second.fetched <= maxStaleness) {
+			val.first[worker.interf.address()] = cached->second.fields;
+		} else {
+			stale.push_back(worker);
+		}
+	}
+	CODE_PROBE(stale.size() < workers.size(), "Status reuses cached worker events");
+	if (stale.empty()) {
+		return val;
+	}
+
+	Optional<std::pair<WorkerEvents, std::set<std::string>>> fetched = wait(latestEventOnWorkers(stale, eventName));
+	if (!fetched.present()) {
+		return fetched;
+	}
+	const WorkerEvents& events = fetched.get().first;
+	val.second = fetched.get().second;
+	for (const auto& worker : stale) {
+		const NetworkAddress& address = worker.interf.address();
+		auto event = events.find(address);
+		if (event == events.end()) {
+			continue;
+		}
+		val.first[address] = event->second;
+		// Workers which did not answer or have not logged the event yet are asked again next time
+		if (event->second.size() && !val.second.count(address.toString())) {
+			cache->events[std::make_pair(worker.interf.id(), eventName)] =
+			    WorkerEventCache::Entry{ now(), event->second };
+		}
+	}
+	return val;
+}
+
 static Optional<WorkerDetails> getWorker(std::vector<WorkerDetails> const& workers, NetworkAddress const& address) {
 	try {
 		for (int c = 0; c < workers.size(); c++)
@@ -3060,7 +3113,8 @@ ACTOR Future<StatusReply> clusterGetStatus(
     ConfigBroadcaster const* configBroadcaster,
     Optional<UnversionedMetaclusterRegistrationEntry> metaclusterRegistration,
     metacluster::MetaclusterMetrics metaclusterMetrics,
-    std::unordered_map<NetworkAddress, double> excludedDegradedServers) {
+    std::unordered_map<NetworkAddress, double> excludedDegradedServers,
+    WorkerEventCache* workerEventCache) {
 
 	state double tStart = timer();
 
@@ -3165,12 +3219,17 @@ ACTOR Future<StatusReply> clusterGetStatus(
 		// WorkerEvents is a map of worker's NetworkAddress to its event string
 		// The pair represents worker responses and a set of worker NetworkAddress strings which did not respond.
 		std::vector<Future<Optional<std::pair<WorkerEvents, std::set<std::string>>>>> futures;
-		futures.push_back(latestEventOnWorkers(workers, "MachineMetrics"));
-		futures.push_back(latestEventOnWorkers(workers, "ProcessMetrics"));
-		futures.push_back(latestEventOnWorkers(workers, "NetworkMetrics"));
+		// Workers only log the metrics events every WORKER_LOGGING_INTERVAL and ProgramStart once per process, so
+		// those may come from earlier status requests.
+		workerEventCache->removeMissing(workers);
+		const double metricsStaleness = SERVER_KNOBS->STATUS_WORKER_METRICS_MAX_STALENESS;
+		futures.push_back(cachedLatestEventOnWorkers(workers, "MachineMetrics", metricsStaleness, workerEventCache));
+		futures.push_back(cachedLatestEventOnWorkers(workers, "ProcessMetrics", metricsStaleness, workerEventCache));
+		futures.push_back(cachedLatestEventOnWorkers(workers, "NetworkMetrics", metricsStaleness, workerEventCache));
 		futures.push_back(latestErrorOnWorkers(workers)); // Get all latest errors.
 		futures.push_back(latestEventOnWorkers(workers, "TraceFileOpenError"));
-		futures.push_back(latestEventOnWorkers(workers, "ProgramStart"));
+		futures.push_back(cachedLatestEventOnWorkers(
+		    workers, "ProgramStart", std::numeric_limits<double>::infinity(), workerEventCache));
 
 		// Wait for all response pairs.
 		state std::vector<Optional<std::pair<WorkerEvents, std::set<std::string>>>> workerEventsVec =
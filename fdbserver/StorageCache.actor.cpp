@@ -28,6 +28,7 @@
 #include "fdbclient/GetEncryptCipherKeys.h"
 #include "fdbserver/Knobs.h"
 #include "fdbserver/ServerDBInfo.h"
+#include "fdbserver/StorageMetrics.actor.h"
 #include "fdbclient/StorageServerInterface.h"
 #include "fdbclient/VersionedMap.h"
 #include "fdbclient/KeyRangeMap.h"
@@ -41,6 +42,7 @@
 #include "fdbclient/DatabaseContext.h"
 #include "fdbclient/NativeAPI.actor.h"
 #include "flow/Trace.h"
+#include "flow/UnitTest.h"
 #include "flow/actorcompiler.h" // This must be the last #include.
 
 // TODO storageCache server shares quite a bit of storageServer functionality, although simplified
@@ -55,6 +57,7 @@ bool canReplyWith(Error e) {
 	case error_code_wrong_shard_server:
 	case error_code_cold_cache_server:
 	case error_code_process_behind:
+	case error_code_server_overloaded:
 		// case error_code_all_alternatives_failed:
 		return true;
 	default:
@@ -96,12 +99,18 @@ struct AddingCacheRange : NonCopyable {
 };
 
 class CacheRangeInfo : public ReferenceCounted<CacheRangeInfo>, NonCopyable {
-	CacheRangeInfo(KeyRange keys, std::unique_ptr<AddingCacheRange>&& adding, StorageCacheData* readWrite)
-	  : adding(std::move(adding)), readWrite(readWrite), keys(keys) {}
+	CacheRangeInfo(KeyRange keys,
+	               std::unique_ptr<AddingCacheRange>&& adding,
+	               StorageCacheData* readWrite,
+	               bool admittable = false)
+	  : adding(std::move(adding)), readWrite(readWrite), admittable(admittable), keys(keys) {}
 
 public:
 	std::unique_ptr<AddingCacheRange> adding;
 	struct StorageCacheData* readWrite;
+	// Assigned to this cache but holding no data. With STORAGE_CACHE_ADMISSION_CONTROL, assigned ranges start out
+	// admittable and only the keys that are read often enough are fetched.
+	bool admittable;
 	KeyRange keys;
 	uint64_t changeCounter;
 
@@ -112,11 +121,13 @@ public:
 	static CacheRangeInfo* newAdding(StorageCacheData* data, KeyRange keys) {
 		return new CacheRangeInfo(keys, std::make_unique<AddingCacheRange>(data, keys), nullptr);
 	}
+	static CacheRangeInfo* newAdmittable(KeyRange keys) { return new CacheRangeInfo(keys, nullptr, nullptr, true); }
 
 	bool isReadable() const { return readWrite != nullptr; }
 	bool isAdding() const { return adding != nullptr; }
-	bool notAssigned() const { return !readWrite && !adding; }
-	bool assigned() const { return readWrite || adding; }
+	bool isAdmittable() const { return admittable; }
+	bool notAssigned() const { return !readWrite && !adding && !admittable; }
+	bool assigned() const { return readWrite || adding || admittable; }
 	bool isInVersionedData() const { return readWrite || (adding && adding->isTransferred()); }
 	void addMutation(Version version, MutationRef const& mutation);
 	bool isFetched() const { return readWrite || (adding && adding->fetchComplete.isSet()); }
@@ -124,6 +135,8 @@ public:
 	const char* debugDescribeState() const {
 		if (notAssigned())
 			return "NotAssigned";
+		else if (admittable)
+			return "Admittable";
 		else if (adding && !adding->isTransferred())
 			return "AddingFetching";
 		else if (adding)
@@ -150,6 +163,55 @@ struct FetchInjectionInfo {
 	std::vector<VerUpdateRef> changes;
 };
 
+// The ranges admitted into a cache server with STORAGE_CACHE_ADMISSION_CONTROL and the bytes they hold. A range is
+// charged STORAGE_CACHE_ADMISSION_ESTIMATE_BYTES when it is admitted, so that admissions still being fetched count
+// against STORAGE_CACHE_MEMORY_BUDGET, and what its fetch returned once the fetch completes.
+struct AdmittedCacheRanges {
+	struct Range {
+		Key end;
+		int64_t bytes;
+		bool fetched;
+	};
+	std::map<Key, Range> ranges; // by begin key
+	int64_t bytes = 0;
+	int64_t budget;
+	int64_t admissionEstimateBytes;
+
+	AdmittedCacheRanges()
+	  : AdmittedCacheRanges(SERVER_KNOBS->STORAGE_CACHE_MEMORY_BUDGET,
+	                        SERVER_KNOBS->STORAGE_CACHE_ADMISSION_ESTIMATE_BYTES) {}
+	AdmittedCacheRanges(int64_t budget, int64_t admissionEstimateBytes)
+	  : budget(budget), admissionEstimateBytes(admissionEstimateBytes) {}
+
+	bool hasRoom() const { return bytes < budget; }
+
+	void admit(KeyRangeRef keys) {
+		auto it = ranges.find(keys.begin);
+		if (it != ranges.end()) {
+			erase(it);
+		}
+		const int64_t estimate = keys.expectedSize() + admissionEstimateBytes;
+		ranges.emplace(keys.begin, Range{ keys.end, estimate, false });
+		bytes += estimate;
+	}
+
+	// Replaces the estimate charged for keys with what was fetched, unless keys were evicted or admitted again
+	// since the fetch started
+	void fetched(KeyRangeRef keys, int64_t fetchedBytes) {
+		auto it = ranges.find(keys.begin);
+		if (it != ranges.end() && it->second.end == keys.end && !it->second.fetched) {
+			bytes += fetchedBytes - it->second.bytes;
+			it->second.bytes = fetchedBytes;
+			it->second.fetched = true;
+		}
+	}
+
+	std::map<Key, Range>::iterator erase(std::map<Key, Range>::iterator it) {
+		bytes -= it->second.bytes;
+		return ranges.erase(it);
+	}
+};
+
 struct StorageCacheData {
 	typedef VersionedMap<KeyRef, ValueOrClearToRef> VersionedData;
 	// typedef VersionedMap<KeyRef, ValueOrClearToRef, FastAllocPTree<KeyRef>> VersionedData;
@@ -174,6 +236,11 @@ public:
 	KeyRangeMap<Reference<CacheRangeInfo>> cachedRangeMap; // map of cached key-ranges
 	uint64_t cacheRangeChangeCounter; // Max( CacheRangeInfo->changecounter )
 
+	// With STORAGE_CACHE_ADMISSION_CONTROL, counts reads of the assigned ranges to decide which keys to admit and which
+	// admitted keys have gone cold
+	ReadHotKeySketch admissionSketch;
+	AdmittedCacheRanges admitted;
+
 	// TODO Add cache metrics, such as available memory/in-use memory etc to help dat adistributor assign cached ranges
 	// StorageCacheMetrics metrics;
 
@@ -224,6 +291,7 @@ public:
 		Counter updateBatches, updateVersions;
 		Counter loops;
 		Counter readsRejected;
+		Counter admissions, evictions;
 
 		// LatencyBands readLatencyBands;
 
@@ -235,16 +303,22 @@ public:
 		    bytesFetched("BytesFetched", cc), mutationBytes("MutationBytes", cc), mutations("Mutations", cc),
 		    setMutations("SetMutations", cc), clearRangeMutations("ClearRangeMutations", cc),
 		    atomicMutations("AtomicMutations", cc), updateBatches("UpdateBatches", cc),
-		    updateVersions("UpdateVersions", cc), loops("Loops", cc), readsRejected("ReadsRejected", cc) {
+		    updateVersions("UpdateVersions", cc), loops("Loops", cc), readsRejected("ReadsRejected", cc),
+		    admissions("Admissions", cc), evictions("Evictions", cc) {
 			specialCounter(cc, "LastTLogVersion", [self]() { return self->lastTLogVersion; });
 			specialCounter(cc, "Version", [self]() { return self->version.get(); });
 			specialCounter(cc, "VersionLag", [self]() { return self->versionLag; });
+			specialCounter(cc, "AdmittedRanges", [self]() { return self->admitted.ranges.size(); });
+			specialCounter(cc, "AdmittedBytes", [self]() { return self->admitted.bytes; });
 		}
 	} counters;
 
 	explicit StorageCacheData(UID thisServerID, uint16_t index, Reference<AsyncVar<ServerDBInfo> const> const& db)
 	  : /*versionedData(FastAllocPTree<KeyRef>{std::make_shared<int>(0)}), */
 	    thisServerID(thisServerID), index(index), logProtocol(0), db(db), cacheRangeChangeCounter(0),
+	    admissionSketch(SERVER_KNOBS->READ_HOT_SKETCH_WIDTH,
+	                    SERVER_KNOBS->READ_HOT_SKETCH_DEPTH,
+	                    SERVER_KNOBS->READ_HOT_SKETCH_KEYS),
 	    lastTLogVersion(0), lastVersionWithData(0), peekVersion(0), compactionInProgress(Void()),
 	    fetchKeysParallelismLock(SERVER_KNOBS->FETCH_KEYS_PARALLELISM_BYTES), debug_inApplyUpdate(false),
 	    debug_lastValidateTime(0), versionLag(0), behind(false), counters(this) {
@@ -331,6 +405,7 @@ public:
 	}
 };
 void applyMutation(StorageCacheUpdater* updater, StorageCacheData* data, MutationRef const& mutation, Version version);
+void admitKey(StorageCacheData* data, KeyRef key);
 
 /////////////////////////////////// Validation ///////////////////////////////////////
 #pragma region Validation
@@ -503,6 +578,17 @@ ACTOR Future<Void> getValueQ(StorageCacheData* data, GetValueRequest req) {
 		if (data->cachedRangeMap[req.key]->notAssigned()) {
 			//TraceEvent(SevWarn, "WrongCacheServer", data->thisServerID).detail("Key", req.key).detail("ReqVersion", req.version).detail("DataVersion", data->version.get()).detail("In", "getValueQ");
 			throw wrong_shard_server();
+		} else if (SERVER_KNOBS->STORAGE_CACHE_ADMISSION_CONTROL) {
+			data->admissionSketch.add(req.key, 1);
+			if (!data->cachedRangeMap[req.key]->isReadable()) {
+				// Most keys of an assigned range are not cached. Send the client on to the storage servers the way an
+				// overloaded storage server would, rather than with future_version which would fail its read.
+				if (data->cachedRangeMap[req.key]->isAdmittable()) {
+					admitKey(data, req.key);
+				}
+				++data->counters.readsRejected;
+				throw server_overloaded();
+			}
 		} else if (!data->cachedRangeMap[req.key]->isReadable()) {
 			//TraceEvent(SevWarn, "ColdCacheServer", data->thisServerID).detail("Key", req.key).detail("IsAdding", data->cachedRangeMap[req.key]->isAdding())
 			//	.detail("ReqVersion", req.version).detail("DataVersion", data->version.get()).detail("In", "getValueQ");
@@ -713,7 +799,17 @@ KeyRange getCachedKeyRange(StorageCacheData* data, const KeySelectorRef& sel)
 
 	if (i->value()->notAssigned())
 		throw wrong_shard_server();
-	else if (!i->value()->isReadable())
+	else if (SERVER_KNOBS->STORAGE_CACHE_ADMISSION_CONTROL) {
+		data->admissionSketch.add(sel.getKey(), 1);
+		if (!i->value()->isReadable()) {
+			// Range reads are admitted by the key they start from
+			if (i->value()->isAdmittable()) {
+				admitKey(data, sel.getKey());
+			}
+			++data->counters.readsRejected;
+			throw server_overloaded();
+		}
+	} else if (!i->value()->isReadable())
 		throw future_version();
 
 	ASSERT(selectorInRange(sel, i->range()));
@@ -763,6 +859,11 @@ ACTOR Future<Void> getKeyValues(StorageCacheData* data, GetKeyValuesRequest req)
 			//TraceEvent(SevDebug, "WrongCacheRangeServer1", data->thisServerID).detail("Begin", req.begin.toString()).detail("End", req.end.toString()).detail("Version", version).
 			// detail("CacheRangeBegin", cachedKeyRange.begin).detail("CacheRangeEnd", cachedKeyRange.end).detail("In",
 			// "getKeyValues>checkShardExtents");
+			if (SERVER_KNOBS->STORAGE_CACHE_ADMISSION_CONTROL) {
+				// The range read extends past the admitted keys, which doesn't make the client's locations wrong
+				++data->counters.readsRejected;
+				throw server_overloaded();
+			}
 			throw wrong_shard_server();
 		}
 
@@ -840,12 +941,14 @@ ACTOR Future<Void> getKeyValues(StorageCacheData* data, GetKeyValuesRequest req)
 			data->counters.rowsQueried += r.data.size();
 		}
 	} catch (Error& e) {
-		TraceEvent(SevWarn, "SCGetKeyValuesError", data->thisServerID)
-		    .detail("Code", e.code())
-		    .detail("ReqBegin", req.begin.getKey())
-		    .detail("ReqEnd", req.end.getKey())
-		    .detail("ReqVersion", req.version)
-		    .detail("DataVersion", data->version.get());
+		if (e.code() != error_code_server_overloaded) {
+			TraceEvent(SevWarn, "SCGetKeyValuesError", data->thisServerID)
+			    .detail("Code", e.code())
+			    .detail("ReqBegin", req.begin.getKey())
+			    .detail("ReqEnd", req.end.getKey())
+			    .detail("ReqVersion", req.version)
+			    .detail("DataVersion", data->version.get());
+		}
 		if (!canReplyWith(e))
 			throw;
 		req.reply.sendError(e);
@@ -1059,15 +1162,16 @@ void addMutation(Reference<T>& target, Version version, MutationRef const& mutat
 
 template <class T>
 void splitMutation(StorageCacheData* data, KeyRangeMap<T>& map, MutationRef const& m, Version ver) {
+	// Keys that have not been admitted are not cached, so their mutations are dropped
 	if (isSingleKeyMutation((MutationRef::Type)m.type)) {
 		auto i = map.rangeContaining(m.param1);
-		if (i->value()) // If this key lies in the cached key-range on this server
+		if (i->value() && !i->value()->isAdmittable()) // If this key lies in the cached key-range on this server
 			data->addMutation(i->range(), ver, m);
 	} else if (m.type == MutationRef::ClearRange) {
 		KeyRangeRef mKeys(m.param1, m.param2);
 		auto r = map.intersectingRanges(mKeys);
 		for (auto i = r.begin(); i != r.end(); ++i) {
-			if (i->value()) { // if this sub-range exists on this cache server
+			if (i->value() && !i->value()->isAdmittable()) { // if this sub-range exists on this cache server
 				KeyRangeRef k = mKeys & i->range();
 				data->addMutation(i->range(), ver, MutationRef((MutationRef::Type)m.type, k.begin, k.end));
 			}
@@ -1162,6 +1266,7 @@ void coalesceCacheRanges(StorageCacheData* data, KeyRangeRef keys) {
 
 	bool lastReadable = false;
 	bool lastNotAssigned = false;
+	bool lastAdmittable = false;
 	KeyRangeMap<Reference<CacheRangeInfo>>::iterator lastRange;
 
 	for (; iter != iterEnd; ++iter) {
@@ -1173,14 +1278,66 @@ void coalesceCacheRanges(StorageCacheData* data, KeyRangeRef keys) {
 			KeyRange range = KeyRangeRef(lastRange->begin(), iter->end());
 			data->addCacheRange(CacheRangeInfo::newNotAssigned(range));
 			iter = data->cachedRangeMap.rangeContaining(range.begin);
+		} else if (lastAdmittable && iter->value()->isAdmittable()) {
+			KeyRange range = KeyRangeRef(lastRange->begin(), iter->end());
+			data->addCacheRange(CacheRangeInfo::newAdmittable(range));
+			iter = data->cachedRangeMap.rangeContaining(range.begin);
 		}
 
 		lastReadable = iter->value()->isReadable();
 		lastNotAssigned = iter->value()->notAssigned();
+		lastAdmittable = iter->value()->isAdmittable();
 		lastRange = iter;
 	}
 }
 
+// Replaces the cache ranges overlapping keys with a range of the same state, so that keys can be given a new state
+// (see addCacheRange)
+void reinitializeAffectedCacheRanges(StorageCacheData* data, KeyRangeRef keys) {
+	auto ranges = data->cachedRangeMap.getAffectedRangesAfterInsertion(keys, Reference<CacheRangeInfo>());
+	for (int i = 0; i < ranges.size(); i++) {
+		if (!ranges[i].value) {
+			ASSERT((KeyRangeRef&)ranges[i] == keys);
+		} else if (ranges[i].value->notAssigned()) {
+			data->addCacheRange(CacheRangeInfo::newNotAssigned(ranges[i]));
+		} else if (ranges[i].value->isAdmittable()) {
+			data->addCacheRange(CacheRangeInfo::newAdmittable(ranges[i]));
+		} else if (ranges[i].value->isReadable()) {
+			data->addCacheRange(CacheRangeInfo::newReadWrite(ranges[i], data));
+		} else {
+			ASSERT(ranges[i].value->adding);
+			data->addCacheRange(CacheRangeInfo::newAdding(data, ranges[i]));
+		}
+	}
+}
+
+// Starts fetching key into the cache once it has been read often enough, as long as the admitted data fits in
+// STORAGE_CACHE_MEMORY_BUDGET. The caller has checked that key is in an admittable range.
+void admitKey(StorageCacheData* data, KeyRef key) {
+	if (data->admissionSketch.estimate(key) < SERVER_KNOBS->STORAGE_CACHE_ADMISSION_READS ||
+	    !data->admitted.hasRoom()) {
+		return;
+	}
+	KeyRange keys = singleKeyRange(key);
+	reinitializeAffectedCacheRanges(data, keys);
+	data->addCacheRange(CacheRangeInfo::newAdding(data, keys));
+	data->admitted.admit(keys);
+	++data->counters.admissions;
+}
+
+// Drops an admitted range from the cache, making it admittable again
+void evictCacheRange(StorageCacheData* data, KeyRangeRef keys) {
+	ASSERT(data->cachedRangeMap[keys.begin]->isReadable());
+	reinitializeAffectedCacheRanges(data, keys);
+	data->addCacheRange(CacheRangeInfo::newAdmittable(keys));
+	// Readers are turned away from admittable ranges, but a later admission has to wait for the versions that still
+	// hold the evicted data to be compacted before fetching it again
+	data->newestAvailableVersion.insert(keys, data->version.get());
+	removeDataRange(data, data->addVersionToMutationLog(data->data().getLatestVersion()), data->cachedRangeMap, keys);
+	coalesceCacheRanges(data, keys);
+	++data->counters.evictions;
+}
+
 ACTOR Future<RangeResult> tryFetchRange(Database cx,
                                         Version version,
                                         KeyRangeRef keys,
@@ -1257,6 +1414,7 @@ ACTOR Future<Void> fetchKeys(StorageCacheData* data, AddingCacheRange* cacheRang
 	state double startt = now();
 	// TODO  we should probably change this for cache server
 	state int fetchBlockBytes = BUGGIFY ? SERVER_KNOBS->BUGGIFY_BLOCK_BYTES : SERVER_KNOBS->FETCH_BLOCK_BYTES;
+	state int64_t fetchedBytes = 0;
 
 	// delay(0) to force a return to the run loop before the work of fetchKeys is started.
 	//  This allows adding->start() to be called inline with CSK.
@@ -1354,6 +1512,7 @@ ACTOR Future<Void> fetchKeys(StorageCacheData* data, AddingCacheRange* cacheRang
 				// MutationRef(MutationRef::SetValue, k->key, k->value));
 
 				data->counters.bytesFetched += expectedSize;
+				fetchedBytes += expectedSize;
 				if (fetchBlockBytes > expectedSize) {
 					holdingFKPL.release(fetchBlockBytes - expectedSize);
 				}
@@ -1372,7 +1531,8 @@ ACTOR Future<Void> fetchKeys(StorageCacheData* data, AddingCacheRange* cacheRang
 				// TODO: If there was more to be fetched and we hit the limit before - possibly a case where data
 				// doesn't fit on this cache. For now, we can just fail this cache role. In future, we should think
 				// about evicting some data to make room for the remaining keys
-				if (this_block.more) {
+				// An admitted key is fetched alone, and its value may fill the block without there being more to fetch
+				if (this_block.more && !(keys.singleKeyRange() && this_block.size() == 1)) {
 					TraceEvent(SevDebug, "CacheWarmupMoreDataThanLimit", data->thisServerID).log();
 					throw please_reboot();
 				}
@@ -1512,6 +1672,8 @@ ACTOR Future<Void> fetchKeys(StorageCacheData* data, AddingCacheRange* cacheRang
 		data->addCacheRange(CacheRangeInfo::newReadWrite(cacheRange->keys, data)); // invalidates cacheRange!
 		coalesceCacheRanges(data, keys);
 
+		data->admitted.fetched(keys, fetchedBytes);
+
 		validate(data);
 
 		//++data->counters.fetchExecutingCount;
@@ -1590,7 +1752,9 @@ void CacheRangeInfo::addMutation(Version version, MutationRef const& mutation) {
 		adding->addMutation(version, mutation);
 	else if (readWrite)
 		readWrite->addMutation(this->keys, version, mutation);
-	else if (mutation.type != MutationRef::ClearRange) { // TODO NEELAM: ClearRange mutations are ignored (why do we
+	else if (admittable) {
+		// Not cached, so there is nothing to update
+	} else if (mutation.type != MutationRef::ClearRange) { // TODO NEELAM: ClearRange mutations are ignored (why do we
 		                                                 // even allow them on un-assigned range?)
 		TraceEvent(SevError, "DeliveredToNotAssigned").detail("Version", version).detail("Mutation", mutation);
 		ASSERT(false); // Mutation delivered to notAssigned cacheRange!
@@ -1632,19 +1796,7 @@ void cacheWarmup(StorageCacheData* data, const KeyRangeRef& keys, bool nowAssign
 	// As addCacheRange (called below)'s documentation requires, reinitialize any overlapping range(s)
 	auto ranges = data->cachedRangeMap.getAffectedRangesAfterInsertion(
 	    keys, Reference<CacheRangeInfo>()); // null reference indicates the range being changed
-	for (int i = 0; i < ranges.size(); i++) {
-		if (!ranges[i].value) {
-			ASSERT((KeyRangeRef&)ranges[i] == keys); // there shouldn't be any nulls except for the range being inserted
-		} else if (ranges[i].value->notAssigned())
-			data->addCacheRange(CacheRangeInfo::newNotAssigned(ranges[i]));
-		else if (ranges[i].value->isReadable())
-			data->addCacheRange(CacheRangeInfo::newReadWrite(ranges[i], data));
-		else {
-			ASSERT(ranges[i].value->adding);
-			data->addCacheRange(CacheRangeInfo::newAdding(data, ranges[i]));
-			// CODE_PROBE(true, "cacheWarmup reFetchKeys");
-		}
-	}
+	reinitializeAffectedCacheRanges(data, keys);
 
 	// CacheRange state depends on nowAssigned and whether the data is available (actually assigned in memory or on the
 	// disk) up to the given version.  The latter depends on data->newestAvailableVersion, so loop over the ranges of
@@ -1674,7 +1826,12 @@ void cacheWarmup(StorageCacheData* data, const KeyRangeRef& keys, bool nowAssign
 			data->addCacheRange(CacheRangeInfo::newNotAssigned(range));
 		} else if (!dataAvailable) {
 			// SOMEDAY: Avoid restarting adding/transferred cacheRanges
-			if (version == 0) { // bypass fetchkeys; cacheRange is known empty at version 0
+			if (SERVER_KNOBS->STORAGE_CACHE_ADMISSION_CONTROL) {
+				// Keys are fetched as they are admitted (see admitKey)
+				auto& cacheRange = data->cachedRangeMap[range.begin];
+				if (!cacheRange->assigned() || cacheRange->keys != range)
+					data->addCacheRange(CacheRangeInfo::newAdmittable(range));
+			} else if (version == 0) { // bypass fetchkeys; cacheRange is known empty at version 0
 				changeNewestAvailable.emplace_back(range, latestVersion);
 				data->addCacheRange(CacheRangeInfo::newReadWrite(range, data));
 				// setAvailableStatus(data, range, true);
@@ -1842,6 +1999,49 @@ ACTOR Future<Void> compactCache(StorageCacheData* data) {
 	}
 }
 
+// Evicts admitted keys that are no longer read often enough, and then the coldest ones while the admitted data is over
+// STORAGE_CACHE_MEMORY_BUDGET
+ACTOR Future<Void> evictColdCacheRanges(StorageCacheData* data) {
+	loop {
+		wait(delay(SERVER_KNOBS->STORAGE_CACHE_EVICTION_INTERVAL));
+		// Don't change the cache ranges while pullAsyncData is applying a batch
+		wait(data->updateVersionLock.take());
+		state FlowLock::Releaser holdingLock(data->updateVersionLock);
+
+		std::vector<std::pair<int64_t, KeyRange>> candidates;
+		for (auto it = data->admitted.ranges.begin(); it != data->admitted.ranges.end();) {
+			const auto& cacheRange = data->cachedRangeMap[it->first];
+			if (cacheRange->notAssigned() || cacheRange->isAdmittable()) {
+				// The range is no longer assigned to this cache, or was reassigned while the key was being fetched
+				it = data->admitted.erase(it);
+				continue;
+			}
+			if (cacheRange->isReadable() && it->second.fetched) {
+				candidates.emplace_back(data->admissionSketch.estimate(it->first), KeyRangeRef(it->first, it->second.end));
+			}
+			++it;
+		}
+		std::sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+		int evicted = 0;
+		for (const auto& [reads, keys] : candidates) {
+			if (reads >= SERVER_KNOBS->STORAGE_CACHE_ADMISSION_READS / 2 &&
+			    data->admitted.bytes <= data->admitted.budget) {
+				break;
+			}
+			data->admitted.erase(data->admitted.ranges.find(keys.begin));
+			evictCacheRange(data, keys);
+			++evicted;
+		}
+		if (evicted) {
+			TraceEvent("StorageCacheEvicted", data->thisServerID)
+			    .detail("Evicted", evicted)
+			    .detail("AdmittedRanges", data->admitted.ranges.size())
+			    .detail("AdmittedBytes", data->admitted.bytes);
+		}
+	}
+}
+
 ACTOR Future<Void> pullAsyncData(StorageCacheData* data) {
 	state Future<Void> dbInfoChange = Void();
 	state Reference<ILogSystem::IPeekCursor> cursor;
@@ -2242,6 +2442,9 @@ ACTOR Future<Void> storageCacheServer(StorageServerInterface ssi,
 
 	// pullAsyncData actor pulls mutations from the TLog and also applies them.
 	actors.add(pullAsyncData(&self));
+	if (SERVER_KNOBS->STORAGE_CACHE_ADMISSION_CONTROL) {
+		actors.add(evictColdCacheRanges(&self));
+	}
 	actors.add(watchInterface(&self, ssi));
 
 	actors.add(traceRole(Role::STORAGE_CACHE, ssi.id()));
@@ -2317,3 +2520,40 @@ ACTOR Future<Void> storageCacheServer(StorageServerInterface ssi,
 		}
 	}
 }
+
+TEST_CASE("/fdbserver/StorageCache/admittedCacheRanges") {
+	AdmittedCacheRanges admitted(10000, 3000);
+	KeyRange a = singleKeyRange("a"_sr);
+	KeyRange b = singleKeyRange("b"_sr);
+	KeyRange c = singleKeyRange("c"_sr);
+	const int64_t estimate = a.expectedSize() + 3000;
+
+	// Admissions in flight count against the budget before any of them has been fetched
+	admitted.admit(a);
+	admitted.admit(b);
+	admitted.admit(c);
+	ASSERT_EQ(admitted.bytes, 3 * estimate);
+	ASSERT(admitted.hasRoom());
+	admitted.admit(singleKeyRange("d"_sr));
+	ASSERT_EQ(admitted.bytes, 4 * estimate);
+	ASSERT(!admitted.hasRoom());
+
+	// A completed fetch replaces the estimate, once
+	admitted.fetched(a, 100);
+	admitted.fetched(a, 100);
+	ASSERT_EQ(admitted.bytes, 100 + 3 * estimate);
+	ASSERT(admitted.hasRoom());
+
+	// A fetch for a range that was evicted, or admitted again since it started, is not charged
+	admitted.erase(admitted.ranges.find(b.begin));
+	admitted.fetched(b, 5000);
+	admitted.admit(c);
+	admitted.fetched(KeyRangeRef("c"_sr, "cc"_sr), 5000);
+	ASSERT_EQ(admitted.bytes, 100 + 2 * estimate);
+
+	while (!admitted.ranges.empty()) {
+		admitted.erase(admitted.ranges.begin());
+	}
+	ASSERT_EQ(admitted.bytes, 0);
+	return Void();
+}
@@ -18,6 +18,9 @@
  * limitations under the License.
  */
 
+#include <limits>
+
+#include "flow/Hash3.h"
 #include "flow/UnitTest.h"
 #include "fdbserver/StorageMetrics.actor.h"
 #include "flow/actorcompiler.h" // This must be the last #include.
@@ -35,6 +38,7 @@ CommonStorageCounters::CommonStorageCounters(const std::string& name,
 		specialCounter(cc, "OpsReadSampleCount", [metrics]() { return metrics->opsReadSample.queue.size(); });
 		specialCounter(cc, "BytesWriteSampleCount", [metrics]() { return metrics->bytesWriteSample.queue.size(); });
 		specialCounter(cc, "IopsReadSampleCount", [metrics]() { return metrics->iopsSample.queue.size(); });
+		specialCounter(cc, "ReadHotKeysTracked", [metrics]() { return metrics->readHotKeys.trackedKeys(); });
 	}
 }
 
@@ -96,6 +100,119 @@ KeyRef StorageMetricSample::splitEstimate(KeyRangeRef range, int64_t offset, boo
 	return front ? range.end : range.begin;
 }
 
+ReadHotKeySketch::ReadHotKeySketch(int width, int depth, int maxKeys)
+  : width(width), depth(depth), maxKeys(maxKeys), current(width * depth, 0), previous(width * depth, 0),
+    intervalStart(0), hasPrevious(false), minHeavyHitter(0) {
+	ASSERT(width > 0 && depth > 0 && maxKeys > 0);
+}
+
+// Rows use double hashing, (h1 + row * h2) % width, so one hash of the key serves every row
+int ReadHotKeySketch::counterIndex(uint32_t h1, uint32_t h2, int row) const {
+	return row * width + (h1 + row * h2) % width;
+}
+
+void ReadHotKeySketch::rotate(double t) {
+	const double interval = SERVER_KNOBS->STORAGE_METRICS_AVERAGE_INTERVAL;
+	if (t - intervalStart < interval) {
+		return;
+	}
+	if (t - intervalStart < 2 * interval) {
+		previous.swap(current);
+		hasPrevious = true;
+	} else {
+		std::fill(previous.begin(), previous.end(), 0);
+		hasPrevious = false;
+	}
+	std::fill(current.begin(), current.end(), 0);
+	intervalStart = t;
+
+	// Keys that were not read in the previous interval have aged out of the window
+	minHeavyHitter = std::numeric_limits<int64_t>::max();
+	for (auto it = heavyHitters.begin(); it != heavyHitters.end();) {
+		it->second = estimate(it->first);
+		if (it->second == 0) {
+			it = heavyHitters.erase(it);
+		} else {
+			minHeavyHitter = std::min(minHeavyHitter, it->second);
+			++it;
+		}
+	}
+	if (heavyHitters.empty()) {
+		minHeavyHitter = 0;
+	}
+}
+
+void ReadHotKeySketch::evictMinHeavyHitter() {
+	auto victim = heavyHitters.begin();
+	for (auto it = heavyHitters.begin(); it != heavyHitters.end(); ++it) {
+		if (it->second < victim->second) {
+			victim = it;
+		}
+	}
+	heavyHitters.erase(victim);
+}
+
+void ReadHotKeySketch::add(KeyRef key, int64_t bytes, double t) {
+	rotate(t);
+	uint32_t h1 = 0, h2 = 0;
+	hashlittle2(key.begin(), key.size(), &h1, &h2);
+	int64_t est = std::numeric_limits<int64_t>::max();
+	for (int row = 0; row < depth; ++row) {
+		const int i = counterIndex(h1, h2, row);
+		current[i] += bytes;
+		est = std::min(est, current[i] + previous[i]);
+	}
+
+	auto it = heavyHitters.find(key);
+	if (it != heavyHitters.end()) {
+		it->second = est;
+		return;
+	}
+	if (heavyHitters.size() < maxKeys) {
+		heavyHitters.emplace(key, est);
+		minHeavyHitter = heavyHitters.size() == 1 ? est : std::min(minHeavyHitter, est);
+		return;
+	}
+	if (est <= minHeavyHitter) {
+		return;
+	}
+	// minHeavyHitter only bounds the smallest estimate from below since estimates grow after they are recorded, so
+	// refresh it before deciding whether key displaces a heavy hitter
+	minHeavyHitter = std::numeric_limits<int64_t>::max();
+	for (const auto& [_, count] : heavyHitters) {
+		minHeavyHitter = std::min(minHeavyHitter, count);
+	}
+	if (est > minHeavyHitter) {
+		evictMinHeavyHitter();
+		heavyHitters.emplace(key, est);
+		minHeavyHitter = est;
+		for (const auto& [_, count] : heavyHitters) {
+			minHeavyHitter = std::min(minHeavyHitter, count);
+		}
+	}
+}
+
+int64_t ReadHotKeySketch::estimate(KeyRef key) const {
+	uint32_t h1 = 0, h2 = 0;
+	hashlittle2(key.begin(), key.size(), &h1, &h2);
+	int64_t est = std::numeric_limits<int64_t>::max();
+	for (int row = 0; row < depth; ++row) {
+		const int i = counterIndex(h1, h2, row);
+		est = std::min(est, current[i] + previous[i]);
+	}
+	return est;
+}
+
+std::vector<std::pair<KeyRef, double>> ReadHotKeySketch::hotKeys(KeyRangeRef keys, double t) const {
+	const double window =
+	    std::max(1.0, t - intervalStart + (hasPrevious ? SERVER_KNOBS->STORAGE_METRICS_AVERAGE_INTERVAL : 0.0));
+	std::vector<std::pair<KeyRef, double>> result;
+	for (auto it = heavyHitters.lower_bound(keys.begin); it != heavyHitters.end() && it->first < keys.end; ++it) {
+		result.emplace_back(it->first, it->second / window);
+	}
+	return result;
+}
+
 // Get the current estimated metrics for the given keys
 StorageMetrics StorageServerMetrics::getMetrics(KeyRangeRef const& keys) const {
 	StorageMetrics result;
@@ -161,6 +278,7 @@ void StorageServerMetrics::notifyBytesReadPerKSecond(const Key& key, int64_t in)
 	    bytesReadSample.addAndExpire(key, in, expire) * SERVER_KNOBS->STORAGE_METRICS_AVERAGE_INTERVAL_PER_KSECONDS;
 	int64_t opsReadPerKSecond =
 	    opsReadSample.addAndExpire(key, 1, expire) * SERVER_KNOBS->STORAGE_METRICS_AVERAGE_INTERVAL_PER_KSECONDS;
+	readHotKeys.add(key, in);
 
 	if (bytesReadPerKSecond > 0 || opsReadPerKSecond > 0) {
 		StorageMetrics notifyMetrics;
@@ -531,8 +649,53 @@ int64_t StorageServerMetrics::getHotShards(const KeyRange& range) const {
 	return bytesWrittenPerKSecond;
 }
 
+Standalone<VectorRef<ReadHotRangeWithMetrics>> StorageServerMetrics::getReadHotKeyRanges(KeyRangeRef range,
+                                                                                      int limit) const {
+	Standalone<VectorRef<ReadHotRangeWithMetrics>> result;
+	std::vector<std::pair<KeyRangeRef, double>> merged;
+	limit = std::max(limit, 0);
+	for (const auto& [key, bandwidth] : readHotKeys.hotKeys(range)) {
+		KeyRangeRef keyRange(key, keyAfter(key, result.arena()));
+		if (!merged.empty() &&
+		    byteSample.getEstimate(KeyRangeRef(merged.back().first.end, keyRange.begin)) <
+		        SERVER_KNOBS->READ_HOT_SKETCH_MERGE_BYTES) {
+			merged.back().first = KeyRangeRef(merged.back().first.begin, keyRange.end);
+			merged.back().second += bandwidth;
+		} else {
+			merged.emplace_back(keyRange, bandwidth);
+		}
+	}
+
+	if ((int)merged.size() > limit) {
+		std::nth_element(merged.begin(), merged.begin() + limit, merged.end(), [](const auto& a, const auto& b) {
+			return a.second > b.second;
+		});
+		merged.resize(limit);
+		std::sort(merged.begin(), merged.end(), [](const auto& a, const auto& b) {
+			return a.first.begin < b.first.begin;
+		});
+	}
+
+	for (const auto& [keys, bandwidth] : merged) {
+		result.push_back_deep(
+		    result.arena(),
+		    ReadHotRangeWithMetrics(keys,
+		                            byteSample.getEstimate(keys),
+		                            bandwidth,
+		                            (double)opsReadSample.getEstimate(keys) /
+		                                SERVER_KNOBS->STORAGE_METRICS_AVERAGE_INTERVAL));
+	}
+	return result;
+}
+
 void StorageServerMetrics::getReadHotRanges(ReadHotSubRangeRequest req) const {
 	ReadHotSubRangeReply reply;
+	if (req.type == ReadHotSubRangeRequest::SplitType::HOT_KEYS) {
+		reply.readHotRanges = getReadHotKeyRanges(req.keys, req.chunkCount);
+		reply.hotKeys = true;
+		req.reply.send(reply);
+		return;
+	}
 	auto _ranges = getReadHotRanges(req.keys, req.chunkCount, req.type);
 	reply.readHotRanges = VectorRef(_ranges.data(), _ranges.size());
 	req.reply.send(reply);
@@ -929,3 +1092,66 @@ TEST_CASE("/fdbserver/StorageMetricSample/readHotDetect/equalDivide") {
 	ASSERT_EQ(t.at(3).bytes, 0);
 	return Void();
 }
+
+TEST_CASE("/fdbserver/StorageMetricSample/readHotKeySketch/heavyHitters") {
+	const double interval = SERVER_KNOBS->STORAGE_METRICS_AVERAGE_INTERVAL;
+	ReadHotKeySketch sketch(256, 4, 4);
+
+	// Two hot keys among many cold ones
+	for (int i = 0; i < 1000; ++i) {
+		sketch.add("Hot1"_sr, 1000, 1.0);
+		sketch.add("Hot2"_sr, 500, 1.0);
+		sketch.add(StringRef(format("Cold%04d", i)), 10, 1.0);
+	}
+	ASSERT_GE(sketch.estimate("Hot1"_sr), 1000 * 1000);
+	ASSERT_LE(sketch.trackedKeys(), 4);
+
+	auto hot = sketch.hotKeys(KeyRangeRef(""_sr, "\xff"_sr), 2.0);
+	bool foundHot1 = false, foundHot2 = false;
+	for (int i = 0; i < hot.size(); ++i) {
+		ASSERT(i == 0 || hot[i - 1].first < hot[i].first);
+		foundHot1 = foundHot1 || hot[i].first == "Hot1"_sr;
+		foundHot2 = foundHot2 || hot[i].first == "Hot2"_sr;
+	}
+	ASSERT(foundHot1 && foundHot2);
+	ASSERT(sketch.hotKeys(KeyRangeRef("Hot2"_sr, "\xff"_sr), 2.0).front().first == "Hot2"_sr);
+
+	// Reads stay visible for one more interval after it ends, then age out
+	sketch.add("Other"_sr, 1, 1.0 + interval);
+	ASSERT_GE(sketch.estimate("Hot1"_sr), 1000 * 1000);
+	sketch.add("Other"_sr, 1, 1.0 + 3 * interval);
+	ASSERT_EQ(sketch.estimate("Hot1"_sr), 0);
+	ASSERT_EQ(sketch.trackedKeys(), 1);
+	return Void();
+}
+
+TEST_CASE("/fdbserver/StorageMetricSample/readHotKeySketch/keyRanges") {
+	// The sketch tracks at most four keys, which must include A1, A2 and C1
+	const int maxKeys = 4;
+	StorageServerMetrics ssm;
+	ssm.readHotKeys = ReadHotKeySketch(SERVER_KNOBS->READ_HOT_SKETCH_WIDTH, SERVER_KNOBS->READ_HOT_SKETCH_DEPTH, maxKeys);
+	const double t = now();
+
+	ssm.byteSample.sample.insert("A"_sr, 10);
+	ssm.byteSample.sample.insert("B"_sr, 10 * SERVER_KNOBS->READ_HOT_SKETCH_MERGE_BYTES);
+	ssm.byteSample.sample.insert("C"_sr, 10);
+	for (int i = 0; i < 100; ++i) {
+		ssm.readHotKeys.add("A1"_sr, 1000, t);
+		ssm.readHotKeys.add("A2"_sr, 1000, t);
+		ssm.readHotKeys.add("C1"_sr, 500, t);
+	}
+
+	// A1 and A2 have no data between them and are reported as one range, C1 is separated from them by "B"
+	Standalone<VectorRef<ReadHotRangeWithMetrics>> ranges =
+	    ssm.getReadHotKeyRanges(KeyRangeRef(""_sr, "\xff"_sr), maxKeys);
+	ASSERT_EQ(ranges.size(), 2);
+	ASSERT(ranges[0].keys == KeyRangeRef("A1"_sr, keyAfter("A2"_sr)));
+	ASSERT(ranges[1].keys == KeyRangeRef("C1"_sr, keyAfter("C1"_sr)));
+	ASSERT_GT(ranges[0].readBandwidthSec, ranges[1].readBandwidthSec);
+
+	// With a limit only the hottest range is returned
+	ranges = ssm.getReadHotKeyRanges(KeyRangeRef(""_sr, "\xff"_sr), 1);
+	ASSERT_EQ(ranges.size(), 1);
+	ASSERT(ranges[0].keys.begin == "A1"_sr);
+	return Void();
+}
@@ -18,6 +18,7 @@
  * limitations under the License.
  */
 
+#include "flow/CompressionUtils.h"
 #include "flow/Hash3.h"
 #include "flow/UnitTest.h"
 #include "fdbclient/NativeAPI.actor.h"
@@ -202,7 +203,16 @@ private:
 // persistFormat has been mostly invalidated by TLogVersion, and can probably be removed when
 // 4.6's TLog code is removed.
 static const KeyValueRef persistFormat("Format"_sr, "FoundationDB/LogServer/3/0"_sr);
-static const KeyRangeRef persistFormatReadableRange("FoundationDB/LogServer/3/0"_sr, "FoundationDB/LogServer/4/0"_sr);
+// Written along with the first compacted spill segment (TagMsgSeg/), so that a TLog which doesn't know about segments
+// refuses the store instead of losing the spilled data they hold.
+static const KeyValueRef persistFormatSpillSegments("Format"_sr, "FoundationDB/LogServer/4/0"_sr);
+static const KeyRangeRef persistFormatReadableRange("FoundationDB/LogServer/3/0"_sr, "FoundationDB/LogServer/5/0"_sr);
+
+// The formats written by this TLog, which restorePersistentState() restores
+static bool isRestorablePersistFormat(ValueRef format) {
+	return format == persistFormat.value || format == persistFormatSpillSegments.value;
+}
+
 static const KeyRangeRef persistProtocolVersionKeys("ProtocolVersion/"_sr, "ProtocolVersion0"_sr);
 static const KeyRangeRef persistTLogSpillTypeKeys("TLogSpillType/"_sr, "TLogSpillType0"_sr);
 static const KeyRangeRef persistRecoveryCountKeys = KeyRangeRef("DbRecoveryCount/"_sr, "DbRecoveryCount0"_sr);
@@ -216,6 +226,7 @@ static const KeyRangeRef persistLogRouterTagsKeys = KeyRangeRef("LogRouterTags/"
 static const KeyRangeRef persistTxsTagsKeys = KeyRangeRef("TxsTags/"_sr, "TxsTags0"_sr);
 static const KeyRange persistTagMessagesKeys = prefixRange("TagMsg/"_sr);
 static const KeyRange persistTagMessageRefsKeys = prefixRange("TagMsgRef/"_sr);
+static const KeyRange persistTagMessageSegmentsKeys = prefixRange("TagMsgSeg/"_sr);
 static const KeyRange persistTagPoppedKeys = prefixRange("TagPop/"_sr);
 
 static const KeyRef persistEncryptionAtRestModeKey = "encryptionAtRestMode"_sr;
@@ -238,6 +249,15 @@ static Key persistTagMessageRefsKey(UID id, Tag tag, Version version) {
 	return wr.toValue();
 }
 
+static Key persistTagMessageSegmentsKey(UID id, Tag tag, Version version) {
+	BinaryWriter wr(Unversioned());
+	wr.serializeBytes(persistTagMessageSegmentsKeys.begin);
+	wr << id;
+	wr << tag;
+	wr << bigEndian64(version);
+	return wr.toValue();
+}
+
 static Key persistTagPoppedKey(UID id, Tag tag) {
 	BinaryWriter wr(Unversioned());
 	wr.serializeBytes(persistTagPoppedKeys.begin);
@@ -285,6 +305,40 @@ struct SpilledData {
 	uint32_t mutationBytes = 0;
 };
 
+// Spilled-by-reference data of a tag can be compacted out of the disk queue into segments. A segment holds the
+// messages of the tag for consecutive spilled versions, and is stored under the last of those versions. Its value is
+// the compression filter, the uncompressed length, and the (compressed) sequence of (version, length, messages).
+static Value encodeSpilledSegment(CompressionFilter filter, StringRef raw) {
+	Arena arena;
+	StringRef payload = raw;
+	if (filter != CompressionFilter::NONE) {
+		payload = CompressionUtils::compress(filter, raw, arena);
+		if (payload.size() >= raw.size()) {
+			filter = CompressionFilter::NONE;
+			payload = raw;
+		}
+	}
+	BinaryWriter wr(Unversioned());
+	wr << (uint8_t)filter << (uint32_t)raw.size();
+	wr.serializeBytes(payload);
+	return wr.toValue();
+}
+
+static StringRef decodeSpilledSegment(ValueRef value, Arena& arena) {
+	uint8_t filter;
+	uint32_t rawLength;
+	BinaryReader rd(value, Unversioned());
+	rd >> filter >> rawLength;
+	StringRef payload = value.substr(sizeof(filter) + sizeof(rawLength));
+	if ((CompressionFilter)filter == CompressionFilter::NONE) {
+		ASSERT(payload.size() == rawLength);
+		return payload;
+	}
+	StringRef raw = CompressionUtils::decompress((CompressionFilter)filter, payload, rawLength, arena);
+	ASSERT(raw.size() == rawLength);
+	return raw;
+}
+
 struct TLogData : NonCopyable {
 	AsyncTrigger newLogData;
 	// A process has only 1 SharedTLog, which holds data for multiple logs, so that it obeys its assigned memory limit.
@@ -352,6 +406,8 @@ struct TLogData : NonCopyable {
 	std::string dataFolder; // folder where data is stored
 	// End of fields used by snapshot based backup and restore
 
+	bool spillSegmentsFormat = false; // persistentData is in persistFormatSpillSegments, and may hold segments
+
 	Reference<AsyncVar<bool>> degraded;
 	std::vector<TagsAndMessage> tempTagMessages;
 
@@ -410,6 +466,8 @@ struct LogData : NonCopyable, public ReferenceCounted<LogData> {
 		Version versionForPoppedLocation; // `poppedLocation` was calculated at this popped version
 		IDiskQueue::location poppedLocation; // The location of the earliest commit with data for this tag.
 		bool unpoppedRecovered;
+		bool spilledSegments; // false means tag is *known* to have no compacted segments in persistentData
+		int64_t uncompactedRefBatches; // spilled reference batches written since the last compaction
 		Tag tag;
 
 		TagData(Tag tag,
@@ -420,13 +478,14 @@ struct LogData : NonCopyable, public ReferenceCounted<LogData> {
 		        bool unpoppedRecovered)
 		  : nothingPersistent(nothingPersistent), poppedRecently(poppedRecently), popped(popped), persistentPopped(0),
 		    versionForPoppedLocation(0), poppedLocation(poppedLocation), unpoppedRecovered(unpoppedRecovered),
-		    tag(tag) {}
+		    spilledSegments(!nothingPersistent), uncompactedRefBatches(0), tag(tag) {}
 
 		TagData(TagData&& r) noexcept
 		  : versionMessages(std::move(r.versionMessages)), nothingPersistent(r.nothingPersistent),
 		    poppedRecently(r.poppedRecently), popped(r.popped), persistentPopped(r.persistentPopped),
 		    versionForPoppedLocation(r.versionForPoppedLocation), poppedLocation(r.poppedLocation),
-		    unpoppedRecovered(r.unpoppedRecovered), tag(r.tag) {}
+		    unpoppedRecovered(r.unpoppedRecovered), spilledSegments(r.spilledSegments),
+		    uncompactedRefBatches(r.uncompactedRefBatches), tag(r.tag) {}
 		void operator=(TagData&& r) noexcept {
 			versionMessages = std::move(r.versionMessages);
 			nothingPersistent = r.nothingPersistent;
@@ -437,6 +496,8 @@ struct LogData : NonCopyable, public ReferenceCounted<LogData> {
 			poppedLocation = r.poppedLocation;
 			tag = r.tag;
 			unpoppedRecovered = r.unpoppedRecovered;
+			spilledSegments = r.spilledSegments;
+			uncompactedRefBatches = r.uncompactedRefBatches;
 		}
 
 		// Erase messages not needed to update *from* versions >= before (thus, messages with toversion <= before)
@@ -571,12 +632,17 @@ struct LogData : NonCopyable, public ReferenceCounted<LogData> {
 	Counter blockingPeekTimeouts;
 	Counter emptyPeeks;
 	Counter nonEmptyPeeks;
+	Counter spillCompactions;
+	Counter spillCompactedBytes;
 	std::map<Tag, LatencySample> blockingPeekLatencies;
 	std::map<Tag, LatencySample> peekVersionCounts;
 
 	UID logId;
 	ProtocolVersion protocolVersion;
 	Version newPersistentDataVersion;
+	// Changes whenever spilled data may have moved from references to segments, so that a peek which read both can
+	// tell whether it saw a consistent view
+	uint64_t spillGeneration;
 	Future<Void> removed;
 	PromiseStream<Future<Void>> addActor;
 	TLogData* tLogData;
@@ -660,9 +726,10 @@ struct LogData : NonCopyable, public ReferenceCounted<LogData> {
 	    unpoppedRecoveredTagCount(0), cc("TLog", interf.id().toString()), bytesInput("BytesInput", cc),
 	    bytesDurable("BytesDurable", cc), blockingPeeks("BlockingPeeks", cc),
 	    blockingPeekTimeouts("BlockingPeekTimeouts", cc), emptyPeeks("EmptyPeeks", cc),
-	    nonEmptyPeeks("NonEmptyPeeks", cc), logId(interf.id()), protocolVersion(protocolVersion),
-	    newPersistentDataVersion(invalidVersion), tLogData(tLogData), unrecoveredBefore(1), recoveredAt(1),
-	    recoveryTxnVersion(1), logSystem(new AsyncVar<Reference<ILogSystem>>()), remoteTag(remoteTag),
+	    nonEmptyPeeks("NonEmptyPeeks", cc), spillCompactions("SpillCompactions", cc),
+	    spillCompactedBytes("SpillCompactedBytes", cc), logId(interf.id()), protocolVersion(protocolVersion),
+	    newPersistentDataVersion(invalidVersion), spillGeneration(0), tLogData(tLogData), unrecoveredBefore(1),
+	    recoveredAt(1), recoveryTxnVersion(1), logSystem(new AsyncVar<Reference<ILogSystem>>()), remoteTag(remoteTag),
 	    isPrimary(isPrimary), logRouterTags(logRouterTags), logRouterPoppedVersion(0), logRouterPopToVersion(0),
 	    locality(tagLocalityInvalid), recruitmentID(recruitmentID), logSpillType(logSpillType),
 	    allTags(tags.begin(), tags.end()), terminated(tLogData->terminated.getFuture()), execOpCommitInProgress(false),
@@ -729,6 +796,8 @@ struct LogData : NonCopyable, public ReferenceCounted<LogData> {
 			tLogData->persistentData->clear(KeyRangeRef(msgKey, strinc(msgKey)));
 			Key msgRefKey = logIdKey.withPrefix(persistTagMessageRefsKeys.begin);
 			tLogData->persistentData->clear(KeyRangeRef(msgRefKey, strinc(msgRefKey)));
+			Key msgSegmentKey = logIdKey.withPrefix(persistTagMessageSegmentsKeys.begin);
+			tLogData->persistentData->clear(KeyRangeRef(msgSegmentKey, strinc(msgSegmentKey)));
 			Key poppedKey = logIdKey.withPrefix(persistTagPoppedKeys.begin);
 			tLogData->persistentData->clear(KeyRangeRef(poppedKey, strinc(poppedKey)));
 		}
@@ -884,6 +953,11 @@ void updatePersistentPopped(TLogData* self, Reference<LogData> logData, Referenc
 	} else {
 		self->persistentData->clear(KeyRangeRef(persistTagMessageRefsKey(logData->logId, data->tag, Version(0)),
 		                                        persistTagMessageRefsKey(logData->logId, data->tag, data->popped)));
+		if (data->spilledSegments) {
+			self->persistentData->clear(
+			    KeyRangeRef(persistTagMessageSegmentsKey(logData->logId, data->tag, Version(0)),
+			                persistTagMessageSegmentsKey(logData->logId, data->tag, data->popped)));
+		}
 	}
 
 	if (data->popped > logData->persistentDataVersion) {
@@ -900,6 +974,7 @@ ACTOR Future<Void> updatePoppedLocation(TLogData* self, Reference<LogData> logDa
 	if (data->versionForPoppedLocation >= data->persistentPopped)
 		return Void();
 	data->versionForPoppedLocation = data->persistentPopped;
+	state bool unreferenced = false;
 
 	// Use persistentPopped and not popped, so that a pop update received after spilling doesn't cause
 	// us to remove data that still is pointed to by SpilledData in the btree.
@@ -911,8 +986,21 @@ ACTOR Future<Void> updatePoppedLocation(TLogData* self, Reference<LogData> logDa
 		    1));
 
 		if (kvrefs.empty()) {
+			// Nothing in the disk queue is referenced, but compacted segments may still hold spilled data.
+			unreferenced = true;
+			if (data->spilledSegments) {
+				state uint64_t spillGeneration = logData->spillGeneration;
+				RangeResult segments = wait(self->persistentData->readRange(
+				    KeyRangeRef(
+				        persistTagMessageSegmentsKey(logData->logId, data->tag, data->persistentPopped),
+				        persistTagMessageSegmentsKey(logData->logId, data->tag, logData->persistentDataVersion + 1)),
+				    1));
+				if (segments.empty() && spillGeneration == logData->spillGeneration) {
+					data->spilledSegments = false;
+				}
+			}
 			// Nothing was persistent after all.
-			data->nothingPersistent = true;
+			data->nothingPersistent = !data->spilledSegments;
 		} else {
 			VectorRef<SpilledData> spilledData;
 			BinaryReader r(kvrefs[0].value, AssumeVersion(logData->protocolVersion));
@@ -928,7 +1016,7 @@ ACTOR Future<Void> updatePoppedLocation(TLogData* self, Reference<LogData> logDa
 		}
 	}
 
-	if (data->persistentPopped >= logData->persistentDataVersion || data->nothingPersistent) {
+	if (data->persistentPopped >= logData->persistentDataVersion || data->nothingPersistent || unreferenced) {
 		// Then the location must be in memory.
 		auto locationIter = logData->versionLocation.lower_bound(data->persistentPopped);
 		if (locationIter != logData->versionLocation.end()) {
@@ -1002,6 +1090,112 @@ ACTOR Future<Void> popDiskQueue(TLogData* self, Reference<LogData> logData) {
 	return Void();
 }
 
+// Rewrites the oldest durable spilled-by-reference data of a tag into one compressed segment, so that peeks of a
+// lagging tag read it sequentially from persistentData instead of reading the disk queue once per commit. The segment
+// is set and the references it replaces are cleared in the same persistentData commit.
+ACTOR Future<Void> compactSpilledData(TLogData* self,
+                                      Reference<LogData> logData,
+                                      Reference<LogData::TagData> tagData) {
+	state std::vector<std::pair<IDiskQueue::location, IDiskQueue::location>> commitLocations;
+	state std::vector<Future<Standalone<StringRef>>> messageReads;
+	state BinaryWriter raw(Unversioned());
+	state Version lastVersion = invalidVersion;
+	state Key lastRefKey;
+	state uint64_t commitBytes = 0;
+	state int batches = 0;
+	state int index = 0;
+
+	RangeResult kvrefs = wait(self->persistentData->readRange(
+	    KeyRangeRef(persistTagMessageRefsKey(logData->logId, tagData->tag, tagData->persistentPopped),
+	                persistTagMessageRefsKey(logData->logId, tagData->tag, logData->persistentDataDurableVersion + 1)),
+	    SERVER_KNOBS->TLOG_SPILL_REFERENCE_MAX_BATCHES_PER_PEEK));
+	uint64_t mutationBytes = 0;
+	for (; batches < kvrefs.size() && mutationBytes < SERVER_KNOBS->TLOG_SPILL_COMPACTION_SEGMENT_BYTES; batches++) {
+		VectorRef<SpilledData> spilledData;
+		BinaryReader r(kvrefs[batches].value, AssumeVersion(logData->protocolVersion));
+		r >> spilledData;
+		for (const SpilledData& sd : spilledData) {
+			if (sd.version >= tagData->persistentPopped) {
+				commitLocations.emplace_back(sd.start, sd.start.lo + sd.length);
+				commitBytes += sd.length;
+				mutationBytes += sd.mutationBytes;
+			}
+		}
+		lastRefKey = kvrefs[batches].key;
+	}
+	if (commitLocations.empty()) {
+		tagData->uncompactedRefBatches = 0;
+		return Void();
+	}
+
+	wait(self->peekMemoryLimiter.take(TaskPriority::UpdateStorage, commitBytes));
+	state FlowLock::Releaser memoryReservation(self->peekMemoryLimiter, commitBytes);
+	messageReads.reserve(commitLocations.size());
+	for (const auto& pair : commitLocations) {
+		messageReads.push_back(self->rawPersistentQueue->read(pair.first, pair.second, CheckHashes::True));
+	}
+	wait(waitForAll(messageReads));
+
+	for (index = 0; index < messageReads.size(); index++) {
+		Standalone<StringRef> queueEntryData = messageReads[index].get();
+		uint8_t valid;
+		const uint32_t length = *(uint32_t*)queueEntryData.begin();
+		queueEntryData = queueEntryData.substr(4, queueEntryData.size() - 4);
+		BinaryReader rd(queueEntryData, IncludeVersion());
+		state TLogQueueEntry entry;
+		rd >> entry >> valid;
+		ASSERT(valid == 0x01);
+		ASSERT(length + sizeof(valid) == queueEntryData.size());
+
+		std::vector<StringRef> rawMessages =
+		    wait(parseMessagesForTag(entry.messages, tagData->tag, logData->logRouterTags));
+		uint32_t messageBytes = 0;
+		for (const StringRef& msg : rawMessages) {
+			messageBytes += msg.size();
+		}
+		raw << entry.version << messageBytes;
+		for (const StringRef& msg : rawMessages) {
+			raw.serializeBytes(msg);
+		}
+		lastVersion = entry.version;
+	}
+	messageReads.clear();
+	memoryReservation.release();
+
+	CompressionFilter filter = CompressionFilter::NONE;
+	if (CompressionUtils::supportedFilters.contains(
+	        CompressionUtils::fromFilterString(SERVER_KNOBS->TLOG_SPILL_COMPACTION_FILTER))) {
+		filter = CompressionUtils::fromFilterString(SERVER_KNOBS->TLOG_SPILL_COMPACTION_FILTER);
+	}
+	Value segment = encodeSpilledSegment(filter, raw.toValue());
+	if (!self->spillSegmentsFormat) {
+		CODE_PROBE(true, "TLog persistent format upgraded for spill segments");
+		TraceEvent("TLogSpillSegmentsFormat", self->dbgid).detail("Format", persistFormatSpillSegments.value);
+		self->persistentData->set(persistFormatSpillSegments);
+		self->spillSegmentsFormat = true;
+	}
+	self->persistentData->set(
+	    KeyValueRef(persistTagMessageSegmentsKey(logData->logId, tagData->tag, lastVersion), segment));
+	self->persistentData->clear(
+	    KeyRangeRef(persistTagMessageRefsKey(logData->logId, tagData->tag, Version(0)), keyAfter(lastRefKey)));
+	tagData->spilledSegments = true;
+	tagData->uncompactedRefBatches = std::max<int64_t>(0, tagData->uncompactedRefBatches - batches);
+	logData->spillGeneration++;
+	++logData->spillCompactions;
+	logData->spillCompactedBytes += raw.getLength();
+	CODE_PROBE(true, "TLog compacted spilled data into a segment");
+	TraceEvent(SevDebug, "TLogSpillCompaction", self->dbgid)
+	    .detail("LogId", logData->logId)
+	    .detail("Tag", tagData->tag.toString())
+	    .detail("Batches", batches)
+	    .detail("Versions", commitLocations.size())
+	    .detail("LastVersion", lastVersion)
+	    .detail("RawBytes", raw.getLength())
+	    .detail("SegmentBytes", segment.size())
+	    .detail("DiskQueueBytes", commitBytes);
+	return Void();
+}
+
 ACTOR Future<Void> updatePersistentData(TLogData* self, Reference<LogData> logData, Version newPersistentDataVersion) {
 	state BinaryWriter wr(Unversioned());
 	// PERSIST: Changes self->persistentDataVersion and writes and commits the relevant changes
@@ -1014,6 +1208,7 @@ ACTOR Future<Void> updatePersistentData(TLogData* self, Reference<LogData> logDa
 	//TraceEvent("UpdatePersistentData", self->dbgid).detail("Seq", newPersistentDataSeq);
 
 	state bool anyData = false;
+	state std::vector<Reference<LogData::TagData>> tagsToCompact;
 
 	// For all existing tags
 	state int tagLocality = 0;
@@ -1074,6 +1269,7 @@ ACTOR Future<Void> updatePersistentData(TLogData* self, Reference<LogData> logDa
 							self->persistentData->set(KeyValueRef(
 							    persistTagMessageRefsKey(logData->logId, tagData->tag, lastVersion), wr.toValue()));
 							tagData->poppedLocation = std::min(tagData->poppedLocation, firstLocation);
+							tagData->uncompactedRefBatches++;
 							refSpilledTagCount = 0;
 							wr = BinaryWriter(AssumeVersion(logData->protocolVersion));
 							wr << uint32_t(0);
@@ -1095,6 +1291,14 @@ ACTOR Future<Void> updatePersistentData(TLogData* self, Reference<LogData> logDa
 					self->persistentData->set(
 					    KeyValueRef(persistTagMessageRefsKey(logData->logId, tagData->tag, lastVersion), wr.toValue()));
 					tagData->poppedLocation = std::min(tagData->poppedLocation, firstLocation);
+					tagData->uncompactedRefBatches++;
+				}
+
+				// References spilled by earlier updates of a tag that is still not popped mean its storage servers
+				// are lagging, and will peek this data from disk.
+				if (SERVER_KNOBS->ENABLE_TLOG_SPILL_COMPACTION && logData->shouldSpillByReference(tagData->tag) &&
+				    tagData->uncompactedRefBatches >= SERVER_KNOBS->TLOG_SPILL_COMPACTION_MIN_BATCHES) {
+					tagsToCompact.push_back(tagData);
 				}
 
 				wait(yield(TaskPriority::UpdateStorage));
@@ -1102,6 +1306,14 @@ ACTOR Future<Void> updatePersistentData(TLogData* self, Reference<LogData> logDa
 		}
 	}
 
+	// Compactions read the disk queue, so they run once all tags have been spilled rather than holding up the tags
+	// that come after them.
+	state int compactIndex = 0;
+	for (; compactIndex < tagsToCompact.size(); compactIndex++) {
+		wait(compactSpilledData(self, logData, tagsToCompact[compactIndex]));
+		wait(yield(TaskPriority::UpdateStorage));
+	}
+
 	auto locationIter = logData->versionLocation.lower_bound(newPersistentDataVersion);
 	if (locationIter != logData->versionLocation.end()) {
 		self->persistentData->set(
@@ -1126,6 +1338,10 @@ ACTOR Future<Void> updatePersistentData(TLogData* self, Reference<LogData> logDa
 	// SOMEDAY: This seems to be running pretty often, should we slow it down???
 	// This needs a timeout since nothing prevents I/O operations from hanging indefinitely.
 	wait(ioTimeoutError(self->persistentData->commit(), tLogMaxCreateDuration, "TLogCommit"));
+	if (!tagsToCompact.empty()) {
+		// Peeks must also notice the compaction becoming durable, for storage engines that only expose committed data
+		logData->spillGeneration++;
+	}
 
 	wait(delay(0, TaskPriority::UpdateStorage));
 
@@ -1740,6 +1956,142 @@ ACTOR Future<std::vector<StringRef>> parseMessagesForTag(StringRef commitBlob, T
 	return relevantMessages;
 }
 
+struct SpilledSegmentPeek {
+	Standalone<StringRef> messages; // In the peek reply format
+	Version lastVersion = invalidVersion; // The last version in messages
+	int64_t mutationBytes = 0;
+	bool limitReached = false; // True if segments may hold versions after lastVersion
+};
+
+// Decodes the messages from begin on in segments, as read from persistentData with a limit of
+// TLOG_SPILL_COMPACTION_MAX_SEGMENTS_PER_PEEK + 1, up to DESIRED_TOTAL_BYTES.
+static SpilledSegmentPeek decodeSpilledSegments(RangeResult const& segments, Version begin) {
+	SpilledSegmentPeek result;
+	BinaryWriter messages(Unversioned());
+	Arena arena;
+	for (int i = 0; i < segments.size() && i < SERVER_KNOBS->TLOG_SPILL_COMPACTION_MAX_SEGMENTS_PER_PEEK; i++) {
+		BinaryReader rd(decodeSpilledSegment(segments[i].value, arena), Unversioned());
+		while (!rd.empty()) {
+			Version version;
+			uint32_t length;
+			rd >> version >> length;
+			const uint8_t* data = (const uint8_t*)rd.readBytes(length);
+			if (version < begin) {
+				continue;
+			}
+			if (result.mutationBytes >= SERVER_KNOBS->DESIRED_TOTAL_BYTES) {
+				result.limitReached = true;
+				break;
+			}
+			messages << VERSION_HEADER << version;
+			messages.serializeBytes(data, length);
+			result.mutationBytes += length;
+			result.lastVersion = version;
+		}
+		if (result.limitReached) {
+			break;
+		}
+	}
+	result.limitReached =
+	    result.limitReached || segments.size() > SERVER_KNOBS->TLOG_SPILL_COMPACTION_MAX_SEGMENTS_PER_PEEK;
+	result.messages = messages.toValue();
+	return result;
+}
+
+// Reads the messages of tag in compacted segments from begin on, up to DESIRED_TOTAL_BYTES.
+ACTOR Future<SpilledSegmentPeek> peekSpilledSegments(TLogData* self,
+                                                     Reference<LogData> logData,
+                                                     Tag tag,
+                                                     Version begin) {
+	RangeResult segments = wait(self->persistentData->readRange(
+	    KeyRangeRef(persistTagMessageSegmentsKey(logData->logId, tag, begin),
+	                persistTagMessageSegmentsKey(logData->logId, tag, logData->persistentDataDurableVersion + 1)),
+	    SERVER_KNOBS->TLOG_SPILL_COMPACTION_MAX_SEGMENTS_PER_PEEK + 1));
+	return decodeSpilledSegments(segments, begin);
+}
+
+// Picks the disk queue commits to read for the references in kvrefs, as read from persistentData with a limit of
+// TLOG_SPILL_REFERENCE_MAX_BATCHES_PER_PEEK + 1, for the versions from begin on after the ones segmentPeek returned.
+// Stops once the peek holds DESIRED_TOTAL_BYTES of mutations. Returns true if the peek ends before the last spilled
+// version.
+static bool selectSpilledCommits(RangeResult const& kvrefs,
+                                 ProtocolVersion protocolVersion,
+                                 Version begin,
+                                 SpilledSegmentPeek const& segmentPeek,
+                                 std::vector<std::pair<IDiskQueue::location, IDiskQueue::location>>& commitLocations,
+                                 uint64_t& commitBytes) {
+	bool earlyEnd = segmentPeek.limitReached;
+	uint32_t mutationBytes = static_cast<uint32_t>(segmentPeek.mutationBytes);
+	for (int i = 0; i < kvrefs.size() && i < SERVER_KNOBS->TLOG_SPILL_REFERENCE_MAX_BATCHES_PER_PEEK; i++) {
+		auto& kv = kvrefs[i];
+		VectorRef<SpilledData> spilledData;
+		BinaryReader r(kv.value, AssumeVersion(protocolVersion));
+		r >> spilledData;
+		for (const SpilledData& sd : spilledData) {
+			if (mutationBytes >= SERVER_KNOBS->DESIRED_TOTAL_BYTES) {
+				earlyEnd = true;
+				break;
+			}
+			if (sd.version >= begin && sd.version > segmentPeek.lastVersion) {
+				const IDiskQueue::location end = sd.start.lo + sd.length;
+				commitLocations.emplace_back(sd.start, end);
+				// This isn't perfect, because we aren't accounting for page boundaries, but should be
+				// close enough.
+				commitBytes += sd.length;
+				mutationBytes += sd.mutationBytes;
+			}
+		}
+		if (earlyEnd)
+			break;
+	}
+	return earlyEnd || (kvrefs.size() >= SERVER_KNOBS->TLOG_SPILL_REFERENCE_MAX_BATCHES_PER_PEEK + 1);
+}
+
+// Runs read again until no spill compaction of the log ran while it did. A compaction moves spilled data from
+// references into a segment, so a peek whose segment and reference reads straddle one could miss or repeat that data.
+ACTOR template <class T>
+Future<T> readBetweenSpillCompactions(const uint64_t* spillGeneration, std::function<Future<T>()> read) {
+	state uint64_t generation;
+	loop {
+		generation = *spillGeneration;
+		T result = wait(read());
+		if (generation == *spillGeneration) {
+			return result;
+		}
+		CODE_PROBE(true, "TLog spilled peek raced with a spill compaction");
+	}
+}
+
+struct SpilledIndexPeek {
+	SpilledSegmentPeek segmentPeek;
+	RangeResult kvrefs; // References to the spilled commits after the last version in segmentPeek
+};
+
+// Reads the compacted segments of tag from begin on, and the references to spilled data after them unless the
+// segments already fill the peek.
+ACTOR Future<SpilledIndexPeek> peekSpilledIndex(TLogData* self, Reference<LogData> logData, Tag tag, Version begin) {
+	state SpilledIndexPeek result;
+	Reference<LogData::TagData> tagData = logData->getTagData(tag);
+	if (tagData && tagData->spilledSegments) {
+		wait(store(result.segmentPeek, peekSpilledSegments(self, logData, tag, begin)));
+	}
+	if (!result.segmentPeek.limitReached) {
+		if (BUGGIFY_WITH_PROB(0.01)) {
+			// Give a compaction the chance to run between the two reads
+			wait(delay(deterministicRandom()->random01(), TaskPriority::TLogSpilledPeekReply));
+		}
+		// FIXME: Limit to approximately DESIRED_TOTATL_BYTES somehow.
+		wait(store(result.kvrefs,
+		           self->persistentData->readRange(
+		               KeyRangeRef(persistTagMessageRefsKey(
+		                               logData->logId, tag, std::max(begin, result.segmentPeek.lastVersion + 1)),
+		                           persistTagMessageRefsKey(
+		                               logData->logId, tag, logData->persistentDataDurableVersion + 1)),
+		               SERVER_KNOBS->TLOG_SPILL_REFERENCE_MAX_BATCHES_PER_PEEK + 1)));
+	}
+	return result;
+}
+
 // Common logics to peek TLog and create TLogPeekReply that serves both streaming peek or normal peek request
 ACTOR template <typename PromiseType>
 Future<Void> tLogPeekMessages(PromiseType replyPromise,
@@ -2003,44 +2355,24 @@ Future<Void> tLogPeekMessages(PromiseType replyPromise,
 					messages.serializeBytes(messages2.toValue());
 				}
 			} else {
-				// FIXME: Limit to approximately DESIRED_TOTATL_BYTES somehow.
-				RangeResult kvrefs = wait(self->persistentData->readRange(
-				    KeyRangeRef(
-				        persistTagMessageRefsKey(logData->logId, reqTag, reqBegin),
-				        persistTagMessageRefsKey(logData->logId, reqTag, logData->persistentDataDurableVersion + 1)),
-				    SERVER_KNOBS->TLOG_SPILL_REFERENCE_MAX_BATCHES_PER_PEEK + 1));
+				// Compacted segments hold the oldest spilled data of the tag, references the rest
+				state SpilledIndexPeek spilledIndex = wait(readBetweenSpillCompactions<SpilledIndexPeek>(
+				    &logData->spillGeneration, [self = self, logData = logData, tag = reqTag, begin = reqBegin]() {
+					    return peekSpilledIndex(self, logData, tag, begin);
+				    }));
+				messages.serializeBytes(spilledIndex.segmentPeek.messages);
 
 				//TraceEvent("TLogPeekResults", self->dbgid).detail("ForAddress", replyPromise.getEndpoint().getPrimaryAddress()).detail("Tag1Results", s1).detail("Tag2Results", s2).detail("Tag1ResultsLim", kv1.size()).detail("Tag2ResultsLim", kv2.size()).detail("Tag1ResultsLast", kv1.size() ? kv1[0].key : "").detail("Tag2ResultsLast", kv2.size() ? kv2[0].key : "").detail("Limited", limited).detail("NextEpoch", next_pos.epoch).detail("NextSeq", next_pos.sequence).detail("NowEpoch", self->epoch()).detail("NowSeq", self->sequence.getNextSequence());
 
 				state std::vector<std::pair<IDiskQueue::location, IDiskQueue::location>> commitLocations;
-				state bool earlyEnd = false;
-				uint32_t mutationBytes = 0;
 				state uint64_t commitBytes = 0;
-				state Version firstVersion = std::numeric_limits<Version>::max();
-				for (int i = 0; i < kvrefs.size() && i < SERVER_KNOBS->TLOG_SPILL_REFERENCE_MAX_BATCHES_PER_PEEK; i++) {
-					auto& kv = kvrefs[i];
-					VectorRef<SpilledData> spilledData;
-					BinaryReader r(kv.value, AssumeVersion(logData->protocolVersion));
-					r >> spilledData;
-					for (const SpilledData& sd : spilledData) {
-						if (mutationBytes >= SERVER_KNOBS->DESIRED_TOTAL_BYTES) {
-							earlyEnd = true;
-							break;
-						}
-						if (sd.version >= reqBegin) {
-							firstVersion = std::min(firstVersion, sd.version);
-							const IDiskQueue::location end = sd.start.lo + sd.length;
-							commitLocations.emplace_back(sd.start, end);
-							// This isn't perfect, because we aren't accounting for page boundaries, but should be
-							// close enough.
-							commitBytes += sd.length;
-							mutationBytes += sd.mutationBytes;
-						}
-					}
-					if (earlyEnd)
-						break;
-				}
-				earlyEnd = earlyEnd || (kvrefs.size() >= SERVER_KNOBS->TLOG_SPILL_REFERENCE_MAX_BATCHES_PER_PEEK + 1);
+				state bool earlyEnd = selectSpilledCommits(spilledIndex.kvrefs,
+				                                           logData->protocolVersion,
+				                                           reqBegin,
+				                                           spilledIndex.segmentPeek,
+				                                           commitLocations,
+				                                           commitBytes);
+				spilledIndex.kvrefs = RangeResult();
 				wait(self->peekMemoryLimiter.take(TaskPriority::TLogSpilledPeekReply, commitBytes));
 				state FlowLock::Releaser memoryReservation(self->peekMemoryLimiter, commitBytes);
 				state std::vector<Future<Standalone<StringRef>>> messageReads;
@@ -2085,7 +2417,7 @@ Future<Void> tLogPeekMessages(PromiseType replyPromise,
 				memoryReservation.release();
 
 				if (earlyEnd) {
-					endVersion = lastRefMessageVersion + 1;
+					endVersion = std::max(lastRefMessageVersion, spilledIndex.segmentPeek.lastVersion) + 1;
 					onlySpilled = true;
 				} else {
 					messages.serializeBytes(messages2.toValue());
@@ -3245,6 +3577,8 @@ ACTOR Future<Void> restorePersistentState(TLogData* self,
 		throw worker_recovery_failed();
 	}
 
+	self->spillSegmentsFormat = fFormat.get().present() && fFormat.get().get() == persistFormatSpillSegments.value;
+
 	if (!fFormat.get().present()) {
 		RangeResult v = wait(self->persistentData->readRange(KeyRangeRef(StringRef(), "\xff"_sr), 1));
 		if (!v.size()) {
@@ -3260,7 +3594,13 @@ ACTOR Future<Void> restorePersistentState(TLogData* self,
 
 	state std::vector<Future<ErrorOr<Void>>> removed;
 
-	ASSERT(fFormat.get().get() == "FoundationDB/LogServer/3/0"_sr);
+	ASSERT(isRestorablePersistFormat(fFormat.get().get()));
+	CODE_PROBE(self->spillSegmentsFormat, "TLog restored a store in the spill segments format");
+	if (g_network->isSimulated() && !self->spillSegmentsFormat) {
+		// Segments are only written together with the format that makes earlier TLogs refuse the store
+		RangeResult segments = wait(self->persistentData->readRange(persistTagMessageSegmentsKeys, 1));
+		ASSERT(segments.empty());
+	}
 
 	ASSERT(fVers.get().size() == fRecoverCounts.get().size());
 
@@ -3941,3 +4281,162 @@ TEST_CASE("Lfdbserver/tlogserver/VersionMessagesOverheadFactor") {
 
 	return Void();
 }
+
+TEST_CASE("/fdbserver/tlogserver/SpilledSegment") {
+	BinaryWriter raw(Unversioned());
+	int versions = deterministicRandom()->randomInt(1, 100);
+	for (int i = 0; i < versions; i++) {
+		std::string messages(deterministicRandom()->randomInt(0, 1000), 'a' + i % 26);
+		raw << Version(i) << (uint32_t)messages.size();
+		raw.serializeBytes(messages);
+	}
+	for (const auto& filter : CompressionUtils::supportedFilters) {
+		Arena arena;
+		Value segment = encodeSpilledSegment(filter, raw.toValue());
+		ASSERT(decodeSpilledSegment(segment, arena) == raw.toValue());
+	}
+
+	return Void();
+}
+
+TEST_CASE("/fdbserver/tlogserver/SpilledPeekMerge") {
+	// The spilled versions of a tag, the oldest of them compacted into segments and the rest still referenced
+	const UID logId = deterministicRandom()->randomUniqueID();
+	const Tag tag(0, 1);
+	const ProtocolVersion protocolVersion = g_network->protocolVersion();
+	std::vector<Version> versions;
+	std::map<Version, std::string> versionMessages;
+	const int count = deterministicRandom()->randomInt(1, 200);
+	for (int i = 0; i < count; i++) {
+		versions.push_back((versions.empty() ? 0 : versions.back()) + deterministicRandom()->randomInt(1, 10));
+		versionMessages[versions.back()] =
+		    deterministicRandom()->randomAlphaNumeric(deterministicRandom()->randomInt(0, 3000));
+	}
+	const int compacted = deterministicRandom()->randomInt(0, count + 1);
+
+	RangeResult segments;
+	BinaryWriter raw(Unversioned());
+	for (int i = 0; i < compacted; i++) {
+		const std::string& message = versionMessages[versions[i]];
+		raw << versions[i] << (uint32_t)message.size();
+		raw.serializeBytes(message);
+		if (i == compacted - 1 || deterministicRandom()->random01() < 0.2) {
+			segments.push_back_deep(segments.arena(),
+			                        KeyValueRef(persistTagMessageSegmentsKey(logId, tag, versions[i]),
+			                                    encodeSpilledSegment(CompressionFilter::NONE, raw.toValue())));
+			raw = BinaryWriter(Unversioned());
+		}
+	}
+	// The disk queue location of each referenced commit is its version, to tell which commits a peek reads
+	RangeResult refs;
+	std::vector<SpilledData> batch;
+	for (int i = compacted; i < count; i++) {
+		batch.emplace_back(versions[i], versions[i], 1, versionMessages[versions[i]].size());
+		if (i == count - 1 || deterministicRandom()->random01() < 0.2) {
+			BinaryWriter wr(AssumeVersion(protocolVersion));
+			wr << uint32_t(batch.size());
+			for (const SpilledData& sd : batch) {
+				wr << sd;
+			}
+			refs.push_back_deep(refs.arena(),
+			                    KeyValueRef(persistTagMessageRefsKey(logId, tag, versions[i]), wr.toValue()));
+			batch.clear();
+		}
+	}
+	// What persistentData returns for a read of kvs from begin on
+	auto readRange = [](RangeResult const& kvs, KeyRef begin, int limit) {
+		RangeResult result;
+		for (const auto& kv : kvs) {
+			if (kv.key >= begin && result.size() < limit) {
+				result.push_back_deep(result.arena(), kv);
+			}
+		}
+		return result;
+	};
+
+	for (int i = 0; i < 20; i++) {
+		const Version begin = deterministicRandom()->randomInt64(0, versions.back() + 2);
+		SpilledSegmentPeek segmentPeek =
+		    decodeSpilledSegments(readRange(segments,
+		                                    persistTagMessageSegmentsKey(logId, tag, begin),
+		                                    SERVER_KNOBS->TLOG_SPILL_COMPACTION_MAX_SEGMENTS_PER_PEEK + 1),
+		                          begin);
+		RangeResult kvrefs;
+		if (!segmentPeek.limitReached) {
+			kvrefs = readRange(refs,
+			                   persistTagMessageRefsKey(logId, tag, std::max(begin, segmentPeek.lastVersion + 1)),
+			                   SERVER_KNOBS->TLOG_SPILL_REFERENCE_MAX_BATCHES_PER_PEEK + 1);
+		}
+		std::vector<std::pair<IDiskQueue::location, IDiskQueue::location>> commitLocations;
+		uint64_t commitBytes = 0;
+		const bool earlyEnd =
+		    selectSpilledCommits(kvrefs, protocolVersion, begin, segmentPeek, commitLocations, commitBytes);
+
+		std::vector<Version> peeked;
+		BinaryReader rd(segmentPeek.messages, Unversioned());
+		while (!rd.empty()) {
+			int32_t header;
+			Version version;
+			rd >> header >> version;
+			ASSERT(header == VERSION_HEADER && versionMessages.contains(version));
+			const std::string& message = versionMessages[version];
+			ASSERT(StringRef((const uint8_t*)rd.readBytes(message.size()), message.size()) == StringRef(message));
+			peeked.push_back(version);
+		}
+		ASSERT(peeked.empty() || peeked.back() == segmentPeek.lastVersion);
+		for (const auto& [start, end] : commitLocations) {
+			peeked.push_back(start.lo);
+		}
+
+		// The segments and then the references return the versions from begin on in order, without gaps or repeats,
+		// and a peek that ends early returns something and leaves the rest for the next peek
+		auto first = std::lower_bound(versions.begin(), versions.end(), begin);
+		const size_t remaining = versions.end() - first;
+		ASSERT(peeked.size() <= remaining && std::equal(peeked.begin(), peeked.end(), first));
+		if (earlyEnd) {
+			ASSERT(!peeked.empty() && peeked.size() < remaining);
+		} else {
+			ASSERT(peeked.size() == remaining);
+		}
+	}
+
+	return Void();
+}
+
+TEST_CASE("/fdbserver/tlogserver/SpilledPeekRetriesAfterCompaction") {
+	state uint64_t spillGeneration = 0;
+	state int reads = 0;
+	state Promise<int> firstRead;
+	state std::function<Future<int>()> read = [reads = &reads, firstRead = &firstRead]() {
+		return ++*reads == 1 ? firstRead->getFuture() : Future<int>(*reads);
+	};
+
+	// A compaction completes while the first read is outstanding, so its result is thrown away
+	state Future<int> result = readBetweenSpillCompactions<int>(&spillGeneration, read);
+	ASSERT(!result.isReady());
+	spillGeneration++;
+	firstRead.send(1);
+	int value = wait(result);
+	ASSERT_EQ(value, 2);
+	ASSERT_EQ(reads, 2);
+
+	// A compaction before the read started doesn't matter
+	spillGeneration++;
+	int value2 = wait(readBetweenSpillCompactions<int>(&spillGeneration, read));
+	ASSERT_EQ(value2, 3);
+	ASSERT_EQ(reads, 3);
+
+	return Void();
+}
+
+TEST_CASE("/fdbserver/tlogserver/RestorablePersistFormats") {
+	// Stores from before and after the first spill compaction are restored, stores from later TLogs are refused
+	for (const KeyValueRef& format : { persistFormat, persistFormatSpillSegments }) {
+		ASSERT(persistFormatReadableRange.contains(format.value));
+		ASSERT(isRestorablePersistFormat(format.value));
+	}
+	ASSERT(!persistFormatReadableRange.contains("FoundationDB/LogServer/5/0"_sr));
+	ASSERT(!isRestorablePersistFormat("FoundationDB/LogServer/2/0"_sr));
+
+	return Void();
+}
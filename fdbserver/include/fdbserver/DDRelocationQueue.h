@@ -54,6 +54,8 @@ public:
 	std::vector<UID> src;
 	std::vector<UID> completeSources;
 	std::vector<UID> completeDests;
+	int64_t destBytes; // bytes charged to each of completeDests' DestBandwidth
+	double destLaunchTime;
 	bool wantsNewServers;
 	bool cancellable;
 	TraceInterval interval;
@@ -104,6 +106,18 @@ struct Busyness {
 	std::string toString();
 };
 
+// DDQueue uses DestBandwidth to bound the bytes being fetched by a destination server at once. The budget follows
+// the fetch throughput the server has achieved recently, so fast servers take more concurrent moves than slow ones.
+struct DestBandwidth {
+	int64_t bytesInFlight;
+	double bytesPerSecond; // smoothed throughput of the moves this server completed
+
+	DestBandwidth();
+	int64_t budget(int prio) const;
+	bool canLaunch(int prio, int64_t bytes) const;
+	void recordTransfer(int64_t bytes, double seconds);
+};
+
 struct DDQueueInitParams {
 	UID const& id;
 	MoveKeysLock const& lock;
@@ -261,6 +275,11 @@ public:
 
 	std::map<UID, Busyness> busymap; // UID is serverID
 	std::map<UID, Busyness> destBusymap; // UID is serverID
+	std::map<UID, DestBandwidth> destBandwidth; // UID is serverID
+	// In-flight rebalance relocations that are still choosing a destination and may be preempted by higher priority
+	// work on the same source servers; Key: begin of the relocation's range
+	std::map<Key, RelocateData> preemptibleRelocations;
+	int64_t preemptedRelocations = 0;
 
 	KeyRangeMap<RelocateData> queueMap;
 	std::set<RelocateData, std::greater<RelocateData>> fetchingSourcesQueue;
@@ -348,6 +367,12 @@ public:
 	void launchQueuedWork(std::set<RelocateData, std::greater<RelocateData>> combined,
 	                      const DDEnabledState* ddEnabledState);
 
+	// Cancels preemptible rebalance relocations reading from rd's source servers so that rd can launch once their
+	// work is released. Returns the number of relocations cancelled. The cancelled rebalances are dropped rather than
+	// requeued: a rebalance is only a suggestion made from the load at the time, and the rebalancers pick a new one
+	// from the current load once the unhealthy relocation has moved its data.
+	int preemptRebalances(RelocateData const& rd, const DDEnabledState* ddEnabledState);
+
 	int getHighestPriorityRelocation() const;
 
 	// return true if the servers are throttled as source for read rebalance
@@ -20,8 +20,10 @@
 
 #pragma once
 
+#include <map>
 #include <set>
 #include <sstream>
+#include <unordered_map>
 #include "fdbclient/FDBOptions.g.h"
 #include "fdbclient/FDBTypes.h"
 #include "fdbclient/KeyBackedTypes.actor.h"
@@ -202,6 +204,58 @@ struct DDTeamCollectionInitParams {
 	PromiseStream<RebalanceStorageQueueRequest> triggerStorageQueueRebalance;
 };
 
+// Indexes the servers or machines that team building may choose by the number of teams each one is on.
+// addTeamsBestOf() and addBestMachineTeams() add many teams in a row, and for each one need the least used candidates
+// and whether any candidate is still below its target number of teams. Updating the index as teams are added answers
+// both without rescanning every server or machine for every team.
+template <class T>
+class TeamCountIndex {
+public:
+	void add(Reference<T> const& candidate, int teamCount) {
+		auto& bucket = buckets[teamCount];
+		positions[candidate.getPtr()] = { teamCount, (int)bucket.size() };
+		bucket.push_back(candidate);
+	}
+
+	// Moves candidate to the bucket for teamCount. Candidates that were never added are ignored.
+	void update(Reference<T> const& candidate, int teamCount) {
+		auto it = positions.find(candidate.getPtr());
+		if (it == positions.end() || it->second.first == teamCount) {
+			return;
+		}
+		Reference<T> moved = candidate;
+		auto bucket = buckets.find(it->second.first);
+		int index = it->second.second;
+		if (index != (int)bucket->second.size() - 1) {
+			bucket->second[index] = bucket->second.back();
+			positions[bucket->second[index].getPtr()].second = index;
+		}
+		bucket->second.pop_back();
+		if (bucket->second.empty()) {
+			buckets.erase(bucket);
+		}
+		positions.erase(it);
+		add(moved, teamCount);
+	}
+
+	bool empty() const { return buckets.empty(); }
+
+	int minTeamCount() const {
+		ASSERT(!empty());
+		return buckets.begin()->first;
+	}
+
+	// The candidates on minTeamCount() teams
+	std::vector<Reference<T>> const& leastUsed() const {
+		ASSERT(!empty());
+		return buckets.begin()->second;
+	}
+
+private:
+	std::map<int, std::vector<Reference<T>>> buckets;
+	std::unordered_map<T*, std::pair<int, int>> positions; // team count and index within its bucket
+};
+
 class DDTeamCollection : public ReferenceCounted<DDTeamCollection> {
 	friend class DDTeamCollectionImpl;
 	friend class DDTeamCollectionUnitTest;
@@ -386,8 +440,8 @@ protected:
 
 	bool isMachineHealthy(Reference<TCMachineInfo> const& machine) const;
 
-	// Return the healthy server with the least number of correct-size server teams
-	Reference<TCServerInfo> findOneLeastUsedServer() const;
+	// Return one of the least used servers in candidates, which holds the healthy servers with valid locality
+	Reference<TCServerInfo> findOneLeastUsedServer(TeamCountIndex<TCServerInfo> const& candidates) const;
 
 	// A server team should always come from servers on a machine team
 	// Check if it is true
@@ -415,6 +469,12 @@ protected:
 
 	int getHealthyMachineTeamCount() const;
 
+	// The number of machine teams each healthy machine is expected to be on
+	int getTargetMachineTeamNumPerMachine() const;
+
+	// The number of server teams each healthy server is expected to be on
+	int getTargetTeamNumPerServer() const;
+
 	// Each machine is expected to have targetMachineTeamNumPerMachine
 	// Return true if there exists a machine that does not have enough teams.
 	bool notEnoughMachineTeamsForAMachine() const;
@@ -136,6 +136,9 @@ public:
 
 	virtual Future<Standalone<VectorRef<ReadHotRangeWithMetrics>>> getReadHotRanges(KeyRange const& keys) const = 0;
 
+	// Returns the most read key ranges inside keys as tracked by the storage servers' read hot key sketches
+	virtual Future<Standalone<VectorRef<ReadHotRangeWithMetrics>>> getReadHotKeyRanges(KeyRange const& keys) const = 0;
+
 	virtual Future<HealthMetrics> getHealthMetrics(bool detailed = false) const = 0;
 
 	virtual Future<Optional<Value>> readRebalanceDDIgnoreKey() const = 0;
@@ -221,6 +224,8 @@ public:
 
 	Future<Standalone<VectorRef<ReadHotRangeWithMetrics>>> getReadHotRanges(KeyRange const& keys) const override;
 
+	Future<Standalone<VectorRef<ReadHotRangeWithMetrics>>> getReadHotKeyRanges(KeyRange const& keys) const override;
+
 	Future<HealthMetrics> getHealthMetrics(bool detailed) const override;
 
 	Future<Optional<Value>> readRebalanceDDIgnoreKey() const override;
@@ -301,6 +306,10 @@ public:
 		UNREACHABLE();
 	}
 
+	Future<Standalone<VectorRef<ReadHotRangeWithMetrics>>> getReadHotKeyRanges(KeyRange const& keys) const override {
+		UNREACHABLE();
+	}
+
 	Future<HealthMetrics> getHealthMetrics(bool detailed = false) const override;
 
 	Future<std::vector<ProcessData>> getWorkers() const override;
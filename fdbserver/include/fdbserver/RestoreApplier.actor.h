@@ -93,7 +93,13 @@ struct StagingKey {
 				val = m.param2;
 				type = (MutationRef::Type)m.type;
 				version = newVersion;
+				// Atomic ops below a set or clear are overwritten by it, so drop them now instead of holding them
+				// until precomputeResult() skips them.
+				pendingMutations.erase(pendingMutations.begin(), pendingMutations.lower_bound(newVersion));
 			}
+		} else if (hasBaseValue() && newVersion < version) {
+			// Already overwritten by the buffered set or clear
+			return;
 		} else {
 			auto it = pendingMutations.find(newVersion);
 			if (it == pendingMutations.end()) {
@@ -265,6 +271,7 @@ struct ApplierBatchData : public ReferenceCounted<ApplierBatchData> {
 		Counter appliedTxns, appliedTxnRetries;
 		Counter fetchKeys, fetchTxns, fetchTxnRetries; // number of keys to fetch from dest. FDB cluster.
 		Counter clearOps, clearTxns;
+		Counter bulkLoadTasks, bulkLoadedKeys, bulkLoadedBytes;
 
 		Counters(ApplierBatchData* self, UID applierInterfID, int batchIndex)
 		  : cc("ApplierBatch", applierInterfID.toString() + ":" + std::to_string(batchIndex)),
@@ -274,7 +281,8 @@ struct ApplierBatchData : public ReferenceCounted<ApplierBatchData> {
 		    appliedMutations("AppliedMutations", cc), appliedAtomicOps("AppliedAtomicOps", cc),
 		    appliedTxns("AppliedTxns", cc), appliedTxnRetries("AppliedTxnRetries", cc), fetchKeys("FetchKeys", cc),
 		    fetchTxns("FetchTxns", cc), fetchTxnRetries("FetchTxnRetries", cc), clearOps("ClearOps", cc),
-		    clearTxns("ClearTxns", cc) {}
+		    clearTxns("ClearTxns", cc), bulkLoadTasks("BulkLoadTasks", cc), bulkLoadedKeys("BulkLoadedKeys", cc),
+		    bulkLoadedBytes("BulkLoadedBytes", cc) {}
 	} counters;
 
 	void addref() { return ReferenceCounted<ApplierBatchData>::addref(); }
@@ -43,6 +43,19 @@ struct ProcessIssues {
 	ProcessIssues(NetworkAddress address, Standalone<VectorRef<StringRef>> issues) : address(address), issues(issues) {}
 };
 
+// Latest events fetched from workers by earlier status requests, by worker interface and event name. Events which
+// workers only log periodically, or once per process, are reused rather than fetched from every worker each time.
+struct WorkerEventCache {
+	struct Entry {
+		double fetched;
+		TraceEventFields fields;
+	};
+	std::map<std::pair<UID, std::string>, Entry> events;
+
+	// Drops the events of workers which are not in workers anymore
+	void removeMissing(std::vector<WorkerDetails> const& workers);
+};
+
 Future<StatusReply> clusterGetStatus(
     Reference<AsyncVar<struct ServerDBInfo>> const& db,
     Database const& cx,
@@ -59,7 +72,8 @@ Future<StatusReply> clusterGetStatus(
     Optional<UnversionedMetaclusterRegistrationEntry> const& metaclusterRegistration,
     metacluster::MetaclusterMetrics const& metaclusterMetrics,
     std::unordered_map<NetworkAddress, double /* latest time at which address was excluded */> const&
-        excludedDegradedServers);
+        excludedDegradedServers,
+    WorkerEventCache* const& workerEventCache);
 
 StatusReply clusterGetFaultToleranceStatus(const std::string& statusString);
 
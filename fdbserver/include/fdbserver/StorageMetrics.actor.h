@@ -80,6 +80,40 @@ private:
 	int64_t add(const Key& key, int64_t metric);
 };
 
+// Finds the most read keys of a storage server in bounded memory. Read bytes are counted in a count-min sketch whose
+// counters cover the last one to two STORAGE_METRICS_AVERAGE_INTERVALs, and the keys with the largest estimates are
+// kept as heavy hitters. bytesReadSample only remembers a random sample of reads, so it can tell that a shard is read
+// hot but not which keys inside it are.
+struct ReadHotKeySketch {
+	ReadHotKeySketch(int width, int depth, int maxKeys);
+
+	void add(KeyRef key, int64_t bytes, double t = now());
+
+	// Upper bound of the bytes read from key in the current window
+	int64_t estimate(KeyRef key) const;
+
+	// The heavy hitters in keys, sorted by key, with their estimated read bandwidth in bytes per second
+	std::vector<std::pair<KeyRef, double>> hotKeys(KeyRangeRef keys, double t = now()) const;
+
+	size_t trackedKeys() const { return heavyHitters.size(); }
+
+private:
+	int width;
+	int depth;
+	int maxKeys;
+	// depth rows of width counters, for the current and the previous interval
+	std::vector<int64_t> current;
+	std::vector<int64_t> previous;
+	double intervalStart;
+	bool hasPrevious;
+	std::map<Key, int64_t, std::less<>> heavyHitters;
+	int64_t minHeavyHitter; // lower bound of the smallest estimate in heavyHitters
+
+	void rotate(double t);
+	void evictMinHeavyHitter();
+	int counterIndex(uint32_t h1, uint32_t h2, int row) const;
+};
+
 struct StorageServerMetrics {
 	KeyRangeMap<std::vector<PromiseStream<StorageMetrics>>> waitMetricsMap;
 	StorageMetricSample byteSample;
@@ -88,12 +122,16 @@ struct StorageServerMetrics {
 	TransientStorageMetricSample iopsSample, bytesWriteSample;
 	TransientStorageMetricSample bytesReadSample;
 	TransientStorageMetricSample opsReadSample;
+	ReadHotKeySketch readHotKeys;
 
 	StorageServerMetrics()
 	  : byteSample(0), iopsSample(SERVER_KNOBS->IOPS_UNITS_PER_SAMPLE),
 	    bytesWriteSample(SERVER_KNOBS->BYTES_WRITTEN_UNITS_PER_SAMPLE),
 	    bytesReadSample(SERVER_KNOBS->BYTES_READ_UNITS_PER_SAMPLE),
-	    opsReadSample(SERVER_KNOBS->OPS_READ_UNITS_PER_SAMPLE) {}
+	    opsReadSample(SERVER_KNOBS->OPS_READ_UNITS_PER_SAMPLE),
+	    readHotKeys(SERVER_KNOBS->READ_HOT_SKETCH_WIDTH,
+	                SERVER_KNOBS->READ_HOT_SKETCH_DEPTH,
+	                SERVER_KNOBS->READ_HOT_SKETCH_KEYS) {}
 
 	StorageMetrics getMetrics(KeyRangeRef const& keys) const;
 
@@ -140,6 +178,9 @@ struct StorageServerMetrics {
 
 	void getReadHotRanges(ReadHotSubRangeRequest req) const;
 
+	// Returns up to limit of the most read key ranges in range, merging hot keys that have little data between them
+	Standalone<VectorRef<ReadHotRangeWithMetrics>> getReadHotKeyRanges(KeyRangeRef range, int limit) const;
+
 	int64_t getHotShards(const KeyRange& range) const;
 
 	std::vector<KeyRef> getSplitPoints(KeyRangeRef range, int64_t chunkSize, Optional<KeyRef> prefixToRemove) const;
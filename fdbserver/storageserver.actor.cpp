@@ -881,6 +881,70 @@ public:
 	  : key(key), value(value), version(version), tags(tags), debugID(debugID), tenantId(tenantId) {}
 };
 
+// The keys watched on a storage server. Every applied set mutation triggers its key, and almost none of them are
+// watched, so a hashed bit filter sits in front of the ordered map: an unwatched key is usually rejected with one bit
+// test instead of a search of the map (and a copy of the key to search with). The filter has no false negatives. Bits
+// are set by onChange() and only cleared by rebuilding the filter from the map, which happens once enough keys have
+// been added since the last rebuild that stale bits would make false positives common.
+class StorageWatchMap : public AsyncMap<Key, bool> {
+public:
+	StorageWatchMap() : filter(minFilterBits), filterInserts(0) {}
+
+	Future<Void> onChange(Key const& key) override {
+		if (++filterInserts > filter.size() / 8) {
+			rebuildFilter();
+		}
+		filter[filterIndex(key)] = true;
+		return AsyncMap<Key, bool>::onChange(key);
+	}
+
+	void trigger(KeyRef key) {
+		if (filter[filterIndex(key)]) {
+			AsyncMap<Key, bool>::trigger(Key(key));
+		}
+	}
+
+private:
+	static constexpr size_t minFilterBits = 1 << 16;
+
+	std::vector<bool> filter; // size is a power of two
+	size_t filterInserts; // keys added to the filter since it was last rebuilt
+
+	size_t filterIndex(KeyRef key) const { return std::hash<StringRef>()(key) & (filter.size() - 1); }
+
+	void rebuildFilter() {
+		size_t bits = minFilterBits;
+		while (bits < items.size() * 16) {
+			bits *= 2;
+		}
+		filter.assign(bits, false);
+		for (const auto& item : items) {
+			filter[filterIndex(item.first)] = true;
+		}
+		filterInserts = items.size() + 1;
+	}
+};
+
+TEST_CASE("/fdbserver/storageserver/watchMapFilter") {
+	StorageWatchMap watches;
+	std::vector<Future<Void>> watched;
+	for (int i = 0; i < 100000; i++) {
+		// Enough keys to rebuild the filter several times, while earlier watches stay registered
+		watched.push_back(watches.onChange(Key(format("watched%d", i))));
+	}
+	for (int i = 0; i < 100000; i++) {
+		watches.trigger(Key(format("unwatched%d", i)));
+	}
+	for (const auto& f : watched) {
+		ASSERT(!f.isReady());
+	}
+	for (int i = 0; i < 100000; i++) {
+		watches.trigger(Key(format("watched%d", i)));
+		ASSERT(watched[i].isReady());
+	}
+	return Void();
+}
+
 struct BusiestWriteTagContext {
 	const std::string busiestWriteTagTrackingKey;
 	UID ratekeeperID;
@@ -1363,7 +1427,7 @@ public:
 	Future<Void> byteSampleRecovery;
 	Future<Void> durableInProgress;
 
-	AsyncMap<Key, bool> watches;
+	StorageWatchMap watches;
 	AsyncMap<int64_t, bool> tenantWatches;
 	int64_t watchBytes;
 	int64_t numWatches;
@@ -1657,6 +1721,10 @@ public:
 
 	// Bytes read from storage engine when a storage server starts.
 	int64_t bytesRestored = 0;
+	// Byte sample keys restored from the storage engine, not counting the sample of the sample, and how long the
+	// whole restore took
+	int64_t byteSampleKeysRestored = 0;
+	double byteSampleRecoveryDuration = 0;
 
 	Reference<EventCacheHolder> storageServerSourceTLogIDEventHolder;
 
@@ -4843,6 +4911,14 @@ ACTOR Future<Void> getKeyValuesQ(StorageServer* data, GetKeyValuesRequest req)
 			if (g_network->isSimulated()) {
 				maybeInjectConsistencyScanCorruption(data->thisServerID, req, r);
 			}
+			if (req.acceptPrefixCompressed && r.data.size() > 1) {
+				// r.data stays populated for replies delivered within this process, which are not serialized
+				StringRef compressed = encodePrefixCompressed(r.data, r.arena);
+				if (compressed.size() < uncompressedEncodedSize(r.data)) {
+					CODE_PROBE(true, "Storage server sends prefix compressed range reply");
+					r.prefixCompressedData = compressed;
+				}
+			}
 			req.reply.send(r);
 
 			resultSize = req.limitBytes - remainingLimitBytes;
@@ -13144,11 +13220,29 @@ ACTOR Future<Void> applyByteSampleResult(StorageServer* data,
 		totalFetches++;
 		totalKeys += bs.size();
 		totalBytes += rangeSize;
+		// Copying each key into its own arena costs an allocation and an arena header per sampled key, which adds up
+		// to a large part of both the restore time and the memory of the sample. Pack runs of consecutive keys into
+		// shared arenas instead; a block is freed once all of its keys have been erased from the sample.
+		const int blockSize = SERVER_KNOBS->BYTE_SAMPLE_RESTORE_BLOCK_BYTES;
+		Arena block = blockSize > 0 ? Arena(blockSize) : Arena();
+		int blockBytes = 0;
 		for (int j = 0; j < bs.size(); j++) {
 			KeyRef key = bs[j].key.removePrefix(persistByteSampleKeys.begin);
 			if (!data->byteSampleClears.rangeContaining(key).value()) {
-				data->metrics.byteSample.sample.insert(
-				    key, BinaryReader::fromStringRef<int32_t>(bs[j].value, Unversioned()), false);
+				int64_t sampledSize = BinaryReader::fromStringRef<int32_t>(bs[j].value, Unversioned());
+				if (!results) {
+					data->byteSampleKeysRestored++;
+				}
+				if (blockSize <= 0) {
+					data->metrics.byteSample.sample.insert(key, sampledSize, false);
+					continue;
+				}
+				if (blockBytes + key.size() > blockSize) {
+					block = Arena(std::max(blockSize, key.size()));
+					blockBytes = 0;
+				}
+				blockBytes += key.size();
+				data->metrics.byteSample.sample.insert(Key(KeyRef(block, key), block), sampledSize, false);
 			}
 		}
 		if (rangeSize >= SERVER_KNOBS->STORAGE_LIMIT_BYTES) {
@@ -13190,11 +13284,14 @@ ACTOR Future<Void> restoreByteSample(StorageServer* data,
                                      Promise<Void> byteSampleSampleRecovered,
                                      Future<Void> startRestore) {
 	state std::vector<Standalone<VectorRef<KeyValueRef>>> byteSampleSample;
+	state double startTime = now();
 	wait(applyByteSampleResult(
 	    data, storage, persistByteSampleSampleKeys.begin, persistByteSampleSampleKeys.end, &byteSampleSample));
 	byteSampleSampleRecovered.send(Void());
+	state double sampleSampleDuration = now() - startTime;
 	wait(startRestore);
 	wait(delay(SERVER_KNOBS->BYTE_SAMPLE_START_DELAY));
+	state double loadStartTime = now();
 
 	size_t bytes_per_fetch = 0;
 	// Since the expected size also includes (as of now) the space overhead of the container, we calculate our own
@@ -13225,7 +13322,14 @@ ACTOR Future<Void> restoreByteSample(StorageServer* data,
 	sampleRanges.push_back(applyByteSampleResult(data, storage, lastStart, persistByteSampleKeys.end));
 
 	wait(waitForAll(sampleRanges));
-	TraceEvent("RecoveredByteSampleChunkedRead", data->thisServerID).detail("Ranges", sampleRanges.size());
+	data->byteSampleRecoveryDuration = now() - startTime;
+	TraceEvent("RecoveredByteSampleChunkedRead", data->thisServerID)
+	    .detail("Ranges", sampleRanges.size())
+	    .detail("SampleSampleDuration", sampleSampleDuration)
+	    .detail("LoadDuration", now() - loadStartTime)
+	    .detail("TotalDuration", data->byteSampleRecoveryDuration)
+	    .detail("KeysRead", data->byteSampleKeysRestored)
+	    .detail("SampledBytes", data->metrics.byteSample.getEstimate(allKeys));
 
 	if (BUGGIFY)
 		wait(delay(deterministicRandom()->random01() * 10.0));
@@ -13780,7 +13884,10 @@ Future<Void> StorageServer::waitMetricsTenantAware(const WaitMetricsRequest& req
 ACTOR Future<Void> metricsCore(StorageServer* self, StorageServerInterface ssi) {
 
 	wait(self->byteSampleRecovery);
-	TraceEvent("StorageServerRestoreDurableState", self->thisServerID).detail("RestoredBytes", self->bytesRestored);
+	TraceEvent("StorageServerRestoreDurableState", self->thisServerID)
+	    .detail("RestoredBytes", self->bytesRestored)
+	    .detail("ByteSampleKeysRestored", self->byteSampleKeysRestored)
+	    .detail("ByteSampleRecoveryDuration", self->byteSampleRecoveryDuration);
 
 	// Logs all counters in `counters.cc` and reset the interval.
 	self->actors.add(self->counters.cc.traceCounters(
@@ -42,6 +42,7 @@ struct MutationLogReaderCorrectnessWorkload : TestWorkload {
 	Version endVersion;
 	Key uid;
 	Key baLogRangePrefix;
+	int64_t batchBytes; // 0 reads with getNext()
 	bool debug = false;
 
 	Version recordVersion(int index) { return beginVersion + versionIncrement * index; }
@@ -63,6 +64,7 @@ struct MutationLogReaderCorrectnessWorkload : TestWorkload {
 		records = deterministicRandom()->randomInt(0, 500e3);
 		versionRange = deterministicRandom()->randomInt64(records, std::numeric_limits<Version>::max());
 		versionIncrement = versionRange / (records + 1);
+		batchBytes = deterministicRandom()->coinflip() ? 0 : deterministicRandom()->randomInt64(1, 10e6);
 
 		// The version immediately after the last actual record version
 		endVersion = recordVersion(records - 1) + 1;
@@ -82,6 +84,7 @@ struct MutationLogReaderCorrectnessWorkload : TestWorkload {
 		fmt::print("Records: {}\n", self->records);
 		fmt::print("BeginVersion: {}\n", self->beginVersion);
 		fmt::print("EndVersion: {}\n", self->endVersion);
+		fmt::print("BatchBytes: {}\n", self->batchBytes);
 
 		while (iStart < self->records) {
 			loop {
@@ -114,7 +117,8 @@ struct MutationLogReaderCorrectnessWorkload : TestWorkload {
 
 		try {
 			loop {
-				state Standalone<RangeResultRef> results = wait(reader->getNext());
+				state Standalone<RangeResultRef> results =
+				    wait(self->batchBytes > 0 ? reader->getNextBatch(self->batchBytes) : reader->getNext());
 
 				for (const auto& rec : results) {
 					Key expectedKey = self->recordKey(nextExpectedRecord);
@@ -103,6 +103,37 @@ StringRef CompressionUtils::decompress(const CompressionFilter filter, const Str
 	throw internal_error(); // We should never get here
 }
 
+StringRef CompressionUtils::decompress(const CompressionFilter filter,
+                                      const StringRef& data,
+                                      size_t maxDecompressedSize,
+                                      Arena& arena) {
+	checkFilterSupported(filter);
+
+	if (filter == CompressionFilter::NONE) {
+		if (data.size() > maxDecompressedSize) {
+			throw serialization_failed();
+		}
+		return StringRef(arena, data);
+	}
+#ifdef ZSTD_LIB_SUPPORTED
+	if (filter == CompressionFilter::ZSTD) {
+		const char* src = reinterpret_cast<const char*>(data.begin());
+		// ZSTD_decompressBound() returns ZSTD_CONTENTSIZE_ERROR for malformed input, which is also rejected here
+		unsigned long long destSize = ZSTD_decompressBound(src, data.size());
+		if (destSize > maxDecompressedSize) {
+			throw serialization_failed();
+		}
+		uint8_t* dest = new (arena) uint8_t[destSize];
+		size_t bytes = ZSTD_decompress(dest, destSize, src, data.size());
+		if (ZSTD_isError(bytes)) {
+			throw serialization_failed();
+		}
+		return StringRef(dest, bytes);
+	}
+#endif
+	throw internal_error(); // We should never get here
+}
+
 int CompressionUtils::getDefaultCompressionLevel(CompressionFilter filter) {
 	checkFilterSupported(filter);
 
@@ -174,6 +205,24 @@ void testCompression2(CompressionFilter filter) {
 	ASSERT_EQ(verify.compare(uncompressed), 0);
 }
 
+void testBoundedDecompression(CompressionFilter filter) {
+	Arena arena;
+	const int size = deterministicRandom()->randomInt(512, 1024);
+	std::string s(size, 'x');
+	Standalone<StringRef> uncompressed = Standalone<StringRef>(StringRef(s));
+
+	Standalone<StringRef> compressed = CompressionUtils::compress(filter, uncompressed, arena);
+	StringRef verify = CompressionUtils::decompress(filter, compressed, uncompressed.size(), arena);
+	ASSERT_EQ(verify.compare(uncompressed), 0);
+
+	try {
+		CompressionUtils::decompress(filter, compressed, uncompressed.size() - 1, arena);
+		ASSERT(false);
+	} catch (Error& e) {
+		ASSERT_EQ(e.code(), error_code_serialization_failed);
+	}
+}
+
 } // namespace
 
 TEST_CASE("/CompressionUtils/noCompression") {
@@ -206,4 +255,11 @@ TEST_CASE("/CompressionUtils/zstdCompression2") {
 
 	return Void();
 }
+
+TEST_CASE("/CompressionUtils/zstdBoundedDecompression") {
+	testBoundedDecompression(CompressionFilter::ZSTD);
+	TraceEvent("ZstdBoundedDecompressionDone");
+
+	return Void();
+}
 #endif
@@ -18,6 +18,7 @@
  * limitations under the License.
  */
 
+#include "flow/CompressionUtils.h"
 #include "flow/EncryptUtils.h"
 #include "flow/Error.h"
 #include "flow/flow.h"
@@ -231,6 +232,9 @@ void FlowKnobs::initialize(Randomize randomize, IsSimulated isSimulated) {
 	init( FLOW_TCP_NODELAY,                                      1 );
 	init( FLOW_TCP_QUICKACK,                                     0 );
 	init( RESOLVE_PREFER_IPV4_ADDR,                          false );  // Default to prefer IPv6 addresses. Set to true to prefer IPv4 addresses.
+	init( NETWORK_COMPRESSION_FILTER,                       "NONE" ); if( randomize && BUGGIFY ) NETWORK_COMPRESSION_FILTER = CompressionUtils::toString(CompressionUtils::getRandomFilter());
+	init( NETWORK_COMPRESSION_MIN_BYTES,                 16 * 1024 ); if( randomize && BUGGIFY ) NETWORK_COMPRESSION_MIN_BYTES = deterministicRandom()->randomInt(64, 4096);
+	init( NETWORK_COMPRESSION_LEVEL,                             1 );
 
 	//Sim2
 	init( MIN_OPEN_TIME,                                    0.0002 );
@@ -260,7 +260,7 @@ public:
 
 	NetworkMetrics::PriorityStats* lastPriorityStats;
 
-	struct PromiseTask final : public FastAllocated<PromiseTask> {
+	struct PromiseTask final : public TaskQueueNode, public FastAllocated<PromiseTask> {
 		Promise<Void> promise;
 		swift::Job* _Nullable swiftJob = nullptr;
 		PromiseTask() {}
@@ -2177,6 +2177,41 @@ TEST_CASE("flow/Net2/ThreadSafeQueue/Interface") {
 	return Void();
 }
 
+// A helper struct used by the IntrusiveThreadSafeQueue tests.
+struct IntrusiveQueueTestElement : ThreadSafeQueueNode {
+	int value;
+	explicit IntrusiveQueueTestElement(int value) : value(value) {}
+};
+
+TEST_CASE("flow/Net2/IntrusiveThreadSafeQueue/Interface") {
+	IntrusiveQueueTestElement elements[] = { IntrusiveQueueTestElement(1),
+		                                     IntrusiveQueueTestElement(2),
+		                                     IntrusiveQueueTestElement(3),
+		                                     IntrusiveQueueTestElement(4) };
+	IntrusiveThreadSafeQueue<IntrusiveQueueTestElement> tq;
+	ASSERT(tq.pop() == nullptr);
+	ASSERT(tq.canSleep());
+
+	ASSERT(tq.push(&elements[0]) == true);
+	ASSERT(!tq.canSleep());
+	ASSERT(tq.push(&elements[1]) == false);
+	ASSERT(tq.pop()->value == 1);
+	ASSERT(tq.push(&elements[2]) == false);
+
+	std::vector<int> drained;
+	ASSERT_EQ(tq.drain([&drained](IntrusiveQueueTestElement* e) { drained.push_back(e->value); }), 2);
+	ASSERT(drained == std::vector<int>({ 2, 3 }));
+
+	// Elements can be pushed again once they have been popped
+	ASSERT(tq.push(&elements[0]) == false);
+	ASSERT(tq.push(&elements[3]) == false);
+	ASSERT(tq.pop()->value == 1);
+	ASSERT(tq.pop()->value == 4);
+	ASSERT(tq.pop() == nullptr);
+	ASSERT(tq.canSleep());
+	return Void();
+}
+
 // A helper struct used by queueing tests which use multiple threads.
 struct QueueTestThreadState {
 	QueueTestThreadState(int threadId, int toProduce) : threadId(threadId), toProduce(toProduce) {}
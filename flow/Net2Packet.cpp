@@ -19,6 +19,7 @@
  */
 
 #include "flow/Net2Packet.h"
+#include "flow/Knobs.h"
 
 void PacketWriter::init(PacketBuffer* buf, ReliablePacket* reliable) {
 	this->buffer = buf;
@@ -213,6 +214,41 @@ PacketBuffer* ReliablePacketList::compact(PacketBuffer* into, PacketBuffer* end)
 	return into;
 }
 
+void ReliablePacketList::rewrite(const std::function<Optional<Standalone<StringRef>>(StringRef)>& rewrite) {
+	for (ReliablePacket* r = reliable.next; r != &reliable; r = r->next) {
+		std::string bytes;
+		for (ReliablePacket* c = r; c; c = c->cont) {
+			bytes.append((const char*)c->buffer->data() + c->begin, c->end - c->begin);
+		}
+		Optional<Standalone<StringRef>> replacement = rewrite(StringRef(bytes));
+		if (FLOW_KNOBS->WIPE_SENSITIVE_DATA_FROM_PACKET_BUFFER) {
+			::memset(bytes.data(), 0, bytes.size());
+		}
+		if (!replacement.present()) {
+			continue;
+		}
+
+		for (ReliablePacket* c = r->cont; c;) {
+			ReliablePacket* n = c->cont;
+			c->buffer->delref();
+			delete c;
+			c = n;
+		}
+		r->buffer->delref();
+
+		const int size = replacement.get().size();
+		r->buffer = PacketBuffer::create(size);
+		replacement.get().copyTo(r->buffer->data());
+		if (FLOW_KNOBS->WIPE_SENSITIVE_DATA_FROM_PACKET_BUFFER) {
+			r->buffer->markForWipe(r->buffer->data(), size);
+		}
+		r->buffer->bytes_written = size;
+		r->begin = 0;
+		r->end = size;
+		r->cont = nullptr;
+	}
+}
+
 void ReliablePacketList::discardAll() {
 	while (reliable.next != &reliable)
 		reliable.next->remove();
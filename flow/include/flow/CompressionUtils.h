@@ -36,6 +36,12 @@ struct CompressionUtils {
 	static StringRef compress(const CompressionFilter filter, const StringRef& data, Arena& arena);
 	static StringRef compress(const CompressionFilter filter, const StringRef& data, int level, Arena& arena);
 	static StringRef decompress(const CompressionFilter filter, const StringRef& data, Arena& arena);
+	// Same as above, but throws serialization_failed() without allocating if the decompressed size could exceed
+	// maxDecompressedSize. Use this for data received from other processes.
+	static StringRef decompress(const CompressionFilter filter,
+	                            const StringRef& data,
+	                            size_t maxDecompressedSize,
+	                            Arena& arena);
 
 	static int getDefaultCompressionLevel(CompressionFilter filter);
 	static CompressionFilter getRandomFilter();
@@ -297,6 +297,9 @@ public:
 	int FLOW_TCP_NODELAY;
 	int FLOW_TCP_QUICKACK;
 	bool RESOLVE_PREFER_IPV4_ADDR;
+	std::string NETWORK_COMPRESSION_FILTER; // Compression used for packets sent to peers which can decompress it
+	int NETWORK_COMPRESSION_MIN_BYTES; // Packets smaller than this are never compressed
+	int NETWORK_COMPRESSION_LEVEL;
 
 	// Sim2
 	// FIMXE: more parameters could be factored out
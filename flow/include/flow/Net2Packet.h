@@ -103,6 +103,10 @@ public:
 	// into the given chain of packet buffers, and return the tail of that chain
 	PacketBuffer* compact(PacketBuffer* into, PacketBuffer* stopAt);
 
+	// Replaces the bytes of each reliable packet for which rewrite returns a new encoding of it. The ReliablePacket
+	// handed out for the packet stays valid.
+	void rewrite(const std::function<Optional<Standalone<StringRef>>(StringRef)>& rewrite);
+
 	void discardAll(); // just for testing
 private:
 	ReliablePacket reliable; // Head/tail of a circularly linked list of reliable packets to be resent after a close
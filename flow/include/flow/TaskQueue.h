@@ -23,15 +23,23 @@
 #pragma once
 
 #include <queue>
+#include <type_traits>
 #include <vector>
 #include "flow/TDMetric.actor.h"
 #include "flow/network.h"
 #include "flow/ThreadSafeQueue.h"
 
+// Base of the task type of a TaskQueue. It lets tasks added from other threads be queued without allocating.
+struct TaskQueueNode : ThreadSafeQueueNode {
+	TaskPriority threadReadyTaskID = TaskPriority::Zero; // Only used while the task is in the thread ready queue
+};
+
 template <typename Task>
 // A queue of ordered tasks, both ready to execute, and delayed for later execution.
 // All functions must be called on the main thread, except for addReadyThreadSafe() which can be called from any thread.
 class TaskQueue {
+	static_assert(std::is_base_of_v<TaskQueueNode, Task>, "Task must derive from TaskQueueNode");
+
 public:
 	TaskQueue() : tasksIssued(0), ready(FLOW_KNOBS->READY_QUEUE_RESERVED_SIZE) {}
 
@@ -48,7 +56,8 @@ public:
 			processThreadReady();
 			addReady(taskID, t);
 		} else {
-			if (threadReady.push(std::make_pair(taskID, t)))
+			t->threadReadyTaskID = taskID;
+			if (threadReady.push(t))
 				return true;
 		}
 		return false;
@@ -86,15 +95,7 @@ public:
 
 	// Moves all tasks scheduled from a different thread to the ready queue.
 	void processThreadReady() {
-		[[maybe_unused]] int numReady = 0;
-		while (true) {
-			Optional<std::pair<TaskPriority, Task*>> t = threadReady.pop();
-			if (!t.present())
-				break;
-			ASSERT(t.get().second != nullptr);
-			addReady(t.get().first, t.get().second);
-			++numReady;
-		}
+		[[maybe_unused]] int numReady = threadReady.drain([this](Task* t) { addReady(t->threadReadyTaskID, t); });
 		FDB_TRACE_PROBE(run_loop_thread_ready, numReady);
 	}
 
@@ -149,7 +150,7 @@ private:
 	uint64_t tasksIssued;
 
 	ReadyQueue<OrderedTask> ready;
-	ThreadSafeQueue<std::pair<TaskPriority, Task*>> threadReady;
+	IntrusiveThreadSafeQueue<Task> threadReady;
 
 	std::priority_queue<DelayedTask, std::vector<DelayedTask>> timers;
 
@@ -1,5 +1,7 @@
 
 // ThreadSafeQueue<T> is a multi-producer, single-consumer queue.
+// IntrusiveThreadSafeQueue<T> is the same queue for elements which embed their own ThreadSafeQueueNode, so that
+// handing an element to the consumer does not allocate.
 
 // It is almost but not quite lock-free (the exception is that if a thread is
 // stopped in a very narrow window in push(), pop() will "block" in the sense
@@ -44,26 +46,22 @@ interpreted as representing official policies, either expressed or implied, of D
 #include <drd.h>
 #endif
 
-template <class T>
-class ThreadSafeQueue : NonCopyable {
-	struct BaseNode {
-		std::atomic<BaseNode*> next;
-		BaseNode() : next(nullptr) {}
-	};
+// The link embedded in every element of an IntrusiveThreadSafeQueue
+struct ThreadSafeQueueNode {
+	std::atomic<ThreadSafeQueueNode*> next;
+	ThreadSafeQueueNode() : next(nullptr) {}
+};
 
-	struct Node : BaseNode, FastAllocated<Node> {
-		T data;
-		Node(T const& data) : data(data) {}
-		Node(T&& data) : data(std::move(data)) {}
-	};
-	std::atomic<BaseNode*> head;
-	BaseNode* tail;
-	BaseNode stub, sleeping;
+// The queue algorithm shared by ThreadSafeQueue and IntrusiveThreadSafeQueue. It owns none of the nodes in it.
+class ThreadSafeNodeQueue : NonCopyable {
+	std::atomic<ThreadSafeQueueNode*> head;
+	ThreadSafeQueueNode* tail;
+	ThreadSafeQueueNode stub, sleeping;
 	bool sleepy;
 
-	BaseNode* popNode() {
-		BaseNode* tail = this->tail;
-		BaseNode* next = tail->next.load();
+	ThreadSafeQueueNode* popNode() {
+		ThreadSafeQueueNode* tail = this->tail;
+		ThreadSafeQueueNode* next = tail->next.load();
 #if VALGRIND
 		ANNOTATE_HAPPENS_BEFORE(&tail->next);
 #endif
@@ -82,7 +80,7 @@ class ThreadSafeQueue : NonCopyable {
 			this->tail = next;
 			return tail;
 		}
-		BaseNode* head = this->head.load();
+		ThreadSafeQueueNode* head = this->head.load();
 #if VALGRIND
 		ANNOTATE_HAPPENS_BEFORE(&this->head);
 #endif
@@ -106,11 +104,11 @@ class ThreadSafeQueue : NonCopyable {
 	}
 
 	// Pushes n at the end of the queue and returns the node immediately before it
-	BaseNode* pushNode(BaseNode* n) {
+	ThreadSafeQueueNode* pushNode(ThreadSafeQueueNode* n) {
 #if VALGRIND
 		ANNOTATE_HAPPENS_AFTER(&head);
 #endif
-		BaseNode* prev = head.exchange(n);
+		ThreadSafeQueueNode* prev = head.exchange(n);
 #if VALGRIND
 		ANNOTATE_HAPPENS_BEFORE(&head);
 		ANNOTATE_HAPPENS_AFTER(&prev->next);
@@ -120,7 +118,7 @@ class ThreadSafeQueue : NonCopyable {
 	}
 
 public:
-	ThreadSafeQueue() {
+	ThreadSafeNodeQueue() {
 #if VALGRIND
 		ANNOTATE_HAPPENS_AFTER(&this->head);
 #endif
@@ -128,15 +126,10 @@ public:
 		this->tail = &this->stub;
 		this->sleepy = false;
 	}
-	~ThreadSafeQueue() {
-		while (pop().present())
-			;
-	}
 
 	// If push() returns true, the consumer may be sleeping and should be woken
-	template <class U>
-	bool push(U&& data) {
-		Node* n = new Node(std::forward<U>(data));
+	bool push(ThreadSafeQueueNode* n) {
+		n->next.store(nullptr, std::memory_order_relaxed);
 		return pushNode(n) == &sleeping;
 	}
 
@@ -166,8 +159,9 @@ public:
 		return ok;
 	}
 
-	Optional<T> pop() {
-		BaseNode* b = popNode();
+	// Returns nullptr if the queue is empty
+	ThreadSafeQueueNode* pop() {
+		ThreadSafeQueueNode* b = popNode();
 		if (b == &sleeping) {
 			sleepy = false;
 			b = popNode();
@@ -176,12 +170,73 @@ public:
 			ASSERT(false);
 		if (b == &stub)
 			ASSERT(false);
-		if (!b)
+		return b;
+	}
+};
+
+template <class T>
+class ThreadSafeQueue : NonCopyable {
+	struct Node : ThreadSafeQueueNode, FastAllocated<Node> {
+		T data;
+		Node(T const& data) : data(data) {}
+		Node(T&& data) : data(std::move(data)) {}
+	};
+	ThreadSafeNodeQueue queue;
+
+public:
+	~ThreadSafeQueue() {
+		while (pop().present())
+			;
+	}
+
+	// If push() returns true, the consumer may be sleeping and should be woken
+	template <class U>
+	bool push(U&& data) {
+		return queue.push(new Node(std::forward<U>(data)));
+	}
+
+	///////////// The below functions may only be called by a single, consumer thread //////////////////
+
+	// If canSleep returns true, then the queue is empty and the next push() will return true
+	bool canSleep() { return queue.canSleep(); }
+
+	Optional<T> pop() {
+		Node* n = static_cast<Node*>(queue.pop());
+		if (!n)
 			return Optional<T>();
 
-		Node* n = (Node*)b;
 		T data = std::move(n->data);
 		delete n;
 		return Optional<T>(std::move(data));
 	}
 };
+
+// T must derive from ThreadSafeQueueNode. The queue does not own its elements: push() hands an element to the consumer
+// and pop() hands it back, and an element may only be in one queue at a time.
+template <class T>
+class IntrusiveThreadSafeQueue : NonCopyable {
+	ThreadSafeNodeQueue queue;
+
+public:
+	// If push() returns true, the consumer may be sleeping and should be woken
+	bool push(T* element) { return queue.push(element); }
+
+	///////////// The below functions may only be called by a single, consumer thread //////////////////
+
+	// If canSleep returns true, then the queue is empty and the next push() will return true
+	bool canSleep() { return queue.canSleep(); }
+
+	// Returns nullptr if the queue is empty
+	T* pop() { return static_cast<T*>(queue.pop()); }
+
+	// Pops elements and calls f on each, in order, until the queue is empty. Returns the number of elements popped.
+	template <class F>
+	int drain(F&& f) {
+		int n = 0;
+		while (T* element = pop()) {
+			f(element);
+			++n;
+		}
+		return n;
+	}
+};
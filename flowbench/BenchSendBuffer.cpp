@@ -0,0 +1,142 @@
+/*
+ * BenchSendBuffer.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "benchmark/benchmark.h"
+
+#include "flow/Knobs.h"
+#include "flow/SendBufferIterator.h"
+#include "flow/serialize.h"
+
+#include <boost/asio.hpp>
+#include <boost/range/iterator_range.hpp>
+
+#include <vector>
+
+// Measures the cost of sending a chain of small packets queued on a connection, the way
+// FlowTransport's connectionWriter does, over a local socket pair. bench_send_buffer_per_packet issues one system call
+// per packet, bench_send_buffer_vectored hands the whole PacketBuffer chain to a single vectored write per
+// MAX_PACKET_SEND_BYTES.
+
+namespace {
+
+struct SocketPair {
+	boost::asio::io_context ios;
+	boost::asio::local::stream_protocol::socket sender;
+	boost::asio::local::stream_protocol::socket receiver;
+	std::vector<uint8_t> drainBuffer;
+
+	SocketPair() : sender(ios), receiver(ios), drainBuffer(1 << 20) {
+		boost::asio::local::connect_pair(sender, receiver);
+		sender.non_blocking(true);
+		receiver.non_blocking(true);
+	}
+
+	void drain() {
+		boost::system::error_code err;
+		while (receiver.read_some(boost::asio::buffer(drainBuffer), err) > 0 && !err) {
+		}
+	}
+};
+
+// Writes packetCount packets of packetSize bytes into a new PacketBuffer chain and returns its first buffer
+PacketBuffer* makePackets(int packetCount, int packetSize) {
+	std::vector<uint8_t> payload(packetSize, 'x');
+	PacketBuffer* first = PacketBuffer::create();
+	PacketBuffer* last = first;
+	for (int i = 0; i < packetCount; ++i) {
+		PacketWriter wr(last, nullptr, Unversioned());
+		wr.serializeBytes(payload.data(), packetSize);
+		last = wr.finish();
+	}
+	return first;
+}
+
+// Marks bytes of the chain starting at first as sent, releasing fully sent buffers, and returns the new first buffer
+PacketBuffer* markSent(PacketBuffer* first, size_t bytes) {
+	while (first) {
+		size_t unsent = first->bytes_written - first->bytes_sent;
+		if (bytes < unsent) {
+			first->bytes_sent += bytes;
+			break;
+		}
+		bytes -= unsent;
+		PacketBuffer* next = first->nextPacketBuffer();
+		first->delref();
+		first = next;
+	}
+	return first;
+}
+
+void sendChain(SocketPair& sockets, PacketBuffer* chain, int limit) {
+	while (chain) {
+		boost::system::error_code err;
+		size_t sent = sockets.sender.write_some(
+		    boost::iterator_range<SendBufferIterator>(SendBufferIterator(chain, limit), SendBufferIterator()), err);
+		ASSERT(!err || err == boost::asio::error::would_block);
+		chain = markSent(chain, sent);
+		if (err) {
+			sockets.drain();
+		}
+	}
+	sockets.drain();
+}
+
+} // namespace
+
+static void bench_send_buffer_per_packet(benchmark::State& state) {
+	const int packetCount = state.range(0);
+	const int packetSize = state.range(1);
+	SocketPair sockets;
+	for (auto _ : state) {
+		state.PauseTiming();
+		PacketBuffer* chain = makePackets(packetCount, packetSize);
+		state.ResumeTiming();
+		sendChain(sockets, chain, packetSize);
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()) * packetCount);
+	state.SetBytesProcessed(static_cast<long>(state.iterations()) * packetCount * packetSize);
+}
+
+static void bench_send_buffer_vectored(benchmark::State& state) {
+	const int packetCount = state.range(0);
+	const int packetSize = state.range(1);
+	SocketPair sockets;
+	for (auto _ : state) {
+		state.PauseTiming();
+		PacketBuffer* chain = makePackets(packetCount, packetSize);
+		state.ResumeTiming();
+		sendChain(sockets, chain, FLOW_KNOBS->MAX_PACKET_SEND_BYTES);
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()) * packetCount);
+	state.SetBytesProcessed(static_cast<long>(state.iterations()) * packetCount * packetSize);
+}
+
+BENCHMARK(bench_send_buffer_per_packet)
+    ->Args({ 16, 64 })
+    ->Args({ 256, 64 })
+    ->Args({ 256, 1024 })
+    ->Args({ 1024, 256 })
+    ->ReportAggregatesOnly(true);
+BENCHMARK(bench_send_buffer_vectored)
+    ->Args({ 16, 64 })
+    ->Args({ 256, 64 })
+    ->Args({ 256, 1024 })
+    ->Args({ 1024, 256 })
+    ->ReportAggregatesOnly(true);
@@ -0,0 +1,113 @@
+/*
+ * BenchTuple.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "benchmark/benchmark.h"
+
+#include "fdbclient/Tuple.h"
+#include "flow/IRandom.h"
+
+#include <string>
+#include <vector>
+
+// Measures packing and unpacking of keys shaped like a secondary index entry, ("index name", value, primary key id).
+// The value is a string of state.range(0) bytes, and one in state.range(1) of them is a zero byte that has to be
+// escaped (0 for none).
+
+namespace {
+
+constexpr int keyCount = 1000;
+
+std::vector<std::string> makeValues(int length, int zeroEvery) {
+	std::vector<std::string> values;
+	for (int i = 0; i < keyCount; ++i) {
+		std::string value = deterministicRandom()->randomAlphaNumeric(length);
+		for (int j = 0; zeroEvery > 0 && j < length; j += zeroEvery) {
+			value[j] = '\x00';
+		}
+		values.push_back(value);
+	}
+	return values;
+}
+
+std::vector<Standalone<StringRef>> makeKeys(std::vector<std::string> const& values) {
+	std::vector<Standalone<StringRef>> keys;
+	for (int i = 0; i < (int)values.size(); ++i) {
+		keys.push_back(Tuple::makeTuple("byEmail"_sr, StringRef(values[i]), (int64_t)i * 7919).pack());
+	}
+	return keys;
+}
+
+} // namespace
+
+static void bench_tuple_pack(benchmark::State& state) {
+	const std::vector<std::string> values = makeValues(state.range(0), state.range(1));
+	int64_t bytes = 0;
+	for (auto _ : state) {
+		for (int i = 0; i < (int)values.size(); ++i) {
+			Standalone<StringRef> key = Tuple::makeTuple("byEmail"_sr, StringRef(values[i]), (int64_t)i * 7919).pack();
+			benchmark::DoNotOptimize(key);
+			bytes += key.size();
+		}
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()) * keyCount);
+	state.SetBytesProcessed(bytes);
+}
+
+static void bench_tuple_unpack(benchmark::State& state) {
+	const std::vector<Standalone<StringRef>> keys = makeKeys(makeValues(state.range(0), state.range(1)));
+	int64_t bytes = 0;
+	for (auto _ : state) {
+		for (const auto& key : keys) {
+			Tuple t = Tuple::unpack(key);
+			Standalone<StringRef> value = t.getString(1);
+			int64_t id = t.getInt(2);
+			benchmark::DoNotOptimize(value);
+			benchmark::DoNotOptimize(id);
+			bytes += key.size();
+		}
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()) * keyCount);
+	state.SetBytesProcessed(bytes);
+}
+
+static void bench_tuple_reader(benchmark::State& state) {
+	const std::vector<Standalone<StringRef>> keys = makeKeys(makeValues(state.range(0), state.range(1)));
+	int64_t bytes = 0;
+	for (auto _ : state) {
+		Arena arena;
+		for (const auto& key : keys) {
+			TupleReader reader(key);
+			reader.next();
+			reader.next();
+			StringRef value = reader.getString(arena);
+			reader.next();
+			int64_t id = reader.getInt();
+			benchmark::DoNotOptimize(value);
+			benchmark::DoNotOptimize(id);
+			bytes += key.size();
+		}
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()) * keyCount);
+	state.SetBytesProcessed(bytes);
+}
+
+BENCHMARK(bench_tuple_pack)->Args({ 16, 0 })->Args({ 64, 0 })->Args({ 64, 16 })->ReportAggregatesOnly(true);
+BENCHMARK(bench_tuple_unpack)->Args({ 16, 0 })->Args({ 64, 0 })->Args({ 64, 16 })->ReportAggregatesOnly(true);
+BENCHMARK(bench_tuple_reader)->Args({ 16, 0 })->Args({ 64, 0 })->Args({ 64, 16 })->ReportAggregatesOnly(true);